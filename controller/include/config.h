@@ -40,6 +40,9 @@
 /** @brief Timeout waiting for reply from phaser (milliseconds) */
 #define REC_TIMEOUT 1000
 
+/** @brief Wait for the phaser's link-level ACK of a command before resending it (milliseconds) */
+#define ACK_TIMEOUT 200
+
 // ============================================================================
 // GPIO EXPANDER (MCP23017) CONFIGURATION
 // ============================================================================
@@ -81,6 +84,53 @@
 /** @brief Debounce delay for PTT input (milliseconds) */
 #define DEBOUNCE_DELAY_MS 25
 
+// ============================================================================
+// BAND DATA INPUT
+// ============================================================================
+
+/**
+ * @brief Transceiver band data inputs (BCD, Yaesu style)
+ *
+ * BCD A (weight 1) to D (weight 8). Yaesu band data is 5 V logic, so
+ * feed it through a level shifter or a series resistor divider; the
+ * SAMD21 inputs are not 5 V tolerant. Set BAND_DATA_ENABLED to 0 if no
+ * transceiver is connected.
+ */
+#define BAND_DATA_ENABLED 1
+#define BAND_DATA_PIN_A A1
+#define BAND_DATA_PIN_B A2
+#define BAND_DATA_PIN_C A3
+#define BAND_DATA_PIN_D A4
+
+/** @brief Band data lines read low for a 1 (inverting level shifter) */
+#define BAND_DATA_ACTIVE_LOW 0
+
+/** @brief Time a new band code must hold before it is acted on (ms) */
+#define BAND_DEBOUNCE_MS 20
+
+/** @brief Profile select resent this often until the phaser reports it (ms) */
+#define BAND_RETRY_MS 3000
+
+/** @brief No relay map profile for this band code: keep the current one */
+#define BAND_PROFILE_NONE 0xFF
+
+/** @brief Band of each BCD code (Yaesu assignment), defined in config.cpp */
+extern const char BAND_NAMES[16][5];
+
+/**
+ * @brief Phaser relay map profile of each BCD code
+ *
+ * Must match the profiles in RELAY_POSITIONS of the phaser's config.h.
+ * With a single profile every band uses profile 0; a split for e.g. a
+ * 40 m and a 20 m phasing harness would map codes 1-4 to 0 and 5-10 to 1.
+ */
+static const uint8_t BAND_PROFILES[16] = {
+    BAND_PROFILE_NONE,                      // General coverage
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,           // 160m - 6m
+    BAND_PROFILE_NONE, BAND_PROFILE_NONE, BAND_PROFILE_NONE,
+    BAND_PROFILE_NONE, BAND_PROFILE_NONE
+};
+
 // ============================================================================
 // ANTENNA DIRECTIONS
 // ============================================================================
@@ -97,25 +147,86 @@ enum Direction {
     DIR_NW = 7    /**< Northwest (315°) */
 };
 
-/** @brief Direction names for display */
-static const char* DIRECTION_NAMES[] = {
-    "N", "NE", "E", "SE", "S", "SW", "W", "NW"
-};
+/**
+ * @brief Direction names for display, defined in config.cpp
+ *
+ * Tables of char arrays rather than of pointers, so the names sit in
+ * flash with no pointer table in SRAM, and one copy serves every file.
+ */
+extern const char DIRECTION_NAMES[NUM_DIRECTIONS][3];
 
 /** @brief Direction angles in degrees */
-static const int DIRECTION_ANGLES[] = {
-    0, 45, 90, 135, 180, 225, 270, 315
-};
+extern const uint16_t DIRECTION_ANGLES[NUM_DIRECTIONS];
 
 // ============================================================================
 // PROTOCOL CONFIGURATION
 // ============================================================================
 
-/** @brief Maximum length of command buffer */
-#define MAX_COMMAND_LEN 7
+/** @brief Maximum length of command buffer (longest: HTSSSSSSSS history query) */
+#define MAX_COMMAND_LEN 16
+
+/**
+ * @brief Radio frames in the packet pool (see packet_pool.h)
+ *
+ * A command and its reply are in flight together while the last position
+ * reply is held for the display. One spare for pipelined commands.
+ */
+#define PACKET_POOL_BLOCKS 4
+
+/** @brief Upper bound on frames fetched by one history download */
+#define HISTORY_MAX_CHUNKS 40
+
+/** @brief Silence after which a bulk chunk stream is considered finished (ms) */
+#define BULK_CHUNK_TIMEOUT_MS 1500
+
+/** @brief Selective retransmit rounds per bulk session */
+#define BULK_MAX_RETRIES 3
+
+/** @brief Upper bound on follow-up sessions in one bulk download */
+#define BULK_MAX_SESSIONS 8
+
+/** @brief Also echo each raw bulk chunk as a "BULK <hex>" serial line for host tools */
+#define BULK_ECHO_RAW 0
+
+/** @brief Resends of a command not ACKed within ACK_TIMEOUT */
+#define EXCHANGE_RETRIES 3
+
+/** @brief Time a sweep rests on each direction before reading power (ms) */
+#define SWEEP_DWELL_MS 500
+
+// ============================================================================
+// TIME SYNCHRONISATION
+// ============================================================================
+
+/** @brief Accept a sync sample only if its round trip is within this of the best seen (ms) */
+#define TIMESYNC_DELAY_TOLERANCE_MS 20
 
-/** @brief Maximum length of reply buffer */
-#define MAX_REPLY_LEN 256
+/** @brief Most negative round trip put down to millisecond quantisation; worse is rejected (ms) */
+#define TIMESYNC_NEGATIVE_DELAY_MS 2
+
+/** @brief Minimum spacing between drift (frequency) estimates (ms) */
+#define TIMESYNC_DRIFT_MIN_SPAN_MS 300000UL
+
+/** @brief Drift filter gain as a divisor (new = old + (measured - old) / gain) */
+#define TIMESYNC_DRIFT_GAIN 4
+
+/** @brief Offset error beyond which the phaser is assumed rebooted and sync restarts (ms) */
+#define TIMESYNC_STEP_MS 2000
+
+/** @brief Largest plausible crystal drift; estimates beyond this are discarded (ppb) */
+#define TIMESYNC_MAX_DRIFT_PPB 500000L
+
+// ============================================================================
+// RADIO SPI
+// ============================================================================
+
+/** @brief RFM95 FIFO bursts by DMA (0 = RadioHead's byte loop, for comparison) */
+#ifndef RF95_SPI_DMA
+    #define RF95_SPI_DMA 1
+#endif
+
+/** @brief RFM95 SPI clock: 8 MHz is the fastest SERCOM rate under its 10 MHz limit */
+#define RF95_SPI_FREQUENCY RHGenericSPI::Frequency8MHz
 
 // ============================================================================
 // DEBUG CONFIGURATION
@@ -124,6 +235,11 @@ static const int DIRECTION_ANGLES[] = {
 /** @brief Enable debug output to Serial */
 #define DEBUG 0
 
+/** @brief Time FastPin against digitalWrite/digitalRead on the LED at start-up (fast_gpio.h) */
+#ifndef FAST_GPIO_BENCH
+    #define FAST_GPIO_BENCH 0
+#endif
+
 #if DEBUG
     #define DEBUG_PRINT(x) Serial.print(x)
     #define DEBUG_PRINTLN(x) Serial.println(x)
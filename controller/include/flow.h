@@ -0,0 +1,107 @@
+/**
+ * @file flow.h
+ * @brief Stackless coroutines (protothreads) for multi-step transactions
+ *
+ * A flow is a function written as a straight sequence of steps - send a
+ * command, wait for the reply, check it, send the next - that returns to
+ * loop() whenever it has to wait and carries on from the same point on
+ * its next call. The only state kept between calls is a Flow record (the
+ * resume point, a result and a timestamp: 8 bytes) plus whatever the flow
+ * keeps in its own context struct.
+ *
+ * The macros build a switch on the resume line, so inside a flow body:
+ * - local variables do not survive a wait or yield; keep them in the
+ *   context struct
+ * - no switch statements of its own (use if/else)
+ * - only one wait or yield per source line
+ *
+ * @code
+ * FlowStatus flow_example(Flow& f) {
+ *     FLOW_BEGIN(f);
+ *     exchange_start(cmd);
+ *     FLOW_WAIT_UNTIL(f, exchange_poll() != EXCHANGE_PENDING);
+ *     FLOW_DELAY(f, 500);
+ *     FLOW_END(f);
+ * }
+ * @endcode
+ *
+ * Call the flow once per pass of loop() until it returns something other
+ * than FLOW_WAITING. FLOW_INIT() (or a Flow zeroed any other way) starts
+ * it from the top.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef FLOW_H
+#define FLOW_H
+
+#include <stdint.h>
+
+/** @brief What a flow function returned */
+enum FlowStatus : uint8_t {
+    FLOW_WAITING = 0,              /**< Suspended, call again */
+    FLOW_DONE,                     /**< Finished */
+    FLOW_FAILED                    /**< Gave up (FLOW_FAIL) */
+};
+
+/** @brief Resume point and scratch of one flow */
+struct Flow {
+    uint16_t line;                 /**< Source line to resume at (0 = start) */
+    uint8_t result;                /**< FlowStatus of the last FLOW_CALL */
+    uint32_t mark_ms;              /**< Start of the current FLOW_DELAY */
+};
+
+/** @brief Start a flow from the top on its next call */
+#define FLOW_INIT(f) ((f).line = 0)
+
+/** @brief First statement of a flow body */
+#define FLOW_BEGIN(f) switch ((f).line) { case 0:
+
+/** @brief Last statement of a flow body: finished */
+#define FLOW_END(f) } (f).line = 0; return FLOW_DONE
+
+/** @brief Suspend until a condition holds (evaluated on every call) */
+#define FLOW_WAIT_UNTIL(f, cond)                \
+    do {                                        \
+        (f).line = __LINE__;                    \
+        __attribute__((fallthrough));           \
+        case __LINE__:                          \
+        if (!(cond)) return FLOW_WAITING;       \
+    } while (0)
+
+/** @brief Give loop() one pass, then carry on */
+#define FLOW_YIELD(f)                           \
+    do {                                        \
+        (f).line = __LINE__;                    \
+        return FLOW_WAITING; case __LINE__:;    \
+    } while (0)
+
+/** @brief Suspend for a time without blocking loop() */
+#define FLOW_DELAY(f, ms)                                           \
+    do {                                                            \
+        (f).mark_ms = millis();                                     \
+        FLOW_WAIT_UNTIL(f, millis() - (f).mark_ms >= (uint32_t)(ms)); \
+    } while (0)
+
+/**
+ * @brief Run a child flow to completion; its FlowStatus is left in (f).result
+ *
+ * @param f This flow
+ * @param child The child's Flow record
+ * @param call Expression calling the child with that record
+ */
+#define FLOW_CALL(f, child, call)                                   \
+    do {                                                            \
+        FLOW_INIT(child);                                           \
+        FLOW_WAIT_UNTIL(f, ((f).result = (call)) != FLOW_WAITING);  \
+    } while (0)
+
+/** @brief Stop here and report failure */
+#define FLOW_FAIL(f)                            \
+    do {                                        \
+        (f).line = 0;                           \
+        return FLOW_FAILED;                     \
+    } while (0)
+
+#endif // FLOW_H
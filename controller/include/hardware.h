@@ -1,12 +1,29 @@
 /**
  * @file hardware.h
- * @brief Hardware interface declarations for LoRa antenna controller
+ * @brief Hardware abstraction layer for the LoRa antenna controller
  *
- * Declares functions for managing:
+ * Covers:
  * - LoRa radio communication
  * - OLED display output
  * - MCP23017 GPIO expander (buttons and LEDs)
- * - User input/output operations
+ * - Direct inputs (PTT, band data) and time
+ *
+ * Hardware<Backend> holds everything that is the same on every target
+ * (debouncing, button and LED numbering, the telemetry screen layout) and
+ * calls a small set of primitives on its Backend through the curiously
+ * recurring template pattern. There are no virtual functions: each call
+ * resolves at compile time and inlines down to the library call it wraps.
+ *
+ * The backend is chosen when compiling:
+ * - Samd21Hardware (hardware_samd21.h): the Feather M0 with the RadioHead,
+ *   Adafruit SH110X and MCP23X17 drivers, for any Arduino build
+ * - NativeHardware (hardware_native.h): a simulation for Linux host
+ *   builds, with a simulated clock, inputs, screen and radio, so logic
+ *   written against this layer can be exercised and timed on the host
+ *   (see tools/hal_bench.cpp)
+ *
+ * The application uses the free functions at the end of this file, or
+ * the global `board` directly.
  *
  * @author Rajiv Dewan, N2RD
  * @date 2026
@@ -16,161 +33,297 @@
 #define HARDWARE_H
 
 #include <stdint.h>
+#include <stdio.h>
+#include <type_traits>
 #include "config.h"
 #include "protocol.h"
 
+#ifndef LOW
+#define LOW 0
+#define HIGH 1
+#endif
+
 // ============================================================================
-// RADIO FUNCTIONS
+// COMMON LAYER
 // ============================================================================
 
 /**
- * @brief Initialize the LoRa radio module
+ * @brief Operations shared by every backend
  *
- * Sets up the RH_RF95 radio driver and configures:
- * - Frequency (915.0 MHz)
- * - Transmission power (20 dBm)
- * - Reliable datagram manager for automatic ACKs
+ * A Backend derives from Hardware<Backend> and provides:
  *
- * @return true if initialization successful, false otherwise
- */
-bool radio_init(void);
-
-/**
- * @brief Send a command to the phaser and wait for reply
+ * | Primitive | Purpose |
+ * |-----------|---------|
+ * | `bool radio_begin()` | Start the radio and reliable datagram manager |
+ * | `bool radio_set_frequency(float mhz)` | Tune |
+ * | `void radio_set_power(int8_t dbm)` | Transmit power |
+ * | `bool radio_available()` | A frame is waiting |
+ * | `bool radio_send(const uint8_t* data, uint8_t len, uint8_t to, uint8_t id)` | Start sending a frame with header id, without waiting |
+ * | `bool radio_receive(uint8_t* data, uint8_t& len, uint8_t& from)` | Receive and ACK a frame; false for ACKs and duplicates |
+ * | `bool radio_acked(uint8_t from, uint8_t id)` | An ACK of id came since the last send |
+ * | `bool radio_receive_raw(uint8_t* data, uint8_t& len, uint8_t& from)` | Receive without ACKing |
+ * | `bool radio_wait(uint16_t ms)` | Wait up to ms for a frame |
+ * | `int radio_rssi()` | RSSI of the last frame (dBm) |
+ * | `bool display_begin()` | Start the OLED |
+ * | `void display_clear()` | Blank the frame buffer |
+ * | `void display_text(int16_t x, int16_t y, uint8_t size, const char* text)` | Draw text |
+ * | `void display_flush()` | Show the frame buffer |
+ * | `bool expander_begin()` | Start the MCP23017, buttons in, LEDs out |
+ * | `bool expander_read(uint8_t pin)` | Expander pin level |
+ * | `void expander_write(uint8_t pin, bool level)` | Set an expander pin |
+ * | `void pin_input(uint8_t pin, bool pullup)` | MCU pin as input |
+ * | `int pin_read(uint8_t pin)` | MCU pin level |
+ * | `void pin_output(uint8_t pin)` | MCU pin as output |
+ * | `void pin_write(uint8_t pin, int level)` | Set an MCU pin |
+ * | `uint32_t now_ms()` | Milliseconds since start |
+ * | `void sleep_ms(uint32_t ms)` | Blocking wait |
  *
- * Transmits a command via LoRa and waits for acknowledgment and reply.
- * Timeout is REC_TIMEOUT milliseconds.
- *
- * @param cmd Command to send
- * @return true if reply received, false if timeout or transmission error
+ * @tparam Backend The derived class
  */
-bool radio_send_and_receive(const Command& cmd);
+template <class Backend>
+class Hardware {
+public:
+    // ------------------------------------------------------------------------
+    // Radio
+    // ------------------------------------------------------------------------
 
-/**
- * @brief Get the last received phaser reply data
- *
- * Returns pointer to buffer containing the most recent reply from phaser.
- * Buffer is valid until next radio_send_and_receive() call.
- *
- * @param len Output parameter: length of reply data
- * @return Pointer to reply buffer (uint8_t array)
- */
-uint8_t* radio_get_last_reply(uint8_t& len);
+    /**
+     * @brief Initialize the LoRa radio module
+     *
+     * @return true if the radio answered
+     */
+    bool radio_init(void) {
+        return impl().radio_begin();
+    }
 
-/**
- * @brief Get the RSSI of the last transmission
- *
- * @return RSSI in dBm (negative value)
- */
-int radio_get_last_rssi(void);
+    // ------------------------------------------------------------------------
+    // Display
+    // ------------------------------------------------------------------------
 
-// ============================================================================
-// DISPLAY FUNCTIONS (OLED)
-// ============================================================================
+    /**
+     * @brief Initialize the OLED display and show "READY!"
+     *
+     * @return true if the display answered
+     */
+    bool display_init(void) {
+        if (!impl().display_begin()) {
+            return false;
+        }
+        impl().display_clear();
+        impl().display_text(0, 0, 2, "READY!");
+        impl().display_flush();
+        return true;
+    }
 
-/**
- * @brief Initialize the OLED display
- *
- * Sets up the SH1106 1.3" OLED display via I2C.
- * Displays "READY!" message after initialization.
- *
- * @return true if initialization successful, false otherwise
- */
-bool display_init(void);
+    /**
+     * @brief Show a phaser position reply
+     *
+     * Shows reverse power, transmit/receive RSSI, bus voltage and current,
+     * MCU supply voltage and the antenna direction.
+     *
+     * @param buf Position reply
+     * @param len Reply length
+     * @param rev_power Last reverse power reading (6 characters)
+     * @param direction Direction name
+     */
+    void display_show_telemetry(const uint8_t* buf, uint8_t len, const char* rev_power,
+                                const char* direction) {
+        char line[24];
+        impl().display_clear();
 
-/**
- * @brief Display reverse power reading from antenna
- *
- * Shows on OLED:
- * - Reverse power (W)
- * - Transmit/Receive RSSI (dB)
- * - Bus voltage and current
- * - MCU supply voltage
- * - Current antenna position
- *
- * @param reply Reply data from phaser
- * @param rev_power Reverse power reading (string)
- */
-void display_show_telemetry(uint8_t* reply_buf, uint8_t reply_len);
+        snprintf(line, sizeof(line), "Rev %.6s", rev_power);
+        impl().display_text(0, 0, 2, line);
 
-/**
- * @brief Display a status message on the OLED
- *
- * @param message Message to display (max ~20 chars)
- */
-void display_message(const char* message);
+        // Transmit RSSI as heard here, receive RSSI as heard by the phaser
+        snprintf(line, sizeof(line), "RSSI T/R: %+04d/-%.3s", impl().radio_rssi(),
+                 (len >= 9) ? (const char*)buf + 6 : "");
+        impl().display_text(0, 20, 1, line);
 
-/**
- * @brief Clear the OLED display
- */
-void display_clear(void);
+        if (len >= 15) {
+            snprintf(line, sizeof(line), "Bus V: %.2s.%.3s", (const char*)buf + 10,
+                     (const char*)buf + 12);
+        } else {
+            snprintf(line, sizeof(line), "Bus V: ");
+        }
+        impl().display_text(0, 30, 1, line);
 
-// ============================================================================
-// GPIO EXPANDER FUNCTIONS (MCP23017)
-// ============================================================================
+        snprintf(line, sizeof(line), "Bus mA: %.3s", (len >= 19) ? (const char*)buf + 16 : "");
+        impl().display_text(0, 40, 1, line);
 
-/**
- * @brief Initialize the MCP23017 I2C GPIO expander
- *
- * Configures:
- * - Pins 0-7 as inputs with pull-ups (buttons)
- * - Pins 8-15 as outputs (LEDs)
- *
- * @return true if initialization successful, false otherwise
- */
-bool gpio_init(void);
+        if (len >= 24) {
+            snprintf(line, sizeof(line), "MCU V: %.1s.%.3s", (const char*)buf + 20,
+                     (const char*)buf + 21);
+        } else {
+            snprintf(line, sizeof(line), "MCU V: ");
+        }
+        impl().display_text(0, 50, 1, line);
 
-/**
- * @brief Get button press state
- *
- * @param button Button index (0-7, corresponding to N, NE, E, SE, S, SW, W, NW)
- * @return true if button is pressed (LOW), false otherwise
- */
-bool gpio_read_button(int button);
+        snprintf(line, sizeof(line), "Dir: %s", direction);
+        impl().display_text(0, 58, 1, line);
 
-/**
- * @brief Set LED state
- *
- * @param led LED index (0-7, corresponding to direction 0-7)
- * @param state true for ON (HIGH), false for OFF (LOW)
- */
-void gpio_set_led(int led, bool state);
+        impl().display_flush();
+    }
 
-/**
- * @brief Turn off all LEDs
- */
-void gpio_all_leds_off(void);
+    /**
+     * @brief Display a short status message for one second (blocking)
+     *
+     * @param message Message to display (max ~10 chars at this size)
+     */
+    void display_message(const char* message) {
+        impl().display_clear();
+        impl().display_text(0, 25, 2, message);
+        impl().display_flush();
+        impl().sleep_ms(1000);
+    }
 
-/**
- * @brief Blink an LED (blocking operation)
- *
- * @param led LED index (0-7)
- * @param delay_ms Delay between on/off (milliseconds)
- * @param count Number of blink cycles
- */
-void gpio_blink_led(int led, int delay_ms, int count);
+    // ------------------------------------------------------------------------
+    // Buttons and LEDs (MCP23017)
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Initialize the GPIO expander: buttons in with pull-ups, LEDs out
+     *
+     * @return true if the expander answered
+     */
+    bool gpio_init(void) {
+        return impl().expander_begin();
+    }
+
+    /**
+     * @brief Get button press state
+     *
+     * @param button Button index (0-7, corresponding to N, NE, E, SE, S, SW, W, NW)
+     * @return true if the button is pressed (LOW)
+     */
+    bool gpio_read_button(int button) {
+        return button >= 0 && button < NUM_DIRECTIONS &&
+               !impl().expander_read(BUTTON_PIN_START + button);
+    }
+
+    /**
+     * @brief Set LED state
+     *
+     * @param led LED index (0-7, corresponding to direction 0-7)
+     * @param state true for ON (HIGH), false for OFF (LOW)
+     */
+    void gpio_set_led(int led, bool state) {
+        if (led >= 0 && led < NUM_DIRECTIONS) {
+            impl().expander_write(LED_PIN_START + led, state);
+        }
+    }
+
+    /**
+     * @brief Light one direction LED and turn the others off
+     *
+     * @param led LED index (0-7)
+     */
+    void gpio_show_led(int led) {
+        for (int i = 0; i < NUM_DIRECTIONS; i++) {
+            impl().expander_write(LED_PIN_START + i, i == led);
+        }
+    }
+
+    /**
+     * @brief Turn off all LEDs
+     */
+    void gpio_all_leds_off(void) {
+        gpio_show_led(-1);
+    }
+
+    /**
+     * @brief Blink an LED (blocking operation)
+     *
+     * @param led LED index (0-7)
+     * @param delay_ms Delay between on/off (milliseconds)
+     * @param count Number of blink cycles
+     */
+    void gpio_blink_led(int led, int delay_ms, int count) {
+        for (int i = 0; i < count; i++) {
+            gpio_set_led(led, true);
+            impl().sleep_ms(delay_ms);
+            gpio_set_led(led, false);
+            impl().sleep_ms(delay_ms);
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Direct inputs
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Debounce a digital input pin
+     *
+     * Waits for the pin to stay at one level for DEBOUNCE_DELAY_MS.
+     * Returns at once if the pin changes during the wait.
+     *
+     * @param pin Pin number to debounce
+     * @param target_level Target level (HIGH or LOW)
+     * @return true if the pin stabilized at the target level
+     */
+    bool debounce_pin(int pin, int target_level) {
+        int level = impl().pin_read(pin);
+        for (int i = 0; i < DEBOUNCE_DELAY_MS; i++) {
+            impl().sleep_ms(1);
+            if (impl().pin_read(pin) != level) {
+                return false;  // Level changed, not stable
+            }
+        }
+        return level == target_level;
+    }
+
+    /**
+     * @brief Check if the PTT input is pressed and debounced
+     *
+     * @return true if PTT_PIN is LOW (pressed) for DEBOUNCE_DELAY_MS
+     */
+    bool ptt_pressed(void) {
+        return debounce_pin(PTT_PIN, LOW);
+    }
+
+private:
+    Backend& impl(void) {
+        return static_cast<Backend&>(*this);
+    }
+};
 
 // ============================================================================
-// INPUT/OUTPUT UTILITIES
+// BACKEND SELECTION
 // ============================================================================
 
-/**
- * @brief Debounce a digital input pin
- *
- * Waits for the pin to stabilize at the specified level
- * for DEBOUNCE_DELAY_MS milliseconds.
- *
- * @param pin Pin number to debounce
- * @param target_level Target level (HIGH=1 or LOW=0)
- * @return true if pin stabilized at target level
- */
-bool debounce_pin(int pin, int target_level);
+#if defined(ARDUINO)
+#include "hardware_samd21.h"
+typedef Samd21Hardware Board;
+#else
+#include "hardware_native.h"
+typedef NativeHardware Board;
+#endif
 
-/**
- * @brief Check if PTT button is pressed and debounced
- *
- * @return true if PTT pin is LOW (pressed) for DEBOUNCE_DELAY_MS
- */
-bool ptt_pressed(void);
+static_assert(!std::is_polymorphic<Board>::value,
+              "Hardware backends must not use virtual functions");
+
+/** @brief The board, defined by the application */
+extern Board board;
+
+// ============================================================================
+// APPLICATION INTERFACE
+// ============================================================================
+
+inline bool radio_init(void) { return board.radio_init(); }
+inline int radio_get_last_rssi(void) { return board.radio_rssi(); }
+inline bool display_init(void) { return board.display_init(); }
+inline void display_message(const char* message) { board.display_message(message); }
+inline void display_clear(void) { board.display_clear(); board.display_flush(); }
+inline bool gpio_init(void) { return board.gpio_init(); }
+inline bool gpio_read_button(int button) { return board.gpio_read_button(button); }
+inline void gpio_set_led(int led, bool state) { board.gpio_set_led(led, state); }
+inline void gpio_show_led(int led) { board.gpio_show_led(led); }
+inline void gpio_all_leds_off(void) { board.gpio_all_leds_off(); }
+inline void gpio_blink_led(int led, int delay_ms, int count) {
+    board.gpio_blink_led(led, delay_ms, count);
+}
+inline bool debounce_pin(int pin, int target_level) {
+    return board.debounce_pin(pin, target_level);
+}
+inline bool ptt_pressed(void) { return board.ptt_pressed(); }
 
 #endif // HARDWARE_H
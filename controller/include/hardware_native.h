@@ -0,0 +1,264 @@
+/**
+ * @file hardware_native.h
+ * @brief Linux host simulation backend of the hardware layer (see hardware.h)
+ *
+ * Nothing here touches real hardware:
+ * - time is a simulated millisecond counter that only sleep_ms() and
+ *   sim_advance() move, so debouncing and timeouts run instantly
+ * - MCU pins, buttons and LEDs are bit arrays the test sets and checks
+ * - the OLED is a grid of characters (6 x 8 pixel cells)
+ * - the radio keeps the frames sent and a queue of frames to receive; a
+ *   responder callback can play the phaser and queue replies, and every
+ *   frame sent counts as ACKed unless sim_lose_acks is set
+ *
+ * An on_tick callback runs on every simulated millisecond, e.g. to make a
+ * pin bounce.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef HARDWARE_NATIVE_H
+#define HARDWARE_NATIVE_H
+
+#include <stdint.h>
+#include <string.h>
+#include "packet_pool.h"
+
+/** @brief Frames the simulated radio can hold for receiving */
+#define SIM_RX_FRAMES 4
+
+/** @brief Simulated screen size in character cells */
+#define SIM_SCREEN_COLS (SCREEN_WIDTH / 6)
+#define SIM_SCREEN_ROWS (SCREEN_HEIGHT / 8)
+
+/**
+ * @brief Simulated controller board
+ */
+class NativeHardware : public Hardware<NativeHardware> {
+public:
+    /** @brief Called after each frame sent, with the frame */
+    typedef void (*Responder)(NativeHardware& hw, const uint8_t* data, uint8_t len);
+
+    /** @brief Called on every simulated millisecond */
+    typedef void (*Tick)(NativeHardware& hw);
+
+    NativeHardware() {
+        sim_reset();
+    }
+
+    // Radio
+
+    bool radio_begin(void) { return true; }
+    bool radio_set_frequency(float) { return true; }
+    void radio_set_power(int8_t) {}
+
+    bool radio_available(void) {
+        return rx_count > 0;
+    }
+
+    bool radio_send(const uint8_t* data, uint8_t len, uint8_t to, uint8_t id) {
+        memcpy(tx_data, data, len);
+        tx_len = len;
+        tx_to = to;
+        tx_id = id;
+        tx_frames++;
+        if (responder) {
+            responder(*this, data, len);
+        }
+        return true;
+    }
+
+    bool radio_receive(uint8_t* data, uint8_t& len, uint8_t& from) {
+        return radio_receive_raw(data, len, from);  // ACKs are not simulated
+    }
+
+    bool radio_acked(uint8_t from, uint8_t id) {
+        return tx_frames > 0 && !sim_lose_acks && tx_to == from && tx_id == id;
+    }
+
+    bool radio_receive_raw(uint8_t* data, uint8_t& len, uint8_t& from) {
+        if (rx_count == 0) {
+            return false;
+        }
+        const SimFrame& f = rx[rx_head];
+        rx_head = (rx_head + 1) % SIM_RX_FRAMES;
+        rx_count--;
+        len = (f.len < len) ? f.len : len;
+        memcpy(data, f.data, len);
+        from = f.from;
+        return true;
+    }
+
+    bool radio_wait(uint16_t ms) {
+        for (uint16_t i = 0; i < ms && rx_count == 0; i++) {
+            sim_advance(1);
+        }
+        return rx_count > 0;
+    }
+
+    int radio_rssi(void) { return rssi; }
+
+    // Display
+
+    bool display_begin(void) { return true; }
+
+    void display_clear(void) {
+        memset(screen, ' ', sizeof(screen));
+    }
+
+    void display_text(int16_t x, int16_t y, uint8_t size, const char* text) {
+        int row = y / 8;
+        int col = x / 6;
+        for (; *text && row < SIM_SCREEN_ROWS; text++) {
+            if (*text == '\n' || col >= SIM_SCREEN_COLS) {
+                row += size;
+                col = 0;
+                if (*text == '\n') {
+                    continue;
+                }
+            }
+            if (row >= 0 && row < SIM_SCREEN_ROWS) {
+                screen[row][col] = *text;
+            }
+            col += size;
+        }
+    }
+
+    void display_flush(void) {
+        flushes++;
+    }
+
+    // GPIO expander: buttons read HIGH until pressed
+
+    bool expander_begin(void) { return true; }
+
+    bool expander_read(uint8_t pin) {
+        return (expander >> pin) & 1;
+    }
+
+    void expander_write(uint8_t pin, bool level) {
+        expander = level ? (expander | (1U << pin)) : (expander & ~(1U << pin));
+    }
+
+    // MCU pins and time
+
+    void pin_input(uint8_t pin, bool pullup) {
+        sim_set_pin(pin, pullup ? HIGH : LOW);
+    }
+
+    int pin_read(uint8_t pin) {
+        return (pins >> pin) & 1;
+    }
+
+    void pin_output(uint8_t) {}
+
+    void pin_write(uint8_t pin, int level) {
+        sim_set_pin(pin, level);
+    }
+
+    uint32_t now_ms(void) { return clock_ms; }
+
+    void sleep_ms(uint32_t ms) {
+        sim_advance(ms);
+    }
+
+    // ------------------------------------------------------------------------
+    // Simulation controls
+    // ------------------------------------------------------------------------
+
+    /** @brief Power-on state: inputs high, LEDs off, nothing queued */
+    void sim_reset(void) {
+        clock_ms = 0;
+        pins = 0xFFFFFFFFUL;
+        expander = (1U << NUM_DIRECTIONS) - 1;  // Buttons released, LEDs off
+        rx_head = rx_count = 0;
+        tx_len = tx_to = tx_id = 0;
+        tx_frames = 0;
+        sim_lose_acks = false;
+        flushes = 0;
+        rssi = -60;
+        responder = NULL;
+        on_tick = NULL;
+        display_clear();
+    }
+
+    /** @brief Move simulated time on, running on_tick every millisecond */
+    void sim_advance(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            clock_ms++;
+            if (on_tick) {
+                on_tick(*this);
+            }
+        }
+    }
+
+    /** @brief Drive an MCU pin */
+    void sim_set_pin(uint8_t pin, int level) {
+        pins = level ? (pins | (1UL << pin)) : (pins & ~(1UL << pin));
+    }
+
+    /** @brief Press (pull LOW) or release a direction button */
+    void sim_button(int button, bool pressed) {
+        expander_write(BUTTON_PIN_START + button, !pressed);
+    }
+
+    /** @brief Whether a direction LED is lit */
+    bool sim_led(int led) const {
+        return (expander >> (LED_PIN_START + led)) & 1;
+    }
+
+    /**
+     * @brief Queue a frame for the application to receive
+     *
+     * @return false if SIM_RX_FRAMES are already queued
+     */
+    bool sim_deliver(const uint8_t* data, uint8_t len, uint8_t from) {
+        if (rx_count >= SIM_RX_FRAMES || len > PACKET_MTU) {
+            return false;
+        }
+        SimFrame& f = rx[(rx_head + rx_count) % SIM_RX_FRAMES];
+        memcpy(f.data, data, len);
+        f.len = len;
+        f.from = from;
+        rx_count++;
+        return true;
+    }
+
+    /** @brief One screen row as text (SIM_SCREEN_COLS characters) */
+    const char* sim_screen_row(int row) {
+        memcpy(row_text, screen[row], SIM_SCREEN_COLS);
+        row_text[SIM_SCREEN_COLS] = '\0';
+        return row_text;
+    }
+
+    Responder responder;           /**< Plays the phaser, may be NULL */
+    Tick on_tick;                  /**< Input stimulus, may be NULL */
+    int rssi;                      /**< Reported by radio_rssi() */
+
+    uint8_t tx_data[PACKET_MTU];   /**< Last frame sent */
+    uint8_t tx_len;
+    uint8_t tx_to;
+    uint8_t tx_id;
+    uint32_t tx_frames;            /**< Frames sent */
+    bool sim_lose_acks;            /**< radio_acked() never true, as if every ACK were lost */
+    uint32_t flushes;              /**< Screen updates */
+
+private:
+    struct SimFrame {
+        uint8_t data[PACKET_MTU];
+        uint8_t len;
+        uint8_t from;
+    };
+
+    uint32_t clock_ms;
+    uint32_t pins;
+    uint16_t expander;
+    SimFrame rx[SIM_RX_FRAMES];
+    uint8_t rx_head;
+    uint8_t rx_count;
+    char screen[SIM_SCREEN_ROWS][SIM_SCREEN_COLS];
+    char row_text[SIM_SCREEN_COLS + 1];
+};
+
+#endif // HARDWARE_NATIVE_H
@@ -0,0 +1,180 @@
+/**
+ * @file hardware_samd21.h
+ * @brief Feather M0 backend of the hardware layer (see hardware.h)
+ *
+ * Owns the RadioHead (with DMA FIFO transfers, rf95_dma.h), SH1106 and
+ * MCP23017 driver objects. Every primitive
+ * is an inline forward to the driver call it replaces. MCU pin reads and
+ * writes go straight to the port registers (fast_gpio.h); the pins are
+ * constants at every call, so the lookup folds away.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef HARDWARE_SAMD21_H
+#define HARDWARE_SAMD21_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <RHReliableDatagram.h>
+#include <Adafruit_MCP23X17.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include "fast_gpio.h"
+#include "rf95_dma.h"
+
+/**
+ * @brief Adafruit Feather M0 with RFM95, SH1106 OLED and MCP23017
+ */
+class Samd21Hardware : public Hardware<Samd21Hardware> {
+public:
+    Samd21Hardware()
+        : rf95(RF95_CS, RF95_INT),
+          manager(rf95, MY_ADDRESS),
+          oled(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1),
+          ack_seen(false), ack_from(0), ack_id(0) {}
+
+    // Radio
+
+    bool radio_begin(void) {
+        if (!manager.init()) {
+            return false;
+        }
+        manager.setTimeout(REC_TIMEOUT);
+        return true;
+    }
+
+    bool radio_set_frequency(float mhz) {
+        return rf95.setFrequency(mhz);
+    }
+
+    void radio_set_power(int8_t dbm) {
+        rf95.setTxPower(dbm, false);
+    }
+
+    bool radio_available(void) {
+        return manager.available();
+    }
+
+    bool radio_send(const uint8_t* data, uint8_t len, uint8_t to, uint8_t id) {
+        manager.setHeaderId(id);
+        manager.setHeaderFlags(RH_FLAGS_NONE, RH_FLAGS_ACK);
+        ack_seen = false;
+        return manager.sendto((uint8_t*)data, len, to);
+    }
+
+    bool radio_receive(uint8_t* data, uint8_t& len, uint8_t& from) {
+        // recvfromAck() swallows ACKs; note one for us from the headers first
+        if (manager.available() && (manager.headerFlags() & RH_FLAGS_ACK) &&
+            manager.headerTo() == MY_ADDRESS) {
+            ack_from = manager.headerFrom();
+            ack_id = manager.headerId();
+            ack_seen = true;
+        }
+        return manager.recvfromAck(data, &len, &from);
+    }
+
+    bool radio_acked(uint8_t from, uint8_t id) {
+        return ack_seen && ack_from == from && ack_id == id;
+    }
+
+    bool radio_receive_raw(uint8_t* data, uint8_t& len, uint8_t& from) {
+        return manager.recvfrom(data, &len, &from);
+    }
+
+    bool radio_wait(uint16_t ms) {
+        return manager.waitAvailableTimeout(ms);
+    }
+
+    int radio_rssi(void) {
+        return rf95.lastRssi();
+    }
+
+    /** @brief The radio driver, for its FIFO timings (not a backend primitive) */
+    const Rf95Dma& radio(void) const {
+        return rf95;
+    }
+
+    // Display
+
+    bool display_begin(void) {
+        if (!oled.begin(OLED_I2C_ADDRESS, true)) {
+            return false;
+        }
+        oled.setTextColor(SH110X_WHITE);
+        return true;
+    }
+
+    void display_clear(void) {
+        oled.clearDisplay();
+    }
+
+    void display_text(int16_t x, int16_t y, uint8_t size, const char* text) {
+        oled.setTextSize(size);
+        oled.setCursor(x, y);
+        oled.print(text);
+    }
+
+    void display_flush(void) {
+        oled.display();
+    }
+
+    // GPIO expander
+
+    bool expander_begin(void) {
+        if (!mcp.begin_I2C(MCP_I2C_ADDRESS)) {
+            return false;
+        }
+        for (int i = 0; i < NUM_DIRECTIONS; i++) {
+            mcp.pinMode(BUTTON_PIN_START + i, INPUT_PULLUP);
+            mcp.pinMode(LED_PIN_START + i, OUTPUT);
+        }
+        return true;
+    }
+
+    bool expander_read(uint8_t pin) {
+        return mcp.digitalRead(pin);
+    }
+
+    void expander_write(uint8_t pin, bool level) {
+        mcp.digitalWrite(pin, level ? HIGH : LOW);
+    }
+
+    // MCU pins and time
+
+    void pin_input(uint8_t pin, bool pullup) {
+        pinMode(pin, pullup ? INPUT_PULLUP : INPUT_PULLDOWN);
+    }
+
+    int pin_read(uint8_t pin) {
+        return FastPin(pin).read();
+    }
+
+    void pin_output(uint8_t pin) {
+        pinMode(pin, OUTPUT);
+    }
+
+    void pin_write(uint8_t pin, int level) {
+        FastPin(pin).write(level);
+    }
+
+    uint32_t now_ms(void) {
+        return millis();
+    }
+
+    void sleep_ms(uint32_t ms) {
+        delay(ms);
+    }
+
+private:
+    Rf95Dma rf95;
+    RHReliableDatagram manager;
+    Adafruit_SH1106G oled;
+    Adafruit_MCP23X17 mcp;
+    bool ack_seen;                 /**< An ACK arrived since the last radio_send() */
+    uint8_t ack_from;              /**< Its sender */
+    uint8_t ack_id;                /**< Its header id */
+};
+
+#endif // HARDWARE_SAMD21_H
@@ -20,6 +20,7 @@
 #define PROTOCOL_H
 
 #include <stdint.h>
+#include "config.h"
 
 // ============================================================================
 // COMMAND DEFINITIONS
@@ -33,6 +34,88 @@
 /** @brief PTT (voltage/power report) command */
 #define CMD_PTT 'V'
 
+/** @brief Telemetry history query: HTSSSSSSSS (T = tier, S = since, hex ms) */
+#define CMD_HISTORY 'H'
+
+/** @brief Length of the history query command */
+#define CMD_HISTORY_LEN 10
+
+/** @brief Compressed bulk history download: BTSSSSSSSS (same fields as H) */
+#define CMD_BULK 'B'
+
+/** @brief Length of the bulk download command */
+#define CMD_BULK_LEN 10
+
+/** @brief Bulk chunk retransmit request: RSSMMMM (S = session, M = chunk mask, hex) */
+#define CMD_RESEND 'R'
+
+/** @brief Length of the bulk retransmit command */
+#define CMD_RESEND_LEN 7
+
+/**
+ * @brief Reverse power calibration: "C" + sub-command
+ *
+ * CB begin, CPNNNNN record point (N = reference power, 0.1 W decimal),
+ * CE save, CA abort, CQ query, CD restore default; all act on the
+ * phaser's current direction.
+ */
+#define CMD_CAL 'C'
+
+/** @brief Length of the calibration commands other than CP */
+#define CMD_CAL_LEN 2
+
+/** @brief Length of the calibration point command */
+#define CMD_CAL_POINT_LEN 7
+
+/** @brief Calibration point sub-command */
+#define CAL_SUB_POINT 'P'
+
+/** @brief Relearn the phaser's relay coil currents */
+#define CMD_RELEARN 'L'
+
+/** @brief Sensor statistics query: "S" + scope */
+#define CMD_STATS 'S'
+
+/** @brief Length of the statistics command */
+#define CMD_STATS_LEN 2
+
+/** @brief Statistics scopes other than a direction digit */
+#define STATS_SUB_ALL 'A'        // All samples since reset
+#define STATS_SUB_RESET 'R'      // Clear, then report all
+
+/** @brief Relay operation counters: "OQ" = report, "OZnn" = restart relay nn */
+#define CMD_WEAR 'O'
+
+/** @brief Operation counter sub-commands */
+#define WEAR_SUB_QUERY 'Q'
+#define WEAR_SUB_CLEAR 'Z'
+
+/** @brief Length of the counter query */
+#define CMD_WEAR_LEN 2
+
+/** @brief Length of the counter clear command */
+#define CMD_WEAR_CLEAR_LEN 4
+
+/** @brief Scheduled direction changes: "TAXXXXXXXXD" = add, "TC" = clear, "TQ" = query */
+#define CMD_SCHEDULE 'T'
+
+/** @brief Schedule sub-commands */
+#define SCHED_SUB_ADD 'A'        // Switch to D at phaser millis() XXXXXXXX (hex)
+#define SCHED_SUB_CLEAR 'C'
+#define SCHED_SUB_QUERY 'Q'
+
+/** @brief Length of the clear and query commands */
+#define CMD_SCHED_LEN 2
+
+/** @brief Length of the add command */
+#define CMD_SCHED_ADD_LEN 11
+
+/** @brief Relay map profile select: "P" + profile (hex digit), replies with the position */
+#define CMD_PROFILE 'P'
+
+/** @brief Length of the profile command */
+#define CMD_PROFILE_LEN 2
+
 /** @brief Command terminator: carriage return */
 #define CMD_TERMINATOR '\r'
 
@@ -46,9 +129,153 @@
 /** @brief Position reply prefix indicating antenna position data */
 #define REPLY_POSITION ';'
 
+/** @brief Position reply field: last relay switch check "kXSSSSS" */
+#define REPLY_FIELD_RELAY 'k'
+
+/** @brief Offset of the relay check field in a position reply */
+#define REPLY_RELAY_FIELD_OFFSET 24
+
+/** @brief Length of the relay check field */
+#define REPLY_RELAY_FIELD_LEN 7
+
+/** @brief Relay check results */
+#define RELAY_CHECK_OK 'V'       // Coil current step matched
+#define RELAY_CHECK_FAILED 'F'   // Step outside tolerance: relay stuck or open
+#define RELAY_CHECK_LEARNED 'L'  // Pattern current learned on this switch
+
+/** @brief Position reply field: hot-switch interlock "wXWWWWW" */
+#define REPLY_FIELD_INTERLOCK 'w'
+
+/** @brief Offset of the interlock field in a position reply */
+#define REPLY_INTERLOCK_FIELD_OFFSET 31
+
+/** @brief Length of the interlock field */
+#define REPLY_INTERLOCK_FIELD_LEN 7
+
+/** @brief Interlock states */
+#define INTERLOCK_HELD 'H'       // RF present, switch waiting for it to drop
+#define INTERLOCK_APPLIED 'A'    // Switched after RF dropped
+#define INTERLOCK_EXPIRED 'T'    // RF never dropped, switch abandoned
+
+/** @brief Position reply field: relay map profile in use "gP" (hex digit) */
+#define REPLY_FIELD_PROFILE 'g'
+
+/** @brief Offset of the profile field in a position reply */
+#define REPLY_PROFILE_FIELD_OFFSET 38
+
+/** @brief Length of the profile field */
+#define REPLY_PROFILE_FIELD_LEN 2
+
 /** @brief Power/telemetry reply prefix indicating reverse power data */
 #define REPLY_POWER 'V'
 
+/** @brief Power reply field: peak-hold (PEP) reverse power, 6 chars in W */
+#define REPLY_FIELD_PEAK 'p'
+
+/** @brief Power reply field: decaying envelope reverse power, 6 chars in W */
+#define REPLY_FIELD_ENV 'e'
+
+/** @brief Length of each power reply field: marker + 6 chars */
+#define REPLY_POWER_FIELD_LEN 7
+
+/** @brief Power reply field: average forward power, 6 chars in W */
+#define REPLY_FIELD_FWD 'f'
+
+/** @brief Power reply field: SWR x 100, 4 digits (0000 = no carrier) */
+#define REPLY_FIELD_SWR 's'
+
+/** @brief Power reply field: return loss in 0.1 dB, 3 digits */
+#define REPLY_FIELD_RL 'l'
+
+/** @brief Power reply field: highest SWR x 100 over the phaser's SWR window */
+#define REPLY_FIELD_SWR_MAX 'x'
+
+/** @brief Length of the SWR fields: "sSSSSlLLLxXXXX" */
+#define REPLY_SWR_FIELDS_LEN 14
+
+/** @brief History reply prefix: "HTN" + N records (see phaser protocol.h) */
+#define REPLY_HISTORY 'H'
+
+/** @brief Characters per record in a history reply */
+#define HISTORY_RECORD_TEXT_LEN 57
+
+/** @brief Bulk session reply: "BTSSCCLLLLLLLLM" (see phaser protocol.h) */
+#define REPLY_BULK 'B'
+
+/** @brief Length of the bulk session reply */
+#define REPLY_BULK_LEN 15
+
+/** @brief Bulk retransmit reply: "RSSMMMM" */
+#define REPLY_RESEND 'R'
+
+/** @brief Calibration reply: "CXSDFN" + N x "AAAAPPPP" (see phaser protocol.h) */
+#define REPLY_CAL 'C'
+
+/** @brief Length of the calibration reply header */
+#define REPLY_CAL_HEADER_LEN 6
+
+/** @brief Statistics reply: "SXNNNNNNNN" + 4 x "mmmmMMMMaaaaVVVVVVVV" (see phaser protocol.h) */
+#define REPLY_STATS 'S'
+
+/** @brief Length of the statistics reply header */
+#define REPLY_STATS_HEADER_LEN 10
+
+/** @brief Characters per channel in a statistics reply */
+#define STATS_CHANNEL_TEXT_LEN 20
+
+/** @brief Relay operation counters: "ONNCCCCCCCC" + NN x "OOOOOOOO" (see phaser protocol.h) */
+#define REPLY_WEAR 'O'
+
+/** @brief Length of the counter reply header */
+#define REPLY_WEAR_HEADER_LEN 11
+
+/** @brief Characters per relay in a counter reply */
+#define WEAR_RELAY_TEXT_LEN 8
+
+/** @brief Schedule reply: "TXSNN" (see phaser protocol.h) */
+#define REPLY_SCHEDULE 'T'
+
+/** @brief Length of the schedule reply */
+#define REPLY_SCHED_LEN 5
+
+/** @brief Unsolicited scheduled change confirmations: "XN" + N x "DTTTTTTTTLLLLR" */
+#define REPLY_SCHED_REPORT 'X'
+
+/** @brief Characters per confirmation */
+#define SCHED_REPORT_TEXT_LEN 14
+
+/** @brief Unsolicited protection event: "EXDvVVVVViIIII" (see phaser protocol.h) */
+#define REPLY_EVENT 'E'
+
+/** @brief Length of a protection event */
+#define REPLY_EVENT_LEN 14
+
+/** @brief Protection event codes */
+#define EVENT_OVERCURRENT 'C'    // Relays released on relay overcurrent
+#define EVENT_WARNING 'W'        // Relay current above the warning limit
+#define EVENT_UNDERVOLTAGE 'U'   // Relays released on bus undervoltage
+#define EVENT_CLEARED 'K'        // Trip cleared
+
+/** @brief Number of history tiers on the phaser (1 s, 1 min, 15 min) */
+#define HISTORY_NUM_TIERS 3
+
+/** @brief History query cursor meaning "from the oldest record held" */
+#define HISTORY_SINCE_OLDEST 0xFFFFFFFFUL
+
+/** @brief History channels per record: bus mV, bus mA, MCU mV, reverse 0.1 W */
+#define HISTORY_NUM_CHANNELS 4
+
+/** @brief Time-sync trailer marker appended to every phaser reply */
+#define REPLY_FIELD_TIME 't'
+
+/**
+ * @brief Length of the time-sync trailer: "tRRRRRRRRXXXXXXXX"
+ *
+ * RRRRRRRR = phaser millis() at command receive (NTP T2, hex)
+ * XXXXXXXX = phaser millis() at reply transmit (NTP T3, hex)
+ */
+#define REPLY_TIME_FIELD_LEN 17
+
 // ============================================================================
 // DIRECTIONAL COMMAND CODES
 // ============================================================================
@@ -76,7 +303,7 @@
 
 /** @brief Command buffer for transmitting to phaser */
 struct Command {
-    uint8_t data[7];       /**< Command bytes */
+    uint8_t data[MAX_COMMAND_LEN];  /**< Command bytes */
     uint8_t length;        /**< Valid command length */
 };
 
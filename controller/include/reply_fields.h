@@ -0,0 +1,46 @@
+/**
+ * @file reply_fields.h
+ * @brief Fixed-width hex fields of phaser replies
+ *
+ * The one hex parser for reply text, used by the reply handlers and the
+ * time-sync trailer. It fails on any character that is not a hex digit,
+ * so a field garbled on the air is rejected rather than read as zero.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef REPLY_FIELDS_H
+#define REPLY_FIELDS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Parse a fixed number of upper- or lowercase hex digits
+ *
+ * @param s First digit (need not be null terminated)
+ * @param digits Number of digits (max 8)
+ * @param out Parsed value, unchanged on failure
+ * @return false on any non-hex character
+ */
+static inline bool parse_hex(const uint8_t* s, uint8_t digits, uint32_t& out) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < digits; i++) {
+        uint8_t c = s[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else {
+            return false;
+        }
+        value = (value << 4) | nibble;
+    }
+    out = value;
+    return true;
+}
+
+#endif // REPLY_FIELDS_H
@@ -0,0 +1,101 @@
+/**
+ * @file rf95_dma.h
+ * @brief RFM95 driver with DMA FIFO bursts and FIFO timing
+ *
+ * Shared by the phaser and the controller; keep the copies in phaser/ and
+ * controller/ (and of rf95_dma.cpp) identical.
+ *
+ * RadioHead moves a frame between the SAMD21 and the RFM95 FIFO one
+ * SPI.transfer() call per byte, at 1 MHz by default. Rf95Dma is an RH_RF95
+ * that replaces the two FIFO bursts:
+ *
+ * - the load before TX (send()) and the unload after RxDone (in the DIO0
+ *   interrupt) run as SERCOM4 DMA transfers, one channel feeding the
+ *   transmitter and one draining the receiver, back to back
+ * - the bus runs at RF95_SPI_FREQUENCY (8 MHz: the fastest SERCOM rate
+ *   at 48 MHz that stays under the RFM95's 10 MHz limit)
+ *
+ * Single register accesses keep the RadioHead path. Every burst still
+ * happens inside RadioHead's transaction and atomic block, and waits for
+ * its DMA transfer, so nothing else can use the bus meanwhile.
+ *
+ * Timing is kept for both paths (RF95_SPI_DMA 0 builds the byte-by-byte
+ * one at the same clock settings, for comparison):
+ * - receive latency: from the interrupt handler's first register read to
+ *   the payload being in RadioHead's buffer
+ * - load time: the FIFO write before each transmission
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef RF95_DMA_H
+#define RF95_DMA_H
+
+#include <Arduino.h>
+#include <RH_RF95.h>
+#include "fast_gpio.h"
+
+/** @brief Minimum, maximum and total of a set of timings */
+struct Rf95Timing {
+    uint32_t count;                /**< Samples */
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t total_us;
+};
+
+/**
+ * @brief RH_RF95 with DMA FIFO transfers
+ */
+class Rf95Dma : public RH_RF95 {
+public:
+    /**
+     * @param cs Chip select pin
+     * @param irq DIO0 interrupt pin
+     */
+    Rf95Dma(uint8_t cs, uint8_t irq);
+
+    /**
+     * @brief Set the SPI clock and DMA channels, then start the radio
+     *
+     * Called by the datagram manager's init().
+     *
+     * @return false if the radio did not answer
+     */
+    bool init(void) override;
+
+    /** @brief IRQ to payload in buffer, per frame received */
+    const Rf95Timing& rx_latency(void) const { return rx_timing; }
+
+    /** @brief FIFO load, per frame sent */
+    const Rf95Timing& tx_load(void) const { return tx_timing; }
+
+    /** @brief Forget the timings */
+    void timing_reset(void);
+
+    /**
+     * @brief Print both timings on one line
+     *
+     * @param out Where to print (Serial)
+     */
+    void timing_print(Print& out) const;
+
+protected:
+    uint8_t spiRead(uint8_t reg) override;
+    uint8_t spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len) override;
+    uint8_t spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len) override;
+
+private:
+    /** @brief Clock in the FIFO bytes by DMA (address byte already sent) */
+    void fifo_transfer(uint8_t* dest, const uint8_t* src, uint8_t len);
+
+    static void record(Rf95Timing& t, uint32_t us);
+
+    FastPin cs_pin;
+    volatile uint32_t irq_start_us;
+    volatile bool irq_pending;
+    Rf95Timing rx_timing;
+    Rf95Timing tx_timing;
+};
+
+#endif // RF95_DMA_H
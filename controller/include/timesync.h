@@ -0,0 +1,113 @@
+/**
+ * @file timesync.h
+ * @brief Controller/phaser clock synchronisation
+ *
+ * Maintains a shared millisecond timebase between the controller and the
+ * remote phaser using NTP-style timestamps piggybacked on normal traffic:
+ * - T1 = controller millis() when the command is handed to the radio
+ * - T2 = phaser millis() when the command was received (reply trailer)
+ * - T3 = phaser millis() when the reply was handed to the radio (reply trailer)
+ * - T4 = controller millis() when the reply was received
+ *
+ * Exchanges inflated by RadioHead retries are rejected with a minimum
+ * round-trip filter, and crystal drift between the two Feathers is tracked
+ * so conversions stay accurate between exchanges.
+ *
+ * All arithmetic is integer; millis() wrap-around is handled by working
+ * with signed differences.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <stdint.h>
+
+/**
+ * @brief Forget all sync state
+ *
+ * Called at startup and automatically when a step in the phaser clock is
+ * detected (e.g. the phaser rebooted).
+ */
+void timesync_reset(void);
+
+/**
+ * @brief Feed one four-timestamp exchange into the estimator
+ *
+ * @param t1 Controller time command sent (ms)
+ * @param t2 Phaser time command received (ms)
+ * @param t3 Phaser time reply sent (ms)
+ * @param t4 Controller time reply received (ms)
+ * @return true if the sample was accepted, false if rejected as delayed or
+ *         as having a round trip below -TIMESYNC_NEGATIVE_DELAY_MS
+ */
+bool timesync_update(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4);
+
+/**
+ * @brief Extract and consume the time-sync trailer of a phaser reply
+ *
+ * If the reply ends in a valid "tRRRRRRRRXXXXXXXX" trailer, the exchange is
+ * fed to timesync_update() and the trailer is removed from the reply by
+ * shortening len, so callers see the reply exactly as before.
+ *
+ * A command that was sent more than once has no known T1: the reply may
+ * answer any of the transmissions. Pass t1_known false and the trailer is
+ * still consumed, but not fed to the estimator.
+ *
+ * @param buf Reply buffer
+ * @param len In: reply length; out: length without the trailer
+ * @param t1 Controller time command sent (ms)
+ * @param t1_known false if the command was resent
+ * @param t4 Controller time reply received (ms)
+ * @param phaser_tx_ms Out: phaser time the reply was sent (T3), if present
+ * @return true if a trailer was found
+ */
+bool timesync_process_reply(const uint8_t* buf, uint8_t& len, uint32_t t1, bool t1_known,
+                            uint32_t t4, uint32_t& phaser_tx_ms);
+
+/**
+ * @brief Whether at least one exchange has been accepted
+ */
+bool timesync_valid(void);
+
+/**
+ * @brief Estimated phaser-minus-controller clock offset at a local time
+ *
+ * @param local_ms Controller time (ms)
+ * @return Offset in ms (phaser = local + offset)
+ */
+int32_t timesync_offset_at(uint32_t local_ms);
+
+/**
+ * @brief Convert a phaser timestamp to controller time
+ *
+ * @param phaser_ms Phaser millis() value
+ * @return Equivalent controller millis() value
+ */
+uint32_t timesync_phaser_to_local(uint32_t phaser_ms);
+
+/**
+ * @brief Convert a controller timestamp to phaser time
+ *
+ * @param local_ms Controller millis() value
+ * @return Equivalent phaser millis() value
+ */
+uint32_t timesync_local_to_phaser(uint32_t local_ms);
+
+/**
+ * @brief Current drift estimate of the phaser clock relative to ours
+ *
+ * @return Drift in parts per billion (positive = phaser runs fast)
+ */
+int32_t timesync_drift_ppb(void);
+
+/**
+ * @brief Round-trip delay of the last accepted exchange
+ *
+ * @return Delay in ms, excluding phaser processing time
+ */
+int32_t timesync_last_delay_ms(void);
+
+#endif // TIMESYNC_H
@@ -0,0 +1,28 @@
+/**
+ * @file config.cpp
+ * @brief Lookup tables declared in config.h
+ *
+ * The tables are const, so they stay in flash; defining them here rather
+ * than as statics in the header keeps a single copy in the image. Also
+ * built into tools/hal_bench.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <stdint.h>
+
+#include "config.h"
+
+const char BAND_NAMES[16][5] = {
+    "GEN", "160m", "80m", "40m", "30m", "20m", "17m", "15m",
+    "12m", "10m", "6m", "?", "?", "?", "?", "?"
+};
+
+const char DIRECTION_NAMES[NUM_DIRECTIONS][3] = {
+    "N", "NE", "E", "SE", "S", "SW", "W", "NW"
+};
+
+const uint16_t DIRECTION_ANGLES[NUM_DIRECTIONS] = {
+    0, 45, 90, 135, 180, 225, 270, 315
+};
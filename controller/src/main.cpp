@@ -31,30 +31,26 @@
 #include <Wire.h>
 #include <SPI.h>
 
-// Hardware-specific libraries
-#include <RH_RF95.h>
-#include <RHReliableDatagram.h>
-#include <Adafruit_MCP23X17.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SH110X.h>
-
 // Project headers
 #include "config.h"
 #include "protocol.h"
+#include "hardware.h"
+#include "timesync.h"
+#include "reply_fields.h"
+#include "bulk_codec.h"
+#include "packet_pool.h"
+#include "flow.h"
 
 // ============================================================================
 // GLOBAL OBJECTS
 // ============================================================================
 
-// LoRa radio objects
-RH_RF95 rf95(RF95_CS, RF95_INT);
-RHReliableDatagram rf95_manager(rf95, MY_ADDRESS);
-
-// Display objects
-Adafruit_SH1106G display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+// Radio, display, GPIO expander and inputs (see hardware.h)
+Board board;
 
-// GPIO expander object
-Adafruit_MCP23X17 mcp;
+// Radio frame buffers
+PacketPool<PACKET_POOL_BLOCKS> packet_pool;
+static_assert(PACKET_MTU == RH_RF95_MAX_MESSAGE_LEN, "PACKET_MTU must match the RFM95 MTU");
 
 // ============================================================================
 // APPLICATION STATE
@@ -72,12 +68,62 @@ int16_t packet_count = 0;
 /** @brief Last reverse power reading from phaser */
 char last_rev_power[8] = "--";
 
+/** @brief Last peak-hold (PEP) reverse power reading from phaser */
+char last_rev_peak[8] = "--";
+
+/** @brief Last SWR x 100 from phaser (0 = no carrier or not reported) */
+uint16_t last_swr_x100 = 0;
+
 /** @brief Command buffer for current transmission */
 Command current_command = {{0}, 0};
 
-/** @brief Buffer for last phaser reply */
-uint8_t last_reply_buffer[RH_RF95_MAX_MESSAGE_LEN];
-uint8_t last_reply_length = 0;
+/** @brief Last position reply from the phaser, held from the packet pool */
+Packet* last_reply = NULL;
+
+/** @brief Controller time (shared timebase) at which the last reply was generated */
+uint32_t last_reply_time_ms = 0;
+
+/** @brief Phaser start time of the newest history record received, per tier */
+uint32_t history_cursor[HISTORY_NUM_TIERS] = {
+    HISTORY_SINCE_OLDEST, HISTORY_SINCE_OLDEST, HISTORY_SINCE_OLDEST
+};
+
+/** @brief History channel labels, in record order */
+static const char HISTORY_CHANNEL_NAMES[HISTORY_NUM_CHANNELS][7] = {
+    "busmV", "busmA", "mcumV", "rev.1W"
+};
+
+/** @brief Number of records in the last history reply */
+uint8_t last_history_count = 0;
+
+/** @brief Bulk download session as announced by the phaser's last 'B' reply */
+bool bulk_session_valid = false;
+uint8_t bulk_session_id = 0;
+uint8_t bulk_tier = 0;
+uint8_t bulk_chunk_total = 0;
+uint32_t bulk_last_start_ms = 0;
+bool bulk_more_pending = false;
+
+/** @brief Chunks of the current bulk session received so far */
+uint16_t bulk_received_mask = 0;
+
+/** @brief Chunks the phaser agreed to resend in its last 'R' reply */
+uint16_t bulk_resend_mask = 0;
+
+/** @brief Band code acted on, and a new one waiting out the debounce (-1 = none) */
+int band_code = -1;
+int band_pending_code = -1;
+uint32_t band_pending_since_ms = 0;
+
+/** @brief Relay map profile wanted, and as last reported by the phaser (-1 = unknown) */
+int wanted_profile = -1;
+int phaser_profile = -1;
+
+/** @brief millis() of the last profile select sent */
+uint32_t last_profile_send_ms = 0;
+
+/** @brief The phaser answered the last select with another profile */
+bool profile_refused = false;
 
 // ============================================================================
 // FUNCTION PROTOTYPES
@@ -86,15 +132,49 @@ uint8_t last_reply_length = 0;
 void init_all_hardware(void);
 void build_direction_command(int direction, Command& cmd);
 void build_ptt_command(Command& cmd);
-void send_and_process_command(const Command& cmd);
+void build_position_query(Command& cmd);
+void build_history_command(char type, uint8_t tier, uint32_t since_ms, Command& cmd);
+void build_resend_command(uint8_t session, uint16_t mask, Command& cmd);
+void build_calibration_command(char sub, uint16_t ref_dw, Command& cmd);
+void build_stats_command(char scope, Command& cmd);
+void build_wear_command(uint8_t clear_relay, Command& cmd);
+void build_schedule_command(char sub, uint32_t phaser_ms, int direction, Command& cmd);
+bool send_and_process_command(const Command& cmd);
 void process_reply(const uint8_t* buf, uint8_t len);
+void process_history_reply(const uint8_t* buf, uint8_t len);
+void process_bulk_reply(const uint8_t* buf, uint8_t len);
+void process_bulk_chunk(const uint8_t* buf, uint8_t len);
+void process_calibration_reply(const uint8_t* buf, uint8_t len);
+void process_event(const uint8_t* buf, uint8_t len);
+void process_stats_reply(const uint8_t* buf, uint8_t len);
+void process_wear_reply(const uint8_t* buf, uint8_t len);
+void process_schedule_reply(const uint8_t* buf, uint8_t len);
+void process_schedule_report(const uint8_t* buf, uint8_t len);
+void process_relay_check(const uint8_t* buf, uint8_t len);
+void process_interlock(const uint8_t* buf, uint8_t len);
+void process_profile(const uint8_t* buf, uint8_t len);
+void poll_phaser_events(void);
+Packet* alloc_packet(uint8_t owner);
+void keep_reply(Packet*& reply);
+void print_history_record(uint8_t tier, const BulkRecord& rec);
 Direction parse_direction_from_reply(const uint8_t* buf);
 void display_telemetry(const uint8_t* buf, uint8_t len);
 void handle_button_press(int button);
 void handle_ptt_press(void);
+void handle_history_request(uint8_t tier);
+void handle_bulk_request(uint8_t tier);
+void receive_bulk_chunks(void);
+void handle_calibration_request(const char* text);
+void handle_stats_request(char scope);
+void handle_wear_request(const char* text);
+void handle_schedule_request(const char* text);
+void handle_profile_request(const char* text);
+void select_profile(int profile);
+void poll_band_data(void);
+void handle_sweep_request(void);
+void flows_run(void);
+void flows_cancel(void);
 void handle_serial_input(void);
-void display_message(const char* message);
-bool debounce_pin(int pin, int target_level);
 
 // ============================================================================
 // INITIALIZATION
@@ -118,64 +198,67 @@ void init_all_hardware(void) {
     Serial.println("\n========== LoRa Antenna Controller Starting ==========");
     
     // Initialize LoRa radio
-    if (!rf95_manager.init()) {
+    if (!radio_init()) {
         Serial.println("ERROR: RF95 radio initialization failed!");
+        board.pin_output(LED);
         while (1) {
-            digitalWrite(LED, HIGH);
+            board.pin_write(LED, HIGH);
             delay(100);
-            digitalWrite(LED, LOW);
+            board.pin_write(LED, LOW);
             delay(100);
         }
     }
     Serial.println("✓ LoRa Radio initialized");
     
     // Configure radio frequency and power
-    if (!rf95.setFrequency(RF95_FREQ)) {
+    if (!board.radio_set_frequency(RF95_FREQ)) {
         Serial.println("ERROR: Failed to set radio frequency!");
         while (1);
     }
-    rf95.setTxPower(20, false);
-    rf95_manager.setTimeout(REC_TIMEOUT);
+    board.radio_set_power(20);
     Serial.printf("✓ Radio configured: %.1f MHz, TX Power 20 dBm\n", RF95_FREQ);
+    Serial.printf("✓ Packet pool: %u x %u bytes = %u bytes\n", packet_pool.capacity(),
+                  (unsigned)sizeof(Packet), (unsigned)packet_pool.bytes());
     
     // Initialize OLED display
-    pinMode(LED, OUTPUT);
-    digitalWrite(LED, HIGH);
+    board.pin_output(LED);
+#if FAST_GPIO_BENCH
+    fast_gpio_bench(Serial, LED);
+#endif
+    board.pin_write(LED, HIGH);
     delay(250);  // Wait for OLED to power up
     
-    if (!display.begin(OLED_I2C_ADDRESS, true)) {
+    if (!display_init()) {
         Serial.println("ERROR: OLED display initialization failed!");
         while (1);
     }
-    display.clearDisplay();
-    display.setTextSize(2);
-    display.setTextColor(SH110X_WHITE);
-    display.setCursor(0, 0);
-    display.println("READY!");
-    display.display();
     Serial.println("✓ OLED Display initialized");
     delay(1000);
     
-    // Initialize GPIO expander (buttons and LEDs)
-    if (!mcp.begin_I2C()) {
+    // Initialize GPIO expander: buttons 0-7 as inputs, LEDs 8-15 as outputs
+    if (!gpio_init()) {
         Serial.println("ERROR: MCP23017 GPIO expander initialization failed!");
-        display.clearDisplay();
-        display.setCursor(0, 0);
-        display.println("GPIO FAILED");
-        display.display();
+        board.display_clear();
+        board.display_text(0, 0, 2, "GPIO FAILED");
+        board.display_flush();
         while (1);
     }
     
-    // Configure MCP pins: 0-7 as inputs (buttons), 8-15 as outputs (LEDs)
-    for (int i = 0; i < NUM_DIRECTIONS; i++) {
-        mcp.pinMode(BUTTON_PIN_START + i, INPUT_PULLUP);
-        mcp.pinMode(LED_PIN_START + i, OUTPUT);
-    }
-    
     // Light up the LED for current direction
-    mcp.digitalWrite(LED_PIN_START + current_direction, HIGH);
+    gpio_show_led(current_direction);
     Serial.println("✓ GPIO Expander initialized");
     
+#if BAND_DATA_ENABLED
+    // Band data inputs, pulled to "no band" (code 0) when unconnected
+    const uint8_t band_pins[] = {
+        BAND_DATA_PIN_A, BAND_DATA_PIN_B, BAND_DATA_PIN_C, BAND_DATA_PIN_D
+    };
+    for (uint8_t i = 0; i < 4; i++) {
+        board.pin_input(band_pins[i], BAND_DATA_ACTIVE_LOW);
+    }
+    Serial.println("✓ Band data inputs configured");
+#endif
+    
     Serial.println("========== All systems ready ==========\n");
 }
 
@@ -193,22 +276,19 @@ void init_all_hardware(void) {
  * @param cmd Output command structure to fill
  */
 void build_direction_command(int direction, Command& cmd) {
-    const char* angles[] = {
-        ANGLE_N, ANGLE_NE, ANGLE_E, ANGLE_SE,
-        ANGLE_S, ANGLE_SW, ANGLE_W, ANGLE_NW
-    };
+    uint16_t angle = DIRECTION_ANGLES[direction];
     
     cmd.data[0] = 'A';
     cmd.data[1] = 'P';
     cmd.data[2] = '1';
-    cmd.data[3] = angles[direction][0];
-    cmd.data[4] = angles[direction][1];
-    cmd.data[5] = angles[direction][2];
+    cmd.data[3] = '0' + angle / 100;
+    cmd.data[4] = '0' + (angle / 10) % 10;
+    cmd.data[5] = '0' + angle % 10;
     cmd.data[6] = CMD_TERMINATOR;
     cmd.length = 7;
     
-    DEBUG_PRINTF("Built direction command for %s (%s°)\n",
-                 DIRECTION_NAMES[direction], angles[direction]);
+    DEBUG_PRINTF("Built direction command for %s (%03u°)\n",
+                 DIRECTION_NAMES[direction], angle);
 }
 
 /**
@@ -225,48 +305,392 @@ void build_ptt_command(Command& cmd) {
 }
 
 /**
- * @brief Send command and process reply from phaser
+ * @brief Build a position query
  *
- * Transmits command via LoRa and waits for response.
- * Handles TimeoutsAutomatic retries via RadioHead.
+ * Builds command in format: AI1 (the phaser replies with its position
+ * reply and changes nothing)
  *
- * @param cmd Command structure to send
+ * @param cmd Output command structure to fill
+ */
+void build_position_query(Command& cmd) {
+    cmd.data[0] = CMD_PREFIX_POS;
+    cmd.data[1] = 'I';
+    cmd.data[2] = CMD_PREFIX_POS3;
+    cmd.length = 3;
+}
+
+/**
+ * @brief Build a telemetry history query or bulk download request
+ *
+ * Builds command in format: HTSSSSSSSS (ASCII chunks) or BTSSSSSSSS
+ * (compressed bulk), where T is the tier and SSSSSSSS the phaser time (hex)
+ * of the last record already held, or HISTORY_SINCE_OLDEST for everything.
+ *
+ * @param type CMD_HISTORY or CMD_BULK
+ * @param tier History tier (0 = 1 s, 1 = 1 min, 2 = 15 min)
+ * @param since_ms Phaser time of the last record already received
+ * @param cmd Output command structure to fill
  */
-void send_and_process_command(const Command& cmd) {
-    // Send command via RadioHead reliable datagram with authentication
-    uint8_t reply_buf[RH_RF95_MAX_MESSAGE_LEN];
-    uint8_t reply_len = sizeof(reply_buf);
-    uint8_t from_addr;
+void build_history_command(char type, uint8_t tier, uint32_t since_ms, Command& cmd) {
+    cmd.data[0] = type;
+    cmd.data[1] = '0' + tier;
+    snprintf((char*)&cmd.data[2], sizeof(cmd.data) - 2, "%08lX", (unsigned long)since_ms);
+    cmd.length = CMD_HISTORY_LEN;
     
-    // Build authenticated packet: [command data] + [auth_hi][auth_lo]
-    uint8_t auth_packet[cmd.length + AUTH_LEN];
-    memcpy(auth_packet, cmd.data, cmd.length);
+    DEBUG_PRINTF("Built %c command: tier %d since %08lX\n", type, tier, (unsigned long)since_ms);
+}
+
+/**
+ * @brief Build a bulk chunk retransmit request
+ *
+ * Builds command in format: RSSMMMM
+ *
+ * @param session Bulk session id
+ * @param mask Bit i set = resend chunk i
+ * @param cmd Output command structure to fill
+ */
+void build_resend_command(uint8_t session, uint16_t mask, Command& cmd) {
+    char resend_str[CMD_RESEND_LEN + 1];
+    snprintf(resend_str, sizeof(resend_str), "%c%02X%04X", CMD_RESEND, session, mask);
+    memcpy(cmd.data, resend_str, CMD_RESEND_LEN);
+    cmd.length = CMD_RESEND_LEN;
+}
+
+/**
+ * @brief Build a reverse power calibration command
+ *
+ * Builds command in format: CX, or CPNNNNN for a calibration point
+ *
+ * @param sub Sub-command letter (B, P, E, A, Q, D)
+ * @param ref_dw Reference reverse power in 0.1 W (CP only)
+ * @param cmd Output command structure to fill
+ */
+void build_calibration_command(char sub, uint16_t ref_dw, Command& cmd) {
+    char cal_str[CMD_CAL_POINT_LEN + 1];
+    snprintf(cal_str, sizeof(cal_str), "%c%c%05u", CMD_CAL, sub, ref_dw);
+    cmd.length = (sub == CAL_SUB_POINT) ? CMD_CAL_POINT_LEN : CMD_CAL_LEN;
+    memcpy(cmd.data, cal_str, cmd.length);
+}
+
+/**
+ * @brief Build a sensor statistics query
+ *
+ * Builds command in format: SX
+ *
+ * @param scope STATS_SUB_ALL, STATS_SUB_RESET or a direction digit
+ * @param cmd Output command structure to fill
+ */
+void build_stats_command(char scope, Command& cmd) {
+    cmd.data[0] = CMD_STATS;
+    cmd.data[1] = scope;
+    cmd.length = CMD_STATS_LEN;
+}
+
+/**
+ * @brief Build a relay operation counter command
+ *
+ * Builds command in format: OQ, or OZnn to restart relay nn's count
+ *
+ * @param clear_relay Relay to restart (1-99), 0 = report only
+ * @param cmd Output command structure to fill
+ */
+void build_wear_command(uint8_t clear_relay, Command& cmd) {
+    cmd.data[0] = CMD_WEAR;
+    if (clear_relay == 0) {
+        cmd.data[1] = WEAR_SUB_QUERY;
+        cmd.length = CMD_WEAR_LEN;
+        return;
+    }
+    cmd.data[1] = WEAR_SUB_CLEAR;
+    cmd.data[2] = '0' + (clear_relay / 10) % 10;
+    cmd.data[3] = '0' + clear_relay % 10;
+    cmd.length = CMD_WEAR_CLEAR_LEN;
+}
+
+/**
+ * @brief Build a scheduled direction change command
+ *
+ * Builds command in format: TAXXXXXXXXD, TC or TQ
+ *
+ * @param sub SCHED_SUB_ADD, SCHED_SUB_CLEAR or SCHED_SUB_QUERY
+ * @param phaser_ms Time to switch, on the phaser's clock (add only)
+ * @param direction Direction to switch to (add only)
+ * @param cmd Output command structure to fill
+ */
+void build_schedule_command(char sub, uint32_t phaser_ms, int direction, Command& cmd) {
+    char sched_str[CMD_SCHED_ADD_LEN + 1];
+    snprintf(sched_str, sizeof(sched_str), "%c%c%08lX%d", CMD_SCHEDULE, sub,
+             (unsigned long)phaser_ms, direction);
+    cmd.length = (sub == SCHED_SUB_ADD) ? CMD_SCHED_ADD_LEN : CMD_SCHED_LEN;
+    memcpy(cmd.data, sched_str, cmd.length);
+}
+
+/**
+ * @brief Build a relay map profile select command
+ *
+ * Builds command in format: PN (N = profile, hex digit)
+ *
+ * @param profile Profile (0-15)
+ * @param cmd Output command structure to fill
+ */
+void build_profile_command(uint8_t profile, Command& cmd) {
+    cmd.data[0] = CMD_PROFILE;
+    cmd.data[1] = "0123456789ABCDEF"[profile & 0x0F];
+    cmd.length = CMD_PROFILE_LEN;
+}
+
+// ============================================================================
+// RADIO EXCHANGE
+// ============================================================================
+
+/** @brief Progress of the command exchange */
+enum ExchangeStatus : uint8_t {
+    EXCHANGE_IDLE = 0,             /**< None started */
+    EXCHANGE_PENDING,              /**< Waiting for the reply */
+    EXCHANGE_DONE,                 /**< Reply received and processed */
+    EXCHANGE_FAILED                /**< Not sent, or no reply after all retries */
+};
+
+/** @brief The one command in flight */
+struct Exchange {
+    Packet* request;               /**< Authenticated frame, kept for resends */
+    uint32_t sent_ms;              /**< millis() of the last transmission (NTP T1 if sent once) */
+    uint8_t attempts;              /**< Transmissions so far */
+    uint8_t seq;                   /**< RadioHead header id of the command */
+    ExchangeStatus status;
+    bool acked;                    /**< The phaser ACKed the command */
+    bool tx_failed;                /**< Failed because the radio refused the frame */
+};
+
+Exchange exchange = {NULL, 0, 0, 0, EXCHANGE_IDLE, false, false};
+
+/**
+ * @brief Transmit the request with the command's header id, without waiting
+ *
+ * Every command gets a new id in exchange_start(), so the phaser's
+ * duplicate filter never drops a new command; a resend keeps the id, so
+ * the phaser ACKs it again but executes the command only once.
+ *
+ * @return false if the radio refused the frame
+ */
+static bool exchange_transmit(void) {
+    exchange.sent_ms = millis();
+    exchange.attempts++;
+    return board.radio_send(exchange.request->data, exchange.request->len, DEST_ADDRESS,
+                            exchange.seq);
+}
+
+/**
+ * @brief End the exchange and give the request back to the pool
+ *
+ * @param status EXCHANGE_DONE or EXCHANGE_FAILED
+ */
+static void exchange_finish(ExchangeStatus status) {
+    packet_pool.release(exchange.request);
+    exchange.status = status;
+}
+
+/**
+ * @brief Authenticate and send a command; the reply is collected by exchange_poll()
+ *
+ * @param cmd Command to send
+ * @return false if an exchange is already in flight or no packet is free
+ */
+bool exchange_start(const Command& cmd) {
+    if (exchange.status == EXCHANGE_PENDING) {
+        return false;
+    }
+    exchange.request = alloc_packet(PACKET_AUTH);
+    if (exchange.request == NULL) {
+        exchange.status = EXCHANGE_FAILED;
+        return false;
+    }
     
-    // Compute and append authentication hash
-    uint16_t auth = compute_auth(cmd.data, cmd.length);
-    auth_packet[cmd.length] = (auth >> 8) & 0xFF;      // High byte
-    auth_packet[cmd.length + 1] = auth & 0xFF;         // Low byte
+    // Build authenticated packet in place: [command data] + [auth_hi][auth_lo]
+    Packet* request = exchange.request;
+    memcpy(request->data, cmd.data, cmd.length);
+    uint16_t auth = compute_auth(request->data, cmd.length);
+    request->data[cmd.length] = (auth >> 8) & 0xFF;      // High byte
+    request->data[cmd.length + 1] = auth & 0xFF;         // Low byte
+    request->len = cmd.length + AUTH_LEN;
     
-    Serial.printf("→ Sending %d byte command (auth: %04X): ", cmd.length + AUTH_LEN, auth);
+    Serial.printf("→ Sending %d byte command (auth: %04X): ", request->len, auth);
     for (int i = 0; i < cmd.length; i++) {
         Serial.write(cmd.data[i]);
     }
-    Serial.printf(" [%02X %02X]\n", auth_packet[cmd.length], auth_packet[cmd.length + 1]);
+    Serial.printf(" [%02X %02X]\n", request->data[cmd.length], request->data[cmd.length + 1]);
     
     // Send authenticated packet to phaser unit
-    if (rf95_manager.sendtoWait(auth_packet, cmd.length + AUTH_LEN, DEST_ADDRESS)) {
-        // Wait for reply
-        if (rf95_manager.recvfromAck(reply_buf, &reply_len, &from_addr)) {
-            Serial.printf("← Received %d byte reply from [%d]\n", reply_len, from_addr);
-            process_reply(reply_buf, reply_len);
-        } else {
+    packet_pool.pass(request, PACKET_RADIO);
+    exchange.seq++;
+    exchange.attempts = 0;
+    exchange.acked = false;
+    exchange.tx_failed = false;
+    exchange.status = EXCHANGE_PENDING;
+    if (!exchange_transmit()) {
+        Serial.println("ERROR: Failed to send command to phaser");
+        exchange.tx_failed = true;
+        exchange_finish(EXCHANGE_FAILED);
+    }
+    return true;
+}
+
+/**
+ * @brief Collect the reply to the command in flight, resending until ACKed
+ *
+ * Never blocks. Like sendtoWait(), a command the phaser has not ACKed
+ * within ACK_TIMEOUT is sent again, up to EXCHANGE_RETRIES times; once
+ * ACKed, the reply has REC_TIMEOUT to arrive. The reply is ACKed,
+ * timestamped, processed and, for a position reply, kept as last_reply.
+ * A protection event or schedule confirmation that arrives first is
+ * processed the same way and the wait goes on.
+ *
+ * @return Status of the exchange (EXCHANGE_DONE and EXCHANGE_FAILED stay
+ *         until the next exchange_start())
+ */
+ExchangeStatus exchange_poll(void) {
+    if (exchange.status != EXCHANGE_PENDING) {
+        return exchange.status;
+    }
+    
+    if (board.radio_available()) {
+        Packet* reply = alloc_packet(PACKET_RADIO);
+        if (reply == NULL) {
+            return exchange.status;
+        }
+        reply->len = PACKET_MTU;
+        uint8_t from_addr;
+        if (board.radio_receive(reply->data, reply->len, from_addr) &&
+            from_addr == DEST_ADDRESS) {
+            uint32_t t4 = millis();
+            Serial.printf("← Received %d byte reply from [%d]\n", reply->len, from_addr);
+            bool unsolicited = reply->len > 0 && (reply->data[0] == REPLY_EVENT ||
+                                                  reply->data[0] == REPLY_SCHED_REPORT);
+            
+            // Consume the time-sync trailer and timestamp the telemetry
+            uint32_t phaser_tx_ms;
+            if (unsolicited) {
+                // Sent by the phaser on its own, no trailer
+            } else if (timesync_process_reply(reply->data, reply->len, exchange.sent_ms,
+                                              exchange.attempts == 1, t4, phaser_tx_ms)) {
+                last_reply_time_ms = timesync_phaser_to_local(phaser_tx_ms);
+                Serial.printf("  @%lu ms (offset %ld ms, rtt %ld ms, drift %ld ppb)\n",
+                              (unsigned long)last_reply_time_ms,
+                              (long)timesync_offset_at(t4),
+                              (long)timesync_last_delay_ms(),
+                              (long)timesync_drift_ppb());
+            } else {
+                last_reply_time_ms = t4;
+            }
+            process_reply(reply->data, reply->len);
+            keep_reply(reply);
+            if (!unsolicited) {
+                exchange_finish(EXCHANGE_DONE);
+                return exchange.status;
+            }
+        }
+        packet_pool.release(reply);
+    }
+    
+    if (!exchange.acked && board.radio_acked(DEST_ADDRESS, exchange.seq)) {
+        exchange.acked = true;
+    }
+    uint32_t waited = millis() - exchange.sent_ms;
+    if (exchange.acked) {
+        if (waited >= REC_TIMEOUT) {
             Serial.println("ERROR: No reply from phaser (timeout)");
-            display_message("TIMEOUT");
+            exchange_finish(EXCHANGE_FAILED);
         }
-    } else {
-        Serial.println("ERROR: Failed to send command to phaser");
-        display_message("TX FAIL");
+    } else if (waited >= ACK_TIMEOUT) {
+        if (exchange.attempts > EXCHANGE_RETRIES) {
+            Serial.println("ERROR: No ACK from phaser (timeout)");
+            exchange_finish(EXCHANGE_FAILED);
+        } else if (!exchange_transmit()) {
+            Serial.println("ERROR: Failed to send command to phaser");
+            exchange.tx_failed = true;
+            exchange_finish(EXCHANGE_FAILED);
+        } else {
+            Serial.printf("No ACK, resending (attempt %d)\n", exchange.attempts);
+        }
+    }
+    return exchange.status;
+}
+
+/**
+ * @brief Send command and process reply from phaser
+ *
+ * Blocking form of exchange_start() / exchange_poll() for single commands
+ * from the user. Cancels a running flow: the user takes over the radio.
+ *
+ * @param cmd Command structure to send
+ * @return true if a reply was received and processed
+ */
+bool send_and_process_command(const Command& cmd) {
+    flows_cancel();
+    while (exchange_poll() == EXCHANGE_PENDING) {
+        // Let a cancelled flow's command finish
+    }
+    
+    if (!exchange_start(cmd)) {
+        display_message("NO BUFFER");
+        return false;
+    }
+    while (exchange_poll() == EXCHANGE_PENDING) {
+    }
+    if (exchange.status == EXCHANGE_DONE) {
+        return true;
+    }
+    display_message(exchange.tx_failed ? "TX FAIL" : "TIMEOUT");
+    return false;
+}
+
+/**
+ * @brief Take a packet from the pool, reporting exhaustion
+ *
+ * @param owner Layer taking it (PacketOwner)
+ * @return Packet, or NULL if the pool is empty
+ */
+Packet* alloc_packet(uint8_t owner) {
+    Packet* p = packet_pool.alloc(owner);
+    if (p == NULL) {
+        Serial.printf("ERROR: Packet pool empty (%u in use, %lu failures)\n",
+                      packet_pool.in_use(), (unsigned long)packet_pool.failures());
+    }
+    return p;
+}
+
+/**
+ * @brief Keep a processed position reply, release anything else
+ *
+ * The position reply is held as last_reply in its own packet; the one it
+ * replaces goes back to the pool.
+ *
+ * @param reply Processed reply; ownership is taken and the pointer cleared
+ */
+void keep_reply(Packet*& reply) {
+    if (reply != NULL && reply->len > 0 && reply->data[0] == REPLY_POSITION) {
+        packet_pool.release(last_reply);
+        last_reply = packet_pool.pass(reply, PACKET_APP);
+        reply = NULL;
+        return;
+    }
+    packet_pool.release(reply);
+}
+
+/**
+ * @brief Parse a fixed-width decimal field from a reply
+ *
+ * @param s Field text (need not be null terminated)
+ * @param digits Number of digits (max 9)
+ * @return Parsed value (non-digit characters are treated as 0)
+ */
+static uint32_t parse_dec(const uint8_t* s, int digits) {
+    uint32_t value = 0;
+    for (int i = 0; i < digits; i++) {
+        value *= 10;
+        if (isdigit(s[i])) value += s[i] - '0';
     }
+    return value;
 }
 
 /**
@@ -293,157 +717,1084 @@ void process_reply(const uint8_t* buf, uint8_t len) {
                 Serial.printf("Direction: %s\n", DIRECTION_NAMES[direction]);
             }
         }
-        // Store full reply and display telemetry
-        memcpy(last_reply_buffer, buf, len);
-        last_reply_length = len;
+        // Display telemetry (the caller keeps the reply as last_reply)
+        process_relay_check(buf, len);
+        process_interlock(buf, len);
+        process_profile(buf, len);
         display_telemetry(buf, len);
         
     } else if (buf[0] == 'V') {
-        // Power/SWR reply format: VPPPPPP
-        // Extract reverse power reading
-        if (len >= 7) {
+        // Power/SWR reply format: VPPPPPPpKKKKKKeEEEEEEfFFFFFFsSSSSlLLLxXXXX
+        // Extract average reverse power reading
+        if (len >= REPLY_POWER_FIELD_LEN) {
             for (int i = 0; i < 6; i++) {
                 last_rev_power[i] = buf[i + 1];
             }
             last_rev_power[6] = '\0';
             Serial.printf("Reverse Power: %s\n", last_rev_power);
         }
+        // Peak-hold and envelope fields (absent from older phasers)
+        if (len >= 3 * REPLY_POWER_FIELD_LEN &&
+            buf[REPLY_POWER_FIELD_LEN] == REPLY_FIELD_PEAK &&
+            buf[2 * REPLY_POWER_FIELD_LEN] == REPLY_FIELD_ENV) {
+            memcpy(last_rev_peak, buf + REPLY_POWER_FIELD_LEN + 1, 6);
+            last_rev_peak[6] = '\0';
+            Serial.printf("Reverse Peak: %s  Envelope: %.6s\n",
+                          last_rev_peak, (const char*)buf + 2 * REPLY_POWER_FIELD_LEN + 1);
+        }
+        // Forward power, SWR and return loss (absent from older phasers)
+        const uint8_t* swr_field = buf + 4 * REPLY_POWER_FIELD_LEN;
+        if (len >= 4 * REPLY_POWER_FIELD_LEN + REPLY_SWR_FIELDS_LEN &&
+            buf[3 * REPLY_POWER_FIELD_LEN] == REPLY_FIELD_FWD &&
+            swr_field[0] == REPLY_FIELD_SWR && swr_field[5] == REPLY_FIELD_RL &&
+            swr_field[9] == REPLY_FIELD_SWR_MAX) {
+            last_swr_x100 = parse_dec(swr_field + 1, 4);
+            uint16_t rl_x10 = parse_dec(swr_field + 6, 3);
+            uint16_t max_x100 = parse_dec(swr_field + 10, 4);
+            Serial.printf("Forward Power: %.6s\n",
+                          (const char*)buf + 3 * REPLY_POWER_FIELD_LEN + 1);
+            if (last_swr_x100) {
+                Serial.printf("SWR: %u.%02u:1  RL: %u.%u dB  (max %u.%02u:1)\n",
+                              last_swr_x100 / 100, last_swr_x100 % 100,
+                              rl_x10 / 10, rl_x10 % 10, max_x100 / 100, max_x100 % 100);
+            } else {
+                Serial.println("SWR: no carrier");
+            }
+        }
         // Display power data
         display_telemetry(buf, len);
+        
+    } else if (buf[0] == REPLY_HISTORY) {
+        process_history_reply(buf, len);
+        
+    } else if (buf[0] == REPLY_BULK) {
+        process_bulk_reply(buf, len);
+        
+    } else if (buf[0] == REPLY_RESEND && len >= CMD_RESEND_LEN) {
+        uint32_t mask;
+        if (parse_hex(buf + 3, 4, mask)) {
+            bulk_resend_mask = mask;
+        } else {
+            Serial.println("ERROR: Malformed resend reply");
+        }
+        
+    } else if (buf[0] == REPLY_CAL) {
+        process_calibration_reply(buf, len);
+        
+    } else if (buf[0] == REPLY_EVENT) {
+        process_event(buf, len);
+        
+    } else if (buf[0] == REPLY_STATS) {
+        process_stats_reply(buf, len);
+        
+    } else if (buf[0] == REPLY_WEAR) {
+        process_wear_reply(buf, len);
+        
+    } else if (buf[0] == REPLY_SCHEDULE) {
+        process_schedule_reply(buf, len);
+        
+    } else if (buf[0] == REPLY_SCHED_REPORT) {
+        process_schedule_report(buf, len);
     }
 }
 
 /**
- * @brief Parse direction from reply
+ * @brief Report the relay check carried by a position reply
  *
- * Extracts direction number from phaser reply.
+ * Format: "kXSSSSS" after the DCU-1 fields (see REPLY_FIELD_RELAY)
  *
- * @param buf Reply buffer
- * @return Direction (0-7) or current_direction if parse error
+ * @param buf Position reply
+ * @param len Reply length
  */
-Direction parse_direction_from_reply(const uint8_t* buf) {
-    if (buf[0] == ';' && buf[1] >= '0' && buf[1] <= '7') {
-        return (Direction)(buf[1] - '0');
+void process_relay_check(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_RELAY_FIELD_OFFSET + REPLY_RELAY_FIELD_LEN ||
+        buf[REPLY_RELAY_FIELD_OFFSET] != REPLY_FIELD_RELAY) {
+        return;  // Older phaser firmware
+    }
+    
+    const uint8_t* field = buf + REPLY_RELAY_FIELD_OFFSET;
+    long step_ma = (long)parse_dec(field + 3, 4);
+    if (field[2] == '-') step_ma = -step_ma;
+    
+    switch (field[1]) {
+        case RELAY_CHECK_OK:
+            Serial.printf("Relays verified (coil step %+ld mA)\n", step_ma);
+            break;
+        case RELAY_CHECK_LEARNED:
+            Serial.printf("Relay coil current learned (step %+ld mA)\n", step_ma);
+            break;
+        case RELAY_CHECK_FAILED:
+            Serial.printf("ERROR: Relay check FAILED (coil step %+ld mA)\n", step_ma);
+            display_message("RELAY ERR");
+            break;
     }
-    return (Direction)current_direction;
 }
 
 /**
- * @brief Display telemetry data on OLED screen
+ * @brief Report the hot-switch interlock field of a position reply
  *
- * Shows antenna position, voltage, current, signal strength, and power data.
+ * Format: "wXWWWWW". The reported direction stays the old one while a
+ * change is held.
  *
- * @param buf Reply buffer from phaser
- * @param len Length of reply data
+ * @param buf Reply buffer
+ * @param len Reply length
  */
-void display_telemetry(const uint8_t* buf, uint8_t len) {
-  // Clear screen and display reverse power
-  display.clearDisplay();
-  display.setTextSize(2);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(0, 0);
-  display.print("Rev ");
-  for (int i = 0; i < 6; i++) display.print(last_rev_power[i]);
-  display.println();
-  
-  // Show RSSI (transmit and receive)
-  display.setTextSize(1);
-  display.setCursor(0, 20);
-  display.print("RSSI T/R: ");
-  display.printf("%+04d", rf95.lastRssi());
-  display.print("/-");
-  
-  // Show receive RSSI from phaser reply
-  if (len >= 9) {
-    for (int i = 6; i < 9; i++) {
-      display.print((char)buf[i]);
+void process_interlock(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_INTERLOCK_FIELD_OFFSET + REPLY_INTERLOCK_FIELD_LEN ||
+        buf[REPLY_INTERLOCK_FIELD_OFFSET] != REPLY_FIELD_INTERLOCK) {
+        return;  // Older phaser firmware
     }
-  }
-  
-  // Show bus voltage
-  display.setCursor(0, 30);
-  display.print("Bus V: ");
-  if (len >= 15) {
-    display.print((char)buf[10]);
-    display.print((char)buf[11]);
-    display.print(".");
-    for (int i = 12; i < 15; i++) {
-      display.print((char)buf[i]);
+    
+    const uint8_t* field = buf + REPLY_INTERLOCK_FIELD_OFFSET;
+    unsigned long wait_ms = parse_dec(field + 2, 5);
+    
+    switch (field[1]) {
+        case INTERLOCK_HELD:
+            Serial.printf("RF present: direction change held (%lu ms)\n", wait_ms);
+            display_message("RF HOLD");
+            break;
+        case INTERLOCK_APPLIED:
+            Serial.printf("Direction changed after RF dropped (waited %lu ms)\n", wait_ms);
+            break;
+        case INTERLOCK_EXPIRED:
+            Serial.printf("ERROR: Direction change dropped, RF present for %lu ms\n", wait_ms);
+            display_message("RF TIMEOUT");
+            break;
     }
-  }
-  
-  // Show bus current
-  display.setCursor(0, 40);
-  display.print("Bus mA: ");
-  if (len >= 19) {
-    for (int i = 16; i < 19; i++) {
-      display.print((char)buf[i]);
+}
+
+/**
+ * @brief Note the relay map profile field of a position reply
+ *
+ * Format: "gP". A phaser that restarted reports profile 0 again, and
+ * poll_band_data() then selects the band's profile once more.
+ *
+ * @param buf Position reply
+ * @param len Reply length
+ */
+void process_profile(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_PROFILE_FIELD_OFFSET + REPLY_PROFILE_FIELD_LEN ||
+        buf[REPLY_PROFILE_FIELD_OFFSET] != REPLY_FIELD_PROFILE) {
+        return;  // Older phaser firmware
     }
-  }
-  
-  // Show MCU voltage
-  display.setCursor(0, 50);
-  display.print("MCU V: ");
-  if (len >= 24) {
-    display.print((char)buf[20]);
-    display.print(".");
-    for (int i = 21; i < 24; i++) {
-      display.print((char)buf[i]);
+    
+    uint32_t value;
+    if (!parse_hex(buf + REPLY_PROFILE_FIELD_OFFSET + 1, 1, value)) {
+        Serial.println("ERROR: Malformed profile field");
+        return;
     }
-  }
-  
-  // Show antenna name / position
-  display.printf("\nDir: %s", DIRECTION_NAMES[current_direction]);
-  
-  // Update display
-  display.display();
+    int profile = (int)value;
+    if (profile != phaser_profile) {
+        Serial.printf("Relay map profile %d in use\n", profile);
+    }
+    phaser_profile = profile;
 }
 
-// ============================================================================
-// USER INPUT HANDLING
-// ============================================================================
-
 /**
- * @brief Handle button press on GPIO expander
+ * @brief Handle an unsolicited protection event from the phaser
  *
- * @param button Button index (0-7)
+ * Format: "EXDvVVVVViIIII". On a trip the phaser has already released
+ * its relays, so the direction LEDs are moved to the direction reported.
+ *
+ * @param buf Event buffer
+ * @param len Event length
  */
-void handle_button_press(int button) {
-  if (button < 0 || button >= NUM_DIRECTIONS) return;
-  if (button == last_button_pressed) return;  // Ignore same button
-  
-  Serial.printf("Button %d pressed: %s\n", button, DIRECTION_NAMES[button]);
-  
-  // Turn off prev LED, turn on new LED
-  for (int i = 0; i < NUM_DIRECTIONS; i++) {
-    mcp.digitalWrite(LED_PIN_START + i, (i == button) ? HIGH : LOW);
-  }
-  
-  // Send direction command
-  build_direction_command(button, current_command);
-  send_and_process_command(current_command);
-  
-  last_button_pressed = button;
+void process_event(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_EVENT_LEN) {
+        Serial.println("ERROR: Malformed protection event");
+        return;
+    }
+    
+    int direction = buf[2] - '0';
+    uint32_t bus_mv = parse_dec(buf + 4, 5);
+    uint32_t load_ma = parse_dec(buf + 10, 4);
+    
+    switch (buf[1]) {
+        case EVENT_OVERCURRENT:
+            Serial.printf("PHASER TRIP: relay overcurrent (%lu mA), relays released\n",
+                          (unsigned long)load_ma);
+            display_message("OVERCUR");
+            break;
+        case EVENT_UNDERVOLTAGE:
+            Serial.printf("PHASER TRIP: bus undervoltage (%lu mV), relays released\n",
+                          (unsigned long)bus_mv);
+            display_message("LOW VOLT");
+            break;
+        case EVENT_WARNING:
+            Serial.printf("PHASER WARNING: relay current %lu mA\n", (unsigned long)load_ma);
+            break;
+        case EVENT_CLEARED:
+            Serial.println("PHASER: protection trip cleared");
+            break;
+        default:
+            Serial.printf("Unknown protection event: %c\n", buf[1]);
+            return;
+    }
+    
+    if (direction >= 0 && direction < NUM_DIRECTIONS && direction != current_direction) {
+        current_direction = direction;
+        gpio_show_led(current_direction);
+        Serial.printf("Direction: %s\n", DIRECTION_NAMES[direction]);
+    }
 }
 
 /**
- * @brief Handle PTT button press
+ * @brief Receive frames the phaser sends on its own (protection events)
  *
- * PTT sends a telemetry request command ('V')
+ * While a command is in flight exchange_poll() takes them instead.
  */
-void handle_ptt_press(void) {
-  Serial.println("PTT pressed: requesting reverse power telemetry");
-  
-  build_ptt_command(current_command);
-  send_and_process_command(current_command);
+void poll_phaser_events(void) {
+    if (exchange.status == EXCHANGE_PENDING || !board.radio_available()) {
+        return;
+    }
+    Packet* frame = alloc_packet(PACKET_RADIO);
+    if (frame == NULL) {
+        return;
+    }
+    frame->len = PACKET_MTU;
+    uint8_t from;
+    if (board.radio_receive(frame->data, frame->len, from) && from == DEST_ADDRESS) {
+        process_reply(frame->data, frame->len);
+        keep_reply(frame);
+    }
+    packet_pool.release(frame);
 }
 
 /**
- * @brief Handle serial input for remote control
+ * @brief Print and account a telemetry history reply
+ *
+ * Format: "HTN" + N records (see REPLY_HISTORY). Each record is printed to
+ * serial on the controller's timebase and the tier cursor is advanced so
+ * the next query continues where this one stopped.
+ *
+ * @param buf Reply buffer
+ * @param len Reply length (time-sync trailer already removed)
+ */
+void process_history_reply(const uint8_t* buf, uint8_t len) {
+    last_history_count = 0;
+    if (len < 3) return;
+    
+    uint8_t tier = buf[1] - '0';
+    uint8_t count = buf[2] - '0';
+    if (tier >= HISTORY_NUM_TIERS || 3 + count * HISTORY_RECORD_TEXT_LEN > len) {
+        Serial.println("ERROR: Malformed history reply");
+        return;
+    }
+    
+    for (uint8_t r = 0; r < count; r++) {
+        const uint8_t* text = buf + 3 + r * HISTORY_RECORD_TEXT_LEN;
+        BulkRecord rec;
+        uint32_t direction, min_v, max_v, mean_v;
+        bool ok = parse_hex(text, 8, rec.start_ms) && parse_hex(text + 8, 1, direction);
+        rec.direction = direction;
+        for (int c = 0; ok && c < HISTORY_NUM_CHANNELS; c++) {
+            const uint8_t* field = text + 9 + c * 12;
+            ok = parse_hex(field, 4, min_v) && parse_hex(field + 4, 4, max_v) &&
+                 parse_hex(field + 8, 4, mean_v);
+            rec.min[c] = (int16_t)min_v;
+            rec.max[c] = (int16_t)max_v;
+            rec.mean[c] = (int16_t)mean_v;
+        }
+        if (!ok) {
+            // The cursor stays on the last good record, so the next query resends the rest
+            Serial.println("ERROR: Malformed history record");
+            return;
+        }
+        print_history_record(tier, rec);
+        history_cursor[tier] = rec.start_ms;
+        last_history_count++;
+    }
+}
+
+/**
+ * @brief Print a calibration reply as a table of reading vs. watts
+ *
+ * @param buf Reply buffer
+ * @param len Reply length (time-sync trailer already removed)
+ */
+void process_calibration_reply(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_CAL_HEADER_LEN) return;
+    
+    uint8_t status = buf[2] - '0';
+    uint8_t direction = buf[3] - '0';
+    uint32_t count;
+    if (!parse_hex(buf + 5, 1, count) || direction >= NUM_DIRECTIONS ||
+        REPLY_CAL_HEADER_LEN + count * 8 > len) {
+        Serial.println("ERROR: Malformed calibration reply");
+        return;
+    }
+    
+    static const char* const status_names[] = {
+        "OK", "not in calibration mode", "direction changed",
+        "table full", "point out of order", "flash write failed"
+    };
+    const char* table_kind = (buf[4] == 'W') ? "working" :
+                             (buf[4] == '1') ? "calibrated" : "default";
+    Serial.printf("Calibration %c %s: %s, %s table, %d points\n", buf[1],
+                  DIRECTION_NAMES[direction],
+                  status < 6 ? status_names[status] : "error", table_kind, (int)count);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* point = buf + REPLY_CAL_HEADER_LEN + i * 8;
+        uint32_t adc_q6, power_dw;
+        if (!parse_hex(point, 4, adc_q6) || !parse_hex(point + 4, 4, power_dw)) {
+            Serial.println("ERROR: Malformed calibration point");
+            return;
+        }
+        Serial.printf("  ADC %4u.%02u  %5u.%u W\n", adc_q6 >> 6, ((adc_q6 & 63) * 100) >> 6,
+                      power_dw / 10, power_dw % 10);
+    }
+}
+
+/**
+ * @brief Print a sensor statistics reply
+ *
+ * Format: "SXNNNNNNNN" + 4 x "mmmmMMMMaaaaVVVVVVVV" (see REPLY_STATS)
+ *
+ * @param buf Reply buffer
+ * @param len Reply length (time-sync trailer already removed)
+ */
+void process_stats_reply(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_STATS_HEADER_LEN + HISTORY_NUM_CHANNELS * STATS_CHANNEL_TEXT_LEN) {
+        Serial.println("ERROR: Malformed statistics reply");
+        return;
+    }
+    
+    uint8_t direction = buf[1] - '0';
+    uint32_t count;
+    if (!parse_hex(buf + 2, 8, count)) {
+        Serial.println("ERROR: Malformed statistics reply");
+        return;
+    }
+    Serial.printf("Statistics %s: %lu samples\n",
+                  (direction < NUM_DIRECTIONS) ? DIRECTION_NAMES[direction] : "all",
+                  (unsigned long)count);
+    if (count == 0) return;
+    
+    for (int c = 0; c < HISTORY_NUM_CHANNELS; c++) {
+        const uint8_t* field = buf + REPLY_STATS_HEADER_LEN + c * STATS_CHANNEL_TEXT_LEN;
+        uint32_t min_v, max_v, mean_v, variance;
+        if (!parse_hex(field, 4, min_v) || !parse_hex(field + 4, 4, max_v) ||
+            !parse_hex(field + 8, 4, mean_v) || !parse_hex(field + 12, 8, variance)) {
+            Serial.println("ERROR: Malformed statistics channel");
+            return;
+        }
+        Serial.printf("  %-6s min %d max %d mean %d sd %.1f\n", HISTORY_CHANNEL_NAMES[c],
+                      (int16_t)min_v, (int16_t)max_v, (int16_t)mean_v, sqrt((double)variance));
+    }
+}
+
+/**
+ * @brief Print a relay operation counter reply
+ *
+ * Format: "ONNCCCCCCCC" + NN x "OOOOOOOO" (see REPLY_WEAR)
+ *
+ * @param buf Reply buffer
+ * @param len Reply length (time-sync trailer already removed)
+ */
+void process_wear_reply(const uint8_t* buf, uint8_t len) {
+    if (len < REPLY_WEAR_HEADER_LEN) {
+        Serial.println("ERROR: Malformed relay counter reply");
+        return;
+    }
+    uint32_t relays, changes;
+    if (!parse_hex(buf + 1, 2, relays) || !parse_hex(buf + 3, 8, changes) ||
+        len < REPLY_WEAR_HEADER_LEN + relays * WEAR_RELAY_TEXT_LEN) {
+        Serial.println("ERROR: Malformed relay counter reply");
+        return;
+    }
+    
+    Serial.printf("Relay operations (%lu direction changes):\n", (unsigned long)changes);
+    for (uint8_t r = 0; r < relays; r++) {
+        const uint8_t* field = buf + REPLY_WEAR_HEADER_LEN + r * WEAR_RELAY_TEXT_LEN;
+        uint32_t operations;
+        if (!parse_hex(field, 8, operations)) {
+            Serial.println("ERROR: Malformed relay counter");
+            return;
+        }
+        Serial.printf("  Relay %2d: %lu\n", r + 1, (unsigned long)operations);
+    }
+}
+
+/**
+ * @brief Print a schedule reply
+ *
+ * Format: "TXSNN" (see REPLY_SCHEDULE)
+ *
+ * @param buf Reply buffer
+ * @param len Reply length (time-sync trailer already removed)
+ */
+void process_schedule_reply(const uint8_t* buf, uint8_t len) {
+    static const char* const status_text[] = {"OK", "queue full", "time past or too far ahead"};
+    uint32_t queued;
+    if (len < REPLY_SCHED_LEN || buf[2] < '0' || buf[2] > '2' || !parse_hex(buf + 3, 2, queued)) {
+        Serial.println("ERROR: Malformed schedule reply");
+        return;
+    }
+    Serial.printf("Schedule %c: %s, %lu queued\n", buf[1], status_text[buf[2] - '0'],
+                  (unsigned long)queued);
+}
+
+/**
+ * @brief Print confirmations of scheduled changes and follow the direction
+ *
+ * Format: "XN" + N x "DTTTTTTTTLLLLR" (see REPLY_SCHED_REPORT). Times are
+ * printed on the controller's timebase.
+ *
+ * @param buf Frame
+ * @param len Frame length
+ */
+void process_schedule_report(const uint8_t* buf, uint8_t len) {
+    uint32_t count;
+    if (len < 2 || !parse_hex(buf + 1, 1, count) || len < 2 + count * SCHED_REPORT_TEXT_LEN) {
+        Serial.println("ERROR: Malformed schedule confirmation");
+        return;
+    }
+    
+    int direction = -1;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* field = buf + 2 + i * SCHED_REPORT_TEXT_LEN;
+        int d = field[0] - '0';
+        uint32_t due_ms, late;
+        char result = field[13];
+        if (d < 0 || d >= NUM_DIRECTIONS || !parse_hex(field + 1, 8, due_ms) ||
+            !parse_hex(field + 9, 4, late)) {
+            Serial.println("ERROR: Malformed schedule confirmation");
+            continue;
+        }
+        int16_t late_us = (int16_t)late;
+        
+        Serial.printf("Scheduled %s @%lu: %s, %d us late\n", DIRECTION_NAMES[d],
+                      (unsigned long)timesync_phaser_to_local(due_ms),
+                      (result == 'A') ? "switched" :
+                      (result == 'H') ? "held for RF" : "protection trip", late_us);
+        if (result == 'A') {
+            direction = d;
+        }
+    }
+    
+    if (direction >= 0 && direction != current_direction) {
+        current_direction = direction;
+        gpio_show_led(current_direction);
+        Serial.printf("Direction: %s\n", DIRECTION_NAMES[direction]);
+    }
+}
+
+/**
+ * @brief Print one history record on the controller's timebase
+ *
+ * @param tier History tier the record came from
+ * @param rec Record to print
+ */
+void print_history_record(uint8_t tier, const BulkRecord& rec) {
+    
+    Serial.printf("H%d @%lu %s%s", tier,
+                  (unsigned long)timesync_phaser_to_local(rec.start_ms),
+                  DIRECTION_NAMES[rec.direction & 0x07],
+                  (rec.direction & 0x08) ? "*" : "");
+    for (int c = 0; c < HISTORY_NUM_CHANNELS; c++) {
+        Serial.printf(" %s %d/%d/%d", HISTORY_CHANNEL_NAMES[c],
+                      rec.min[c], rec.max[c], rec.mean[c]);
+    }
+    Serial.println();
+}
+
+/**
+ * @brief Record the session announced by a bulk download reply
+ *
+ * Format: "BTSSCCLLLLLLLLM" (see REPLY_BULK)
+ *
+ * @param buf Reply buffer
+ * @param len Reply length (time-sync trailer already removed)
+ */
+void process_bulk_reply(const uint8_t* buf, uint8_t len) {
+    bulk_session_valid = false;
+    if (len < REPLY_BULK_LEN || buf[1] < '0' || buf[1] >= '0' + HISTORY_NUM_TIERS) {
+        Serial.println("ERROR: Malformed bulk reply");
+        return;
+    }
+    
+    uint32_t session_id, chunk_total, last_start_ms;
+    if (!parse_hex(buf + 2, 2, session_id) || !parse_hex(buf + 4, 2, chunk_total) ||
+        !parse_hex(buf + 6, 8, last_start_ms)) {
+        Serial.println("ERROR: Malformed bulk reply");
+        return;
+    }
+    bulk_tier = buf[1] - '0';
+    bulk_session_id = session_id;
+    bulk_chunk_total = chunk_total;
+    bulk_last_start_ms = last_start_ms;
+    bulk_more_pending = (buf[14] == '1');
+    bulk_received_mask = 0;
+    bulk_session_valid = (bulk_chunk_total <= 16);
+    
+    Serial.printf("Bulk session %02X: tier %d, %d chunks%s\n", bulk_session_id,
+                  bulk_tier, bulk_chunk_total, bulk_more_pending ? ", more to follow" : "");
+}
+
+/**
+ * @brief Decode one bulk data chunk in place
+ *
+ * Records are decoded directly from the receive buffer; chunks are
+ * self-contained so order of arrival does not matter. Duplicates and
+ * chunks of other sessions are ignored.
+ *
+ * @param buf Chunk as received
+ * @param len Chunk length
+ */
+void process_bulk_chunk(const uint8_t* buf, uint8_t len) {
+    BulkChunkDecoder decoder(buf, len);
+    if (!decoder.ok() || decoder.header().session != bulk_session_id ||
+        decoder.header().index >= 16) {
+        DEBUG_PRINTLN("Ignoring stray bulk chunk");
+        return;
+    }
+    
+    uint16_t bit = 1U << decoder.header().index;
+    if (bulk_received_mask & bit) {
+        return;  // Already have it
+    }
+    
+    if (BULK_ECHO_RAW) {
+        // Raw chunk for host-side decoding (tools/bulk_decode)
+        Serial.print("BULK ");
+        for (uint8_t i = 0; i < len; i++) {
+            Serial.printf("%02X", buf[i]);
+        }
+        Serial.println();
+    }
+    
+    BulkRecord rec;
+    while (decoder.next(rec)) {
+        print_history_record(decoder.header().tier, rec);
+    }
+    if (!decoder.ok()) {
+        Serial.printf("ERROR: Bulk chunk %d malformed\n", decoder.header().index);
+        return;
+    }
+    
+    bulk_received_mask |= bit;
+    DEBUG_PRINTF("Bulk chunk %d: %d bytes\n", decoder.header().index, len);
+}
+
+/**
+ * @brief Parse direction from reply
+ *
+ * Extracts direction number from phaser reply.
+ *
+ * @param buf Reply buffer
+ * @return Direction (0-7) or current_direction if parse error
+ */
+Direction parse_direction_from_reply(const uint8_t* buf) {
+    if (buf[0] == ';' && buf[1] >= '0' && buf[1] <= '7') {
+        return (Direction)(buf[1] - '0');
+    }
+    return (Direction)current_direction;
+}
+
+/**
+ * @brief Display telemetry data on OLED screen
+ *
+ * Shows antenna position, voltage, current, signal strength, and power data.
+ *
+ * @param buf Reply buffer from phaser
+ * @param len Length of reply data
+ */
+void display_telemetry(const uint8_t* buf, uint8_t len) {
+  board.display_show_telemetry(buf, len, last_rev_power, DIRECTION_NAMES[current_direction]);
+}
+
+// ============================================================================
+// TRANSACTION FLOWS
+// ============================================================================
+
+/** @brief Direction sweep (see flow_sweep()) */
+struct Sweep {
+    Flow flow;
+    Flow step;                     /**< flow_visit() of the direction being visited */
+    bool active;
+    uint8_t start;                 /**< Direction to return to */
+    uint8_t next;                  /**< Direction being visited */
+    uint16_t swr_x100[NUM_DIRECTIONS];  /**< 0 = no carrier or no reply */
+};
+
+Sweep sweep = {};
+
+/**
+ * @brief Direction reported by the last position reply
+ *
+ * @return Direction (0-7), or -1 if there is none or its angle is unknown
+ */
+static int reply_direction(void) {
+    if (last_reply == NULL || last_reply->len < 4) {
+        return -1;
+    }
+    uint32_t angle = parse_dec(last_reply->data + 1, 3);
+    for (int i = 0; i < NUM_DIRECTIONS; i++) {
+        if ((uint32_t)DIRECTION_ANGLES[i] == angle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Flow: switch to a direction, confirm it, then read power and SWR
+ *
+ * @param f Flow record
+ * @param direction Direction (0-7)
+ * @return FLOW_DONE, FLOW_FAILED, or FLOW_WAITING while in progress
+ */
+FlowStatus flow_visit(Flow& f, uint8_t direction) {
+    FLOW_BEGIN(f);
+    
+    packet_pool.release(last_reply);  // Confirm from this reply only
+    {
+        Command cmd;
+        build_direction_command(direction, cmd);
+        if (!exchange_start(cmd)) FLOW_FAIL(f);
+    }
+    FLOW_WAIT_UNTIL(f, exchange_poll() != EXCHANGE_PENDING);
+    if (exchange.status != EXCHANGE_DONE || reply_direction() != direction) {
+        Serial.printf("Sweep: switch to %s not confirmed\n", DIRECTION_NAMES[direction]);
+        FLOW_FAIL(f);
+    }
+    current_direction = direction;
+    
+    FLOW_DELAY(f, SWEEP_DWELL_MS);
+    
+    last_swr_x100 = 0;
+    {
+        Command cmd;
+        build_ptt_command(cmd);
+        if (!exchange_start(cmd)) FLOW_FAIL(f);
+    }
+    FLOW_WAIT_UNTIL(f, exchange_poll() != EXCHANGE_PENDING);
+    if (exchange.status != EXCHANGE_DONE) FLOW_FAIL(f);
+    
+    FLOW_END(f);
+}
+
+/**
+ * @brief Flow: visit every direction, report SWR per direction, go back
+ *
+ * Starts with a position query, which checks that the phaser answers and
+ * gives the direction to return to.
+ *
+ * @param f Flow record
+ * @return FLOW_DONE, FLOW_FAILED, or FLOW_WAITING while in progress
+ */
+FlowStatus flow_sweep(Flow& f) {
+    FLOW_BEGIN(f);
+    
+    packet_pool.release(last_reply);
+    {
+        Command cmd;
+        build_position_query(cmd);
+        if (!exchange_start(cmd)) FLOW_FAIL(f);
+    }
+    FLOW_WAIT_UNTIL(f, exchange_poll() != EXCHANGE_PENDING);
+    if (exchange.status != EXCHANGE_DONE || reply_direction() < 0) {
+        Serial.println("Sweep: no position reply from phaser");
+        FLOW_FAIL(f);
+    }
+    sweep.start = (uint8_t)reply_direction();
+    
+    for (sweep.next = 0; sweep.next < NUM_DIRECTIONS; sweep.next++) {
+        FLOW_CALL(f, sweep.step, flow_visit(sweep.step, sweep.next));
+        sweep.swr_x100[sweep.next] = (f.result == FLOW_DONE) ? last_swr_x100 : 0;
+    }
+    FLOW_CALL(f, sweep.step, flow_visit(sweep.step, sweep.start));
+    
+    Serial.println("Sweep results:");
+    for (sweep.next = 0; sweep.next < NUM_DIRECTIONS; sweep.next++) {
+        uint16_t swr = sweep.swr_x100[sweep.next];
+        if (swr) {
+            Serial.printf("  %-2s %3d°  SWR %u.%02u:1\n", DIRECTION_NAMES[sweep.next],
+                          DIRECTION_ANGLES[sweep.next], swr / 100, swr % 100);
+        } else {
+            Serial.printf("  %-2s %3d°  --\n", DIRECTION_NAMES[sweep.next],
+                          DIRECTION_ANGLES[sweep.next]);
+        }
+    }
+    
+    FLOW_END(f);
+}
+
+/**
+ * @brief Advance the running flows; call from every pass of loop()
+ */
+void flows_run(void) {
+    if (sweep.active) {
+        FlowStatus status = flow_sweep(sweep.flow);
+        if (status != FLOW_WAITING) {
+            sweep.active = false;
+            Serial.printf("Sweep %s\n", (status == FLOW_DONE) ? "complete" : "failed");
+        }
+    }
+}
+
+/**
+ * @brief Abandon the running flows (a user command takes the radio)
+ */
+void flows_cancel(void) {
+    if (sweep.active) {
+        sweep.active = false;
+        Serial.println("Sweep cancelled");
+    }
+}
+
+// ============================================================================
+// USER INPUT HANDLING
+// ============================================================================
+
+/**
+ * @brief Handle button press on GPIO expander
+ *
+ * @param button Button index (0-7)
+ */
+void handle_button_press(int button) {
+  if (button < 0 || button >= NUM_DIRECTIONS) return;
+  if (button == last_button_pressed) return;  // Ignore same button
+  
+  Serial.printf("Button %d pressed: %s\n", button, DIRECTION_NAMES[button]);
+  
+  // Turn off prev LED, turn on new LED
+  gpio_show_led(button);
+  
+  // Send direction command
+  build_direction_command(button, current_command);
+  send_and_process_command(current_command);
+  
+  last_button_pressed = button;
+}
+
+/**
+ * @brief Handle PTT button press
+ *
+ * PTT sends a telemetry request command ('V')
+ */
+void handle_ptt_press(void) {
+  Serial.println("PTT pressed: requesting reverse power telemetry");
+  
+  build_ptt_command(current_command);
+  send_and_process_command(current_command);
+}
+
+/**
+ * @brief Download telemetry history from the phaser
+ *
+ * Pages through a tier one LoRa frame at a time, starting after the last
+ * record previously received, until the phaser has nothing newer or
+ * HISTORY_MAX_CHUNKS frames have been fetched. Use after a link outage to
+ * see what happened on the tower.
+ *
+ * @param tier History tier (0 = 1 s, 1 = 1 min, 2 = 15 min)
+ */
+void handle_history_request(uint8_t tier) {
+  if (tier >= HISTORY_NUM_TIERS) return;
+  
+  Serial.printf("Fetching history tier %d\n", tier);
+  for (int chunk = 0; chunk < HISTORY_MAX_CHUNKS; chunk++) {
+    build_history_command(CMD_HISTORY, tier, history_cursor[tier], current_command);
+    if (!send_and_process_command(current_command) || last_history_count == 0) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Receive streamed bulk chunks until complete or the stream stalls
+ *
+ * Chunks arrive as plain (unacknowledged) datagrams straight after the
+ * phaser's 'B' or 'R' reply.
+ */
+void receive_bulk_chunks(void) {
+  Packet* chunk = alloc_packet(PACKET_CODEC);
+  if (chunk == NULL) {
+    return;
+  }
+  uint16_t all = (bulk_chunk_total >= 16) ? 0xFFFF : (uint16_t)((1U << bulk_chunk_total) - 1);
+  
+  while ((bulk_received_mask & all) != all) {
+    if (!board.radio_wait(BULK_CHUNK_TIMEOUT_MS)) {
+      break;
+    }
+    chunk->len = PACKET_MTU;
+    uint8_t from;
+    if (board.radio_receive_raw(chunk->data, chunk->len, from) && from == DEST_ADDRESS) {
+      process_bulk_chunk(chunk->data, chunk->len);
+    }
+  }
+  packet_pool.release(chunk);
+}
+
+/**
+ * @brief Download telemetry history using compressed bulk transfer
+ *
+ * Requests a session, collects the streamed chunks, asks for just the
+ * missing ones up to BULK_MAX_RETRIES times, and continues with follow-up
+ * sessions while the phaser reports more records.
+ *
+ * @param tier History tier (0 = 1 s, 1 = 1 min, 2 = 15 min)
+ */
+void handle_bulk_request(uint8_t tier) {
+  if (tier >= HISTORY_NUM_TIERS) return;
+  
+  for (int session = 0; session < BULK_MAX_SESSIONS; session++) {
+    build_history_command(CMD_BULK, tier, history_cursor[tier], current_command);
+    bulk_session_valid = false;
+    if (!send_and_process_command(current_command) || !bulk_session_valid) {
+      return;
+    }
+    if (bulk_chunk_total == 0) {
+      Serial.println("Bulk download complete");
+      return;
+    }
+    
+    uint16_t all = (bulk_chunk_total >= 16) ? 0xFFFF : (uint16_t)((1U << bulk_chunk_total) - 1);
+    receive_bulk_chunks();
+    
+    for (int retry = 0; retry < BULK_MAX_RETRIES && (bulk_received_mask & all) != all; retry++) {
+      uint16_t missing = all & ~bulk_received_mask;
+      Serial.printf("Bulk: requesting %04X again\n", missing);
+      bulk_resend_mask = 0;
+      build_resend_command(bulk_session_id, missing, current_command);
+      if (!send_and_process_command(current_command) || bulk_resend_mask == 0) {
+        break;
+      }
+      receive_bulk_chunks();
+    }
+    
+    if ((bulk_received_mask & all) != all) {
+      Serial.println("ERROR: Bulk download incomplete");
+      return;
+    }
+    
+    history_cursor[tier] = bulk_last_start_ms;
+    if (!bulk_more_pending) {
+      Serial.println("Bulk download complete");
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Send a reverse power calibration command typed on serial
+ *
+ * Accepts CB, CE, CA, CQ, CD, or CP<watts> (e.g. CP25.5) where watts is
+ * the reflected power shown on a reference wattmeter while a steady
+ * carrier is transmitted into the current direction.
+ *
+ * @param text Serial input starting with 'C'
+ */
+void handle_calibration_request(const char* text) {
+  char sub = toupper(text[1]);
+  uint16_t ref_dw = 0;
+  
+  if (sub == CAL_SUB_POINT) {
+    float watts = atof(text + 2);
+    if (watts < 0.0f || watts > 6553.5f) {
+      Serial.println("Reference power must be 0-6553.5 W");
+      return;
+    }
+    ref_dw = (uint16_t)lroundf(watts * 10.0f);
+  } else if (sub == '\0' || text[2] != '\0' || strchr("BEAQD", sub) == NULL) {
+    Serial.println("Calibration: CB begin, CP<watts> point, CE save, CA abort, CQ query, "
+                   "CD default");
+    return;
+  }
+  
+  build_calibration_command(sub, ref_dw, current_command);
+  send_and_process_command(current_command);
+}
+
+/**
+ * @brief Request sensor statistics typed on serial
+ *
+ * @param scope STATS_SUB_ALL, STATS_SUB_RESET or a direction digit
+ */
+void handle_stats_request(char scope) {
+  build_stats_command(scope, current_command);
+  send_and_process_command(current_command);
+}
+
+/**
+ * @brief Request relay operation counters typed on serial
+ *
+ * @param text "OQ", or "OZ<n>" to restart relay n's count after replacing it
+ */
+void handle_wear_request(const char* text) {
+  uint8_t clear_relay = 0;
+  if (toupper(text[1]) == WEAR_SUB_CLEAR) {
+    int relay = atoi(text + 2);
+    if (relay < 1 || relay > 99) {
+      Serial.println("Usage: OQ, or OZ<relay 1-99>");
+      return;
+    }
+    clear_relay = (uint8_t)relay;
+  } else if (toupper(text[1]) != WEAR_SUB_QUERY || text[2] != '\0') {
+    Serial.println("Usage: OQ, or OZ<relay 1-99>");
+    return;
+  }
+  
+  build_wear_command(clear_relay, current_command);
+  send_and_process_command(current_command);
+}
+
+/**
+ * @brief Schedule a direction change typed on serial
+ *
+ * @param text "TQ", "TC", or "T<direction>+<seconds>" (e.g. TNE+30) to
+ *             switch that many seconds from now on the phaser's clock
+ */
+void handle_schedule_request(const char* text) {
+  char sub = toupper(text[1]);
+  if ((sub == SCHED_SUB_QUERY || sub == SCHED_SUB_CLEAR) && text[2] == '\0') {
+    build_schedule_command(sub, 0, 0, current_command);
+    send_and_process_command(current_command);
+    return;
+  }
+  
+  const char* plus = strchr(text, '+');
+  int direction = -1;
+  for (int i = 0; plus != NULL && i < NUM_DIRECTIONS; i++) {
+    if ((size_t)(plus - text - 1) == strlen(DIRECTION_NAMES[i]) &&
+        strncasecmp(text + 1, DIRECTION_NAMES[i], plus - text - 1) == 0) {
+      direction = i;
+      break;
+    }
+  }
+  if (direction < 0 || !isdigit(plus[1])) {
+    Serial.println("Usage: TQ, TC, or T<direction>+<seconds>");
+    return;
+  }
+  if (!timesync_valid()) {
+    Serial.println("No phaser clock estimate yet; query the phaser first");
+    return;
+  }
+  
+  uint32_t local_ms = millis() + (uint32_t)atol(plus + 1) * 1000UL;
+  build_schedule_command(SCHED_SUB_ADD, timesync_local_to_phaser(local_ms), direction,
+                         current_command);
+  send_and_process_command(current_command);
+}
+
+/**
+ * @brief Switch the phaser to a relay map profile
+ *
+ * The phaser re-applies the current direction from the new profile
+ * before it replies, so one exchange leaves the array ready. A profile
+ * the phaser does not have is not asked for again until the next select.
+ *
+ * @param profile Profile (0-15)
+ */
+void select_profile(int profile) {
+  wanted_profile = profile;
+  profile_refused = false;
+  last_profile_send_ms = millis();
+  
+  build_profile_command((uint8_t)profile, current_command);
+  if (send_and_process_command(current_command) && phaser_profile >= 0 &&
+      phaser_profile != profile) {
+    Serial.printf("ERROR: Phaser has no relay map profile %d\n", profile);
+    display_message("NO PROFILE");
+    profile_refused = true;
+  }
+}
+
+/**
+ * @brief Select a relay map profile typed on serial
+ *
+ * Stays in use until the band data changes.
+ *
+ * @param text "P<n>" (n = 0-15)
+ */
+void handle_profile_request(const char* text) {
+  char* end;
+  long profile = strtol(text + 1, &end, 10);
+  if (end == text + 1 || *end != '\0' || profile < 0 || profile > 15) {
+    Serial.println("Usage: P<profile 0-15>");
+    return;
+  }
+  select_profile((int)profile);
+}
+
+/**
+ * @brief Follow the transceiver band data
+ *
+ * Called every pass of loop(). A code must read the same for
+ * BAND_DEBOUNCE_MS (the BCD lines do not all change on the same
+ * instant) before its profile is selected. Also selects the wanted
+ * profile again if the phaser reports another one, e.g. after it
+ * restarted, at most every BAND_RETRY_MS.
+ */
+void poll_band_data(void) {
+#if BAND_DATA_ENABLED
+  int code = (board.pin_read(BAND_DATA_PIN_A) == HIGH ? 1 : 0) |
+             (board.pin_read(BAND_DATA_PIN_B) == HIGH ? 2 : 0) |
+             (board.pin_read(BAND_DATA_PIN_C) == HIGH ? 4 : 0) |
+             (board.pin_read(BAND_DATA_PIN_D) == HIGH ? 8 : 0);
+  if (BAND_DATA_ACTIVE_LOW) {
+    code ^= 0x0F;
+  }
+  
+  uint32_t now = millis();
+  if (code != band_pending_code) {
+    band_pending_code = code;
+    band_pending_since_ms = now;
+  }
+  if (code != band_code && now - band_pending_since_ms >= BAND_DEBOUNCE_MS) {
+    band_code = code;
+    Serial.printf("Band data %d: %s\n", code, BAND_NAMES[code]);
+    if (BAND_PROFILES[code] != BAND_PROFILE_NONE && BAND_PROFILES[code] != wanted_profile) {
+      display_message(BAND_NAMES[code]);
+      select_profile(BAND_PROFILES[code]);
+    }
+    return;
+  }
+#endif
+  
+  if (wanted_profile >= 0 && phaser_profile >= 0 && phaser_profile != wanted_profile &&
+      !profile_refused && millis() - last_profile_send_ms >= BAND_RETRY_MS) {
+    Serial.printf("Phaser on relay map profile %d, selecting %d again\n",
+                  phaser_profile, wanted_profile);
+    select_profile(wanted_profile);
+  }
+}
+
+/**
+ * @brief Start a sweep of all directions (serial "SWEEP")
+ *
+ * Runs in the background from loop(); any direction or other command
+ * cancels it.
+ */
+void handle_sweep_request(void) {
+  if (sweep.active) {
+    Serial.println("Sweep already running");
+    return;
+  }
+  memset(sweep.swr_x100, 0, sizeof(sweep.swr_x100));
+  FLOW_INIT(sweep.flow);
+  sweep.active = true;
+  Serial.println("Sweep started");
+}
+
+/**
+ * @brief Handle serial input for remote control
  *
  * Allows entering commands from serial terminal:
  * - Enter direction strings: N, NE, E, SE, S, SW, W, NW
  * - Or angles: 000, 045, 090, 135, 180, 225, 270, 315
+ * - Or H0, H1, H2 to download telemetry history of that tier
+ * - Or B0, B1, B2 to download it with compressed bulk transfer
+ * - Or CB, CP<watts>, CE, CA, CQ, CD for reverse power calibration
+ * - Or SA, S0-S7, SR for sensor statistics (all, per direction, reset)
+ * - Or L to make the phaser relearn its relay coil currents
+ * - Or OQ for relay operation counters, OZ<n> to restart relay n's count
+ * - Or T<direction>+<seconds> to schedule a change, TQ / TC to query / clear
+ * - Or SWEEP to step through every direction and report SWR for each
+ * - Or RADIO for the radio FIFO timings (receive latency, transmit load)
  */
 void handle_serial_input(void) {
   static char serial_buffer[10];
@@ -457,6 +1808,83 @@ void handle_serial_input(void) {
       if (serial_index > 0) {
         serial_buffer[serial_index] = '\0';
         
+        // History download: H0, H1, H2
+        if ((serial_buffer[0] == 'H' || serial_buffer[0] == 'h') &&
+            isdigit(serial_buffer[1]) && serial_buffer[2] == '\0') {
+          handle_history_request(serial_buffer[1] - '0');
+          serial_index = 0;
+          continue;
+        }
+        
+        // Compressed bulk history download: B0, B1, B2
+        if ((serial_buffer[0] == 'B' || serial_buffer[0] == 'b') &&
+            isdigit(serial_buffer[1]) && serial_buffer[2] == '\0') {
+          handle_bulk_request(serial_buffer[1] - '0');
+          serial_index = 0;
+          continue;
+        }
+        
+        // Reverse power calibration: CB, CP<watts>, CE, CA, CQ, CD
+        if (serial_buffer[0] == 'C' || serial_buffer[0] == 'c') {
+          handle_calibration_request(serial_buffer);
+          serial_index = 0;
+          continue;
+        }
+        
+        // Relearn relay coil currents: L
+        if ((serial_buffer[0] == 'L' || serial_buffer[0] == 'l') && serial_buffer[1] == '\0') {
+          current_command.data[0] = CMD_RELEARN;
+          current_command.length = 1;
+          send_and_process_command(current_command);
+          serial_index = 0;
+          continue;
+        }
+        
+        // Scheduled direction changes: T<direction>+<seconds>, TQ, TC
+        if (serial_buffer[0] == 'T' || serial_buffer[0] == 't') {
+          handle_schedule_request(serial_buffer);
+          serial_index = 0;
+          continue;
+        }
+        
+        // Relay map profile: P<n>
+        if (serial_buffer[0] == 'P' || serial_buffer[0] == 'p') {
+          handle_profile_request(serial_buffer);
+          serial_index = 0;
+          continue;
+        }
+        
+        // Relay operation counters: OQ, OZ<n>
+        if (serial_buffer[0] == 'O' || serial_buffer[0] == 'o') {
+          handle_wear_request(serial_buffer);
+          serial_index = 0;
+          continue;
+        }
+        
+        // Direction sweep: SWEEP
+        if (strcasecmp(serial_buffer, "SWEEP") == 0) {
+          handle_sweep_request();
+          serial_index = 0;
+          continue;
+        }
+        
+        // Radio FIFO timings: RADIO
+        if (strcasecmp(serial_buffer, "RADIO") == 0) {
+          board.radio().timing_print(Serial);
+          serial_index = 0;
+          continue;
+        }
+        
+        // Sensor statistics: SA, S0-S7, SR (plain S is South)
+        if ((serial_buffer[0] == 'S' || serial_buffer[0] == 's') && serial_buffer[2] == '\0' &&
+            (toupper(serial_buffer[1]) == STATS_SUB_ALL ||
+             toupper(serial_buffer[1]) == STATS_SUB_RESET ||
+             (serial_buffer[1] >= '0' && serial_buffer[1] < '0' + NUM_DIRECTIONS))) {
+          handle_stats_request(toupper(serial_buffer[1]));
+          serial_index = 0;
+          continue;
+        }
+        
         // Parse direction name or angle
         int direction = -1;
         
@@ -501,40 +1929,22 @@ void handle_serial_input(void) {
   }
 }
 
-// ============================================================================
-// DISPLAY HELPERS
-// ============================================================================
-
-/**
- * @brief Display a short status message
- *
- * @param message Message to display (clears after display)
- */
-void display_message(const char* message) {
-  display.clearDisplay();
-  display.setTextSize(2);
-  display.setCursor(0, 25);
-  display.println(message);
-  display.display();
-  delay(1000);
-}
-
-
 // ============================================================================
 // MAIN SETUP AND LOOP
 // ============================================================================
 
 void setup() {
   init_all_hardware();
+  timesync_reset();
 }
 
 void loop() {
   // Check PTT button (highest priority)
-  if (debounce_pin(PTT_PIN, LOW)) {
+  if (ptt_pressed()) {
     handle_ptt_press();
     
     // Stay in loop while PTT held to prevent hotswitch
-    while (debounce_pin(PTT_PIN, LOW)) {
+    while (ptt_pressed()) {
       delay(10);
     }
     delay(100);  // Debounce release
@@ -542,12 +1952,12 @@ void loop() {
   
   // Check direction buttons on GPIO expander
   for (int i = 0; i < NUM_DIRECTIONS; i++) {
-    if (!mcp.digitalRead(BUTTON_PIN_START + i)) {  // Button pressed (active LOW)
+    if (gpio_read_button(i)) {
       handle_button_press(i);
       delay(50);  // Debounce
       
       // Wait for release
-      while (!mcp.digitalRead(BUTTON_PIN_START + i)) {
+      while (gpio_read_button(i)) {
         delay(10);
       }
       delay(100);  // Debounce release
@@ -557,37 +1967,16 @@ void loop() {
   // Check for serial input
   handle_serial_input();
   
-  // Small delay to prevent CPU spinning
-  delay(10);
-}
-
-// ============================================================================
-// UTILITY FUNCTIONS
-// ============================================================================
-
-/**
- * @brief Debounce a digital input pin
- *
- * Waits for pin to be stable at target level for DEBOUNCE_DELAY_MS.
- * Returns immediately if pin changes during waiting.
- *
- * @param pin Pin to read
- * @param target_level Target level (HIGH or LOW)
- * @return true if pin stabilized at target level
- */
-bool debounce_pin(int pin, int target_level) {
-  int current_level = digitalRead(pin);
+  // Transceiver band changes select the phaser's relay map profile
+  poll_band_data();
   
-  for (int i = 0; i < DEBOUNCE_DELAY_MS; i++) {
-    delay(1);
-    int new_level = digitalRead(pin);
-    
-    if (new_level != current_level) {
-      return false;  // Level changed, not stable
-    }
-  }
+  // Protection events sent by the phaser between commands
+  poll_phaser_events();
+  
+  // Multi-step transactions (sweep), one step per pass
+  exchange_poll();
+  flows_run();
   
-  // Pin stabilized, return whether it matches target
-  return (digitalRead(pin) == target_level);
+  // Small delay to prevent CPU spinning
+  delay(10);
 }
-
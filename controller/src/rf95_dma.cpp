@@ -0,0 +1,152 @@
+/**
+ * @file rf95_dma.cpp
+ * @brief RFM95 driver with DMA FIFO bursts and FIFO timing
+ *
+ * A burst is the FIFO address byte, sent with an ordinary transfer, then
+ * len data bytes clocked by two DMA channels on the SERCOM4 triggers: the
+ * transmit channel writes DATA on every data-register-empty, the receive
+ * channel reads DATA on every receive-complete. A write discards what it
+ * receives into one dummy byte and a read sends zeros from another. The
+ * receive channel finishes last, so waiting for it waits for the bus.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "dma.h"
+#include "fast_gpio.h"
+#include "rf95_dma.h"
+
+/** @brief Sent while reading, and the sink for bytes received while writing */
+static const uint8_t fifo_fill = 0;
+static volatile uint8_t fifo_sink;
+
+Rf95Dma::Rf95Dma(uint8_t cs, uint8_t irq)
+    : RH_RF95(cs, irq), cs_pin(cs), irq_start_us(0), irq_pending(false) {
+    timing_reset();
+}
+
+bool Rf95Dma::init(void) {
+    _spi.setFrequency(RF95_SPI_FREQUENCY);
+#if RF95_SPI_DMA
+    dma_init();
+    dma_channel_setup(DMA_CH_RADIO_RX, SERCOM4_DMAC_ID_RX, DMAC_CHCTRLB_TRIGACT_BEAT, nullptr);
+    dma_channel_setup(DMA_CH_RADIO_TX, SERCOM4_DMAC_ID_TX, DMAC_CHCTRLB_TRIGACT_BEAT, nullptr);
+#endif
+    return RH_RF95::init();
+}
+
+void Rf95Dma::timing_reset(void) {
+    memset(&rx_timing, 0, sizeof(rx_timing));
+    memset(&tx_timing, 0, sizeof(tx_timing));
+}
+
+void Rf95Dma::timing_print(Print& out) const {
+    const Rf95Timing* t[2] = {&rx_timing, &tx_timing};
+    out.printf("RFM95 FIFO (%s): ", RF95_SPI_DMA ? "DMA" : "byte loop");
+    for (uint8_t i = 0; i < 2; i++) {
+        out.printf("%s %lu frames, %lu/%lu/%lu us min/avg/max%s", i ? "tx load" : "rx latency",
+                   (unsigned long)t[i]->count, (unsigned long)t[i]->min_us,
+                   (unsigned long)(t[i]->count ? t[i]->total_us / t[i]->count : 0),
+                   (unsigned long)t[i]->max_us, i ? "\n" : "; ");
+    }
+}
+
+void Rf95Dma::record(Rf95Timing& t, uint32_t us) {
+    if (t.count == 0 || us < t.min_us) {
+        t.min_us = us;
+    }
+    if (us > t.max_us) {
+        t.max_us = us;
+    }
+    t.count++;
+    t.total_us += us;
+}
+
+// ============================================================================
+// SPI OVERRIDES
+// ============================================================================
+
+uint8_t Rf95Dma::spiRead(uint8_t reg) {
+    // The interrupt handler reads the IRQ flags before anything else
+    if (reg == RH_RF95_REG_12_IRQ_FLAGS) {
+        irq_start_us = micros();
+        irq_pending = true;
+    }
+    return RH_RF95::spiRead(reg);
+}
+
+uint8_t Rf95Dma::spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len) {
+#if RF95_SPI_DMA
+    ATOMIC_BLOCK_START;
+    _spi.beginTransaction();
+    cs_pin.low();
+    uint8_t status = _spi.transfer(reg & ~RH_SPI_WRITE_MASK);
+    fifo_transfer(dest, NULL, len);
+    cs_pin.high();
+    _spi.endTransaction();
+    ATOMIC_BLOCK_END;
+#else
+    uint8_t status = RH_RF95::spiBurstRead(reg, dest, len);
+#endif
+    if (reg == RH_RF95_REG_00_FIFO && irq_pending) {
+        irq_pending = false;
+        record(rx_timing, micros() - irq_start_us);
+    }
+    return status;
+}
+
+uint8_t Rf95Dma::spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len) {
+    uint32_t start_us = micros();
+#if RF95_SPI_DMA
+    ATOMIC_BLOCK_START;
+    _spi.beginTransaction();
+    cs_pin.low();
+    uint8_t status = _spi.transfer(reg | RH_SPI_WRITE_MASK);
+    fifo_transfer(NULL, src, len);
+    cs_pin.high();
+    _spi.endTransaction();
+    ATOMIC_BLOCK_END;
+#else
+    uint8_t status = RH_RF95::spiBurstWrite(reg, src, len);
+#endif
+    if (reg == RH_RF95_REG_00_FIFO) {
+        record(tx_timing, micros() - start_us);
+    }
+    return status;
+}
+
+// ============================================================================
+// DMA BURST
+// ============================================================================
+
+void Rf95Dma::fifo_transfer(uint8_t* dest, const uint8_t* src, uint8_t len) {
+    if (len == 0) {
+        return;
+    }
+    volatile uint32_t* data = &SERCOM4->SPI.DATA.reg;
+
+    DmacDescriptor* rx = dma_descriptor(DMA_CH_RADIO_RX);
+    rx->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE |
+                     (dest ? DMAC_BTCTRL_DSTINC : 0);
+    rx->BTCNT.reg = len;
+    rx->SRCADDR.reg = (uintptr_t)data;
+    rx->DSTADDR.reg = dest ? (uintptr_t)(dest + len) : (uintptr_t)&fifo_sink;  // End address
+    rx->DESCADDR.reg = 0;
+
+    DmacDescriptor* tx = dma_descriptor(DMA_CH_RADIO_TX);
+    tx->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE | (src ? DMAC_BTCTRL_SRCINC : 0);
+    tx->BTCNT.reg = len;
+    tx->SRCADDR.reg = src ? (uintptr_t)(src + len) : (uintptr_t)&fifo_fill;   // End address
+    tx->DSTADDR.reg = (uintptr_t)data;
+    tx->DESCADDR.reg = 0;
+
+    // Receiver first, so it is armed for the first byte clocked out
+    dma_channel_enable(DMA_CH_RADIO_RX);
+    dma_channel_enable(DMA_CH_RADIO_TX);
+    dma_channel_wait(DMA_CH_RADIO_RX);
+    dma_channel_wait(DMA_CH_RADIO_TX);
+}
@@ -0,0 +1,195 @@
+/**
+ * @file timesync.cpp
+ * @brief Controller/phaser clock synchronisation
+ *
+ * Offset/delay per exchange follow NTP:
+ *   delay  = (T4 - T1) - (T3 - T2)
+ *   offset = ((T2 - T1) + (T3 - T4)) / 2
+ *
+ * Accepted samples steer a phase reference (where the phaser clock is now)
+ * and, at most every TIMESYNC_DRIFT_MIN_SPAN_MS, a frequency estimate (how
+ * fast it is walking away from ours).
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "protocol.h"
+#include "timesync.h"
+#include "reply_fields.h"
+
+// ============================================================================
+// SYNC STATE
+// ============================================================================
+
+/** @brief True once the first exchange has been accepted */
+static bool sync_valid = false;
+
+/** @brief Local time of the phase reference */
+static uint32_t ref_local_ms = 0;
+
+/** @brief Phaser-minus-local offset at ref_local_ms */
+static int32_t ref_offset_ms = 0;
+
+/** @brief True once a frequency anchor has been taken */
+static bool anchor_valid = false;
+
+/** @brief Local time of the frequency anchor */
+static uint32_t anchor_local_ms = 0;
+
+/** @brief Measured offset at the frequency anchor */
+static int32_t anchor_offset_ms = 0;
+
+/** @brief True once a drift estimate exists */
+static bool drift_valid = false;
+
+/** @brief Drift of phaser clock relative to ours (parts per billion) */
+static int32_t drift_ppb = 0;
+
+/** @brief Smallest round trip seen; slowly relaxed so it can track a slower link */
+static int32_t min_delay_ms = INT32_MAX;
+
+/** @brief Round trip of the last accepted sample */
+static int32_t last_delay_ms = 0;
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void timesync_reset(void) {
+    sync_valid = false;
+    anchor_valid = false;
+    drift_valid = false;
+    drift_ppb = 0;
+    min_delay_ms = INT32_MAX;
+    last_delay_ms = 0;
+}
+
+int32_t timesync_offset_at(uint32_t local_ms) {
+    if (!sync_valid) {
+        return 0;
+    }
+    int32_t elapsed = (int32_t)(local_ms - ref_local_ms);
+    return ref_offset_ms + (int32_t)(((int64_t)elapsed * drift_ppb) / 1000000000LL);
+}
+
+bool timesync_update(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4) {
+    int32_t delay = (int32_t)(t4 - t1) - (int32_t)(t3 - t2);
+    if (delay < -TIMESYNC_NEGATIVE_DELAY_MS) {
+        // Timestamps from different exchanges, not a fast one
+        DEBUG_PRINTF("timesync: rejected negative delay %ld ms\n", (long)delay);
+        return false;
+    }
+    if (delay < 0) {
+        delay = 0;  // Millisecond quantisation on a very fast exchange
+    }
+    int32_t offset = ((int32_t)(t2 - t1) + (int32_t)(t3 - t4)) / 2;
+    uint32_t mid = t1 + (t4 - t1) / 2;
+
+    // Reject exchanges stretched by retries; relax the floor a little on
+    // every rejection so a permanently slower link is eventually accepted.
+    if (min_delay_ms != INT32_MAX && delay > min_delay_ms + TIMESYNC_DELAY_TOLERANCE_MS) {
+        min_delay_ms++;
+        DEBUG_PRINTF("timesync: rejected delay %ld ms (floor %ld)\n",
+                     (long)delay, (long)min_delay_ms);
+        return false;
+    }
+    if (delay < min_delay_ms) {
+        min_delay_ms = delay;
+    }
+    last_delay_ms = delay;
+
+    if (sync_valid) {
+        int32_t error = offset - timesync_offset_at(mid);
+        if (error > TIMESYNC_STEP_MS || error < -TIMESYNC_STEP_MS) {
+            DEBUG_PRINTF("timesync: step of %ld ms, restarting\n", (long)error);
+            timesync_reset();
+            min_delay_ms = delay;
+            last_delay_ms = delay;
+        }
+    }
+
+    if (!sync_valid) {
+        ref_local_ms = mid;
+        ref_offset_ms = offset;
+        anchor_local_ms = mid;
+        anchor_offset_ms = offset;
+        anchor_valid = true;
+        sync_valid = true;
+        return true;
+    }
+
+    // Phase: move the reference halfway towards the new measurement
+    int32_t predicted = timesync_offset_at(mid);
+    ref_offset_ms = predicted + (offset - predicted) / 2;
+    ref_local_ms = mid;
+
+    // Frequency: compare against an anchor far enough back to swamp jitter
+    int32_t span = (int32_t)(mid - anchor_local_ms);
+    if (anchor_valid && span >= (int32_t)TIMESYNC_DRIFT_MIN_SPAN_MS) {
+        int32_t measured = (int32_t)(((int64_t)(offset - anchor_offset_ms) * 1000000000LL) / span);
+        if (measured <= TIMESYNC_MAX_DRIFT_PPB && measured >= -TIMESYNC_MAX_DRIFT_PPB) {
+            if (drift_valid) {
+                drift_ppb += (measured - drift_ppb) / TIMESYNC_DRIFT_GAIN;
+            } else {
+                drift_ppb = measured;
+                drift_valid = true;
+            }
+        }
+        anchor_local_ms = mid;
+        anchor_offset_ms = offset;
+    }
+
+    DEBUG_PRINTF("timesync: offset %ld ms, delay %ld ms, drift %ld ppb\n",
+                 (long)offset, (long)delay, (long)drift_ppb);
+    return true;
+}
+
+bool timesync_process_reply(const uint8_t* buf, uint8_t& len, uint32_t t1, bool t1_known,
+                            uint32_t t4, uint32_t& phaser_tx_ms) {
+    if (len < REPLY_TIME_FIELD_LEN) {
+        return false;
+    }
+    const uint8_t* field = buf + len - REPLY_TIME_FIELD_LEN;
+    if (field[0] != REPLY_FIELD_TIME) {
+        return false;
+    }
+
+    uint32_t t2, t3;
+    if (!parse_hex(field + 1, 8, t2) || !parse_hex(field + 9, 8, t3)) {
+        return false;
+    }
+
+    len -= REPLY_TIME_FIELD_LEN;
+    phaser_tx_ms = t3;
+    if (t1_known) {
+        timesync_update(t1, t2, t3, t4);
+    }
+    return true;
+}
+
+bool timesync_valid(void) {
+    return sync_valid;
+}
+
+uint32_t timesync_phaser_to_local(uint32_t phaser_ms) {
+    // One fixed-point iteration: the offset changes by at most a few ms
+    // over the difference between the two clocks.
+    uint32_t guess = phaser_ms - (uint32_t)timesync_offset_at(phaser_ms - (uint32_t)ref_offset_ms);
+    return phaser_ms - (uint32_t)timesync_offset_at(guess);
+}
+
+uint32_t timesync_local_to_phaser(uint32_t local_ms) {
+    return local_ms + (uint32_t)timesync_offset_at(local_ms);
+}
+
+int32_t timesync_drift_ppb(void) {
+    return drift_ppb;
+}
+
+int32_t timesync_last_delay_ms(void) {
+    return last_delay_ms;
+}
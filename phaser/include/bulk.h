@@ -0,0 +1,54 @@
+/**
+ * @file bulk.h
+ * @brief Compressed bulk history download sessions on the phaser
+ *
+ * A session encodes the requested slice of a history tier into
+ * bulk_codec.h chunks once, up front, into a fixed buffer. The chunks are
+ * then streamed without per-frame ACKs and any the controller reports
+ * missing are resent verbatim from the buffer, so retransmissions are
+ * byte-identical even while new history keeps arriving.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef BULK_H
+#define BULK_H
+
+#include <stdint.h>
+
+/**
+ * @brief Start a new session
+ *
+ * Encodes records of a tier that start after since_ms into chunks of at
+ * most one LoRa frame each, until the records or the buffer run out.
+ *
+ * @param tier History tier
+ * @param since_ms Send records starting after this phaser time (or
+ *                 HISTORY_SINCE_OLDEST for everything held)
+ * @return Number of chunks in the session (0 if nothing to send)
+ */
+uint8_t bulk_start(uint8_t tier, uint32_t since_ms);
+
+/** @brief Id of the current session (changes on every bulk_start()) */
+uint8_t bulk_session(void);
+
+/** @brief Chunks in the current session */
+uint8_t bulk_chunk_count(void);
+
+/** @brief Start time of the newest record in the current session */
+uint32_t bulk_last_start_ms(void);
+
+/** @brief True if records remained that did not fit in this session */
+bool bulk_more(void);
+
+/**
+ * @brief Get an encoded chunk of the current session
+ *
+ * @param index Chunk index
+ * @param len Out: chunk length
+ * @return Pointer into the session buffer, or NULL for an invalid index
+ */
+const uint8_t* bulk_chunk(uint8_t index, uint8_t& len);
+
+#endif // BULK_H
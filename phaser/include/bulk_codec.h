@@ -0,0 +1,443 @@
+/**
+ * @file bulk_codec.h
+ * @brief Compressed bulk transfer format for telemetry history
+ *
+ * Shared by the phaser (encoder), the controller and Linux host tools
+ * (decoder). Plain C++ with no Arduino dependencies so the same file
+ * compiles everywhere; keep the copies in phaser/ and controller/ identical.
+ *
+ * A transfer is a sequence of chunks, each at most one LoRa frame. Every
+ * chunk is self-contained (it starts with an absolute keyframe record), so
+ * chunks can be decoded straight out of the receive buffer in any order and
+ * a lost chunk only costs its own retransmission.
+ *
+ * Chunk layout:
+ *
+ *   [0] BULK_CHUNK_MARKER
+ *   [1] Session id
+ *   [2] Chunk index
+ *   [3] Chunk count in session
+ *   [4] Tier
+ *   varint  record count (>= 1)
+ *   varint  period_ms
+ *   varint  start_ms of first record
+ *   byte    direction of first record
+ *   4 x (zigzag-varint mean, varint mean-min, varint max-mean)
+ *   BULK_NUM_FIELDS x 5-bit field widths        (bit-packed, LSB first)
+ *   (count - 1) records, each field in its width (bit-packed, LSB first):
+ *     slots skipped since previous record, direction,
+ *     4 x (zigzag mean delta, mean-min, max-mean)
+ *
+ * Widths are chosen per chunk as the smallest that fits every value in it,
+ * so a steady signal costs a few bits per field and a zero-width field
+ * costs nothing at all.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef BULK_CODEC_H
+#define BULK_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// FORMAT CONSTANTS
+// ============================================================================
+
+/** @brief First byte of every bulk data chunk (never a valid ASCII reply) */
+#define BULK_CHUNK_MARKER 0xB7
+
+/** @brief Fixed chunk header length */
+#define BULK_CHUNK_HEADER_LEN 5
+
+/** @brief Channels per record: bus mV, bus mA, MCU mV, reverse power 0.1 W */
+#define BULK_NUM_CHANNELS 4
+
+/** @brief Delta-coded fields per record: slot skip, direction, 3 per channel */
+#define BULK_NUM_FIELDS (2 + 3 * BULK_NUM_CHANNELS)
+
+/** @brief Bits used to store each field width */
+#define BULK_WIDTH_BITS 5
+
+/** @brief Bytes occupied by the packed field-width table */
+#define BULK_WIDTH_TABLE_LEN ((BULK_NUM_FIELDS * BULK_WIDTH_BITS + 7) / 8)
+
+// ============================================================================
+// RECORD
+// ============================================================================
+
+/** @brief One history slot as carried by the bulk format */
+struct BulkRecord {
+    uint32_t start_ms;                  /**< Slot start, phaser millis() */
+    uint8_t direction;                  /**< Direction, bit 3 = changed in slot */
+    int16_t min[BULK_NUM_CHANNELS];     /**< Per-channel minimum */
+    int16_t max[BULK_NUM_CHANNELS];     /**< Per-channel maximum */
+    int16_t mean[BULK_NUM_CHANNELS];    /**< Per-channel mean */
+};
+
+/** @brief Chunk header fields */
+struct BulkChunkHeader {
+    uint8_t session;       /**< Transfer session id */
+    uint8_t index;         /**< Chunk index within the session */
+    uint8_t count;         /**< Chunks in the session */
+    uint8_t tier;          /**< History tier */
+};
+
+// ============================================================================
+// PRIMITIVES
+// ============================================================================
+
+/** @brief Map a signed value onto unsigned so small magnitudes stay small */
+static inline uint32_t bulk_zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+/** @brief Inverse of bulk_zigzag() */
+static inline int32_t bulk_unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/** @brief Number of bits needed to hold v (0 for v == 0) */
+static inline uint8_t bulk_bit_width(uint32_t v) {
+    uint8_t bits = 0;
+    while (v) {
+        bits++;
+        v >>= 1;
+    }
+    return bits;
+}
+
+/** @brief Encoded size of a LEB128 varint */
+static inline uint8_t bulk_varint_len(uint32_t v) {
+    uint8_t len = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        len++;
+    }
+    return len;
+}
+
+/**
+ * @brief Bounded LSB-first bit/varint writer over a caller's buffer
+ */
+class BulkWriter {
+public:
+    BulkWriter(uint8_t* buf, size_t cap) : buf_(buf), cap_(cap), pos_(0), bit_(0), ok_(true) {}
+
+    void put_byte(uint8_t v) {
+        align();
+        if (pos_ >= cap_) { ok_ = false; return; }
+        buf_[pos_++] = v;
+    }
+
+    void put_varint(uint32_t v) {
+        while (v >= 0x80) {
+            put_byte((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        put_byte((uint8_t)v);
+    }
+
+    void put_bits(uint32_t v, uint8_t n) {
+        for (uint8_t i = 0; i < n; i++) {
+            if (bit_ == 0) {
+                if (pos_ >= cap_) { ok_ = false; return; }
+                buf_[pos_] = 0;
+            }
+            buf_[pos_] |= (uint8_t)(((v >> i) & 1) << bit_);
+            if (++bit_ == 8) {
+                bit_ = 0;
+                pos_++;
+            }
+        }
+    }
+
+    /** @brief Pad to the next byte boundary */
+    void align() {
+        if (bit_) {
+            bit_ = 0;
+            pos_++;
+        }
+    }
+
+    /** @brief Bytes written so far, including any partial byte */
+    size_t length() const { return pos_ + (bit_ ? 1 : 0); }
+
+    /** @brief False if any write ran past the buffer */
+    bool ok() const { return ok_; }
+
+private:
+    uint8_t* buf_;
+    size_t cap_;
+    size_t pos_;
+    uint8_t bit_;
+    bool ok_;
+};
+
+/**
+ * @brief Bounded LSB-first bit/varint reader directly over a packet buffer
+ */
+class BulkReader {
+public:
+    BulkReader(const uint8_t* buf, size_t len)
+        : buf_(buf), len_(len), pos_(0), bit_(0), ok_(true) {}
+
+    uint8_t get_byte() {
+        align();
+        if (pos_ >= len_) { ok_ = false; return 0; }
+        return buf_[pos_++];
+    }
+
+    uint32_t get_varint() {
+        uint32_t v = 0;
+        for (uint8_t shift = 0; shift < 35; shift += 7) {
+            uint8_t b = get_byte();
+            v |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    uint32_t get_bits(uint8_t n) {
+        uint32_t v = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            if (pos_ >= len_) { ok_ = false; return 0; }
+            v |= (uint32_t)((buf_[pos_] >> bit_) & 1) << i;
+            if (++bit_ == 8) {
+                bit_ = 0;
+                pos_++;
+            }
+        }
+        return v;
+    }
+
+    void align() {
+        if (bit_) {
+            bit_ = 0;
+            pos_++;
+        }
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    const uint8_t* buf_;
+    size_t len_;
+    size_t pos_;
+    uint8_t bit_;
+    bool ok_;
+};
+
+// ============================================================================
+// FIELD EXTRACTION
+// ============================================================================
+
+/**
+ * @brief Compute the delta-coded field values of a record
+ *
+ * @param prev Previous record in the chunk
+ * @param rec Record to code
+ * @param period_ms Tier slot length
+ * @param fields Output, BULK_NUM_FIELDS values
+ * @return false if rec cannot follow prev (misaligned or not newer)
+ */
+static inline bool bulk_record_fields(const BulkRecord& prev, const BulkRecord& rec,
+                                      uint32_t period_ms, uint32_t* fields) {
+    uint32_t gap = rec.start_ms - prev.start_ms;
+    if (period_ms == 0 || gap == 0 || gap % period_ms != 0 || (int32_t)gap < 0) {
+        return false;
+    }
+    fields[0] = gap / period_ms - 1;
+    fields[1] = rec.direction;
+    for (uint8_t c = 0; c < BULK_NUM_CHANNELS; c++) {
+        fields[2 + 3 * c] = bulk_zigzag((int32_t)rec.mean[c] - prev.mean[c]);
+        fields[3 + 3 * c] = (uint32_t)((int32_t)rec.mean[c] - rec.min[c]);
+        fields[4 + 3 * c] = (uint32_t)((int32_t)rec.max[c] - rec.mean[c]);
+    }
+    return true;
+}
+
+// ============================================================================
+// ENCODER
+// ============================================================================
+
+/**
+ * @brief Encode as many records as fit into one chunk
+ *
+ * Field widths grow monotonically as records are added, so the fit is
+ * found in one pass without trial encoding.
+ *
+ * @param hdr Chunk header to write
+ * @param period_ms Tier slot length
+ * @param recs Records, oldest first (min <= mean <= max per channel)
+ * @param n Number of records available
+ * @param out Output buffer
+ * @param cap Output capacity (one LoRa frame)
+ * @param consumed Out: records encoded into this chunk
+ * @return Chunk length in bytes, 0 if not even one record fits
+ */
+static inline size_t bulk_encode_chunk(const BulkChunkHeader& hdr, uint32_t period_ms,
+                                       const BulkRecord* recs, uint16_t n,
+                                       uint8_t* out, size_t cap, uint16_t* consumed) {
+    *consumed = 0;
+    if (n == 0) return 0;
+
+    // Size of header and keyframe (record count varint sized for worst case)
+    size_t fixed = BULK_CHUNK_HEADER_LEN + bulk_varint_len(n) + bulk_varint_len(period_ms)
+                 + bulk_varint_len(recs[0].start_ms) + 1 + BULK_WIDTH_TABLE_LEN;
+    for (uint8_t c = 0; c < BULK_NUM_CHANNELS; c++) {
+        fixed += bulk_varint_len(bulk_zigzag(recs[0].mean[c]));
+        fixed += bulk_varint_len((uint32_t)((int32_t)recs[0].mean[c] - recs[0].min[c]));
+        fixed += bulk_varint_len((uint32_t)((int32_t)recs[0].max[c] - recs[0].mean[c]));
+    }
+    if (fixed > cap) return 0;
+
+    // Grow the chunk while the packed body still fits
+    uint8_t widths[BULK_NUM_FIELDS] = {0};
+    uint16_t count = 1;
+    while (count < n) {
+        uint32_t fields[BULK_NUM_FIELDS];
+        if (!bulk_record_fields(recs[count - 1], recs[count], period_ms, fields)) break;
+
+        uint8_t trial[BULK_NUM_FIELDS];
+        uint32_t bits_per_record = 0;
+        for (uint8_t f = 0; f < BULK_NUM_FIELDS; f++) {
+            uint8_t w = bulk_bit_width(fields[f]);
+            trial[f] = w > widths[f] ? w : widths[f];
+            bits_per_record += trial[f];
+        }
+        size_t body = ((size_t)bits_per_record * count + 7) / 8;
+        if (fixed + body > cap) break;
+
+        for (uint8_t f = 0; f < BULK_NUM_FIELDS; f++) widths[f] = trial[f];
+        count++;
+    }
+
+    BulkWriter w(out, cap);
+    w.put_byte(BULK_CHUNK_MARKER);
+    w.put_byte(hdr.session);
+    w.put_byte(hdr.index);
+    w.put_byte(hdr.count);
+    w.put_byte(hdr.tier);
+    w.put_varint(count);
+    w.put_varint(period_ms);
+    w.put_varint(recs[0].start_ms);
+    w.put_byte(recs[0].direction);
+    for (uint8_t c = 0; c < BULK_NUM_CHANNELS; c++) {
+        w.put_varint(bulk_zigzag(recs[0].mean[c]));
+        w.put_varint((uint32_t)((int32_t)recs[0].mean[c] - recs[0].min[c]));
+        w.put_varint((uint32_t)((int32_t)recs[0].max[c] - recs[0].mean[c]));
+    }
+    for (uint8_t f = 0; f < BULK_NUM_FIELDS; f++) {
+        w.put_bits(widths[f], BULK_WIDTH_BITS);
+    }
+    w.align();
+    for (uint16_t r = 1; r < count; r++) {
+        uint32_t fields[BULK_NUM_FIELDS];
+        bulk_record_fields(recs[r - 1], recs[r], period_ms, fields);
+        for (uint8_t f = 0; f < BULK_NUM_FIELDS; f++) {
+            w.put_bits(fields[f], widths[f]);
+        }
+    }
+
+    if (!w.ok()) return 0;
+    *consumed = count;
+    return w.length();
+}
+
+// ============================================================================
+// DECODER
+// ============================================================================
+
+/**
+ * @brief Zero-copy iterator over the records of one received chunk
+ *
+ * Reads directly from the packet buffer, which must stay valid while the
+ * decoder is in use. Typical use:
+ *
+ *   BulkChunkDecoder dec(buf, len);
+ *   BulkRecord rec;
+ *   while (dec.next(rec)) { ... }
+ *   if (!dec.ok()) { ... malformed ... }
+ */
+class BulkChunkDecoder {
+public:
+    BulkChunkDecoder(const uint8_t* buf, size_t len)
+        : reader_(buf, len), remaining_(0), period_ms_(0), first_(true), ok_(false) {
+        if (len < BULK_CHUNK_HEADER_LEN || buf[0] != BULK_CHUNK_MARKER) return;
+        reader_.get_byte();
+        header_.session = reader_.get_byte();
+        header_.index = reader_.get_byte();
+        header_.count = reader_.get_byte();
+        header_.tier = reader_.get_byte();
+        remaining_ = reader_.get_varint();
+        period_ms_ = reader_.get_varint();
+        ok_ = reader_.ok() && remaining_ > 0 && header_.index < header_.count;
+    }
+
+    /** @brief Header of this chunk (valid if ok()) */
+    const BulkChunkHeader& header() const { return header_; }
+
+    /** @brief Records left to decode */
+    uint32_t remaining() const { return remaining_; }
+
+    /** @brief False if the chunk is malformed or truncated */
+    bool ok() const { return ok_ && reader_.ok(); }
+
+    /**
+     * @brief Decode the next record
+     *
+     * @param rec Output record
+     * @return false when the chunk is exhausted or malformed
+     */
+    bool next(BulkRecord& rec) {
+        if (!ok() || remaining_ == 0) return false;
+
+        if (first_) {
+            prev_.start_ms = reader_.get_varint();
+            prev_.direction = reader_.get_byte();
+            for (uint8_t c = 0; c < BULK_NUM_CHANNELS; c++) {
+                prev_.mean[c] = (int16_t)bulk_unzigzag(reader_.get_varint());
+                prev_.min[c] = (int16_t)(prev_.mean[c] - (int32_t)reader_.get_varint());
+                prev_.max[c] = (int16_t)(prev_.mean[c] + (int32_t)reader_.get_varint());
+            }
+            for (uint8_t f = 0; f < BULK_NUM_FIELDS; f++) {
+                widths_[f] = (uint8_t)reader_.get_bits(BULK_WIDTH_BITS);
+            }
+            reader_.align();
+            first_ = false;
+        } else {
+            uint32_t fields[BULK_NUM_FIELDS];
+            for (uint8_t f = 0; f < BULK_NUM_FIELDS; f++) {
+                fields[f] = reader_.get_bits(widths_[f]);
+            }
+            prev_.start_ms += (fields[0] + 1) * period_ms_;
+            prev_.direction = (uint8_t)fields[1];
+            for (uint8_t c = 0; c < BULK_NUM_CHANNELS; c++) {
+                prev_.mean[c] = (int16_t)(prev_.mean[c] + bulk_unzigzag(fields[2 + 3 * c]));
+                prev_.min[c] = (int16_t)(prev_.mean[c] - (int32_t)fields[3 + 3 * c]);
+                prev_.max[c] = (int16_t)(prev_.mean[c] + (int32_t)fields[4 + 3 * c]);
+            }
+        }
+
+        if (!ok()) return false;
+        remaining_--;
+        rec = prev_;
+        return true;
+    }
+
+private:
+    BulkReader reader_;
+    BulkChunkHeader header_;
+    uint32_t remaining_;
+    uint32_t period_ms_;
+    bool first_;
+    bool ok_;
+    uint8_t widths_[BULK_NUM_FIELDS];
+    BulkRecord prev_;
+};
+
+#endif // BULK_CODEC_H
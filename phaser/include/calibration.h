@@ -0,0 +1,156 @@
+/**
+ * @file calibration.h
+ * @brief Per-direction reverse power calibration tables
+ *
+ * Each antenna direction has its own table mapping the detector reading
+ * (Q6 10-bit counts, see rf_power.h) to reverse power in 0.1 W. Tables
+ * are piecewise-linear in the square of the detector voltage, since power
+ * goes as voltage squared: an ideal detector needs a single point, and
+ * extra points correct diode and coupler non-linearity where they are
+ * measured. Evaluation is integer-only.
+ *
+ * Below the first point the table runs to (0, 0); above the last point
+ * the last segment is extended. Tables are kept in NVM and a direction
+ * without a valid stored table uses a default built from
+ * REV_POWER_CONVERSION_FACTOR, which matches the original formula.
+ *
+ * Calibration over the air: cal_begin() opens a working table for the
+ * current direction, each cal_add_point() pairs the live detector reading
+ * with a reference power read from an external wattmeter, and
+ * cal_commit() installs and persists it (cal_abort() discards it).
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+// ============================================================================
+// TABLE STRUCTURE
+// ============================================================================
+
+/** @brief One calibration point */
+struct CalPoint {
+    uint16_t adc_q6;       /**< Detector reading, Q6 10-bit counts */
+    uint16_t power_dw;     /**< Reference reverse power (0.1 W) */
+};
+
+/** @brief Calibration table for one direction */
+struct CalTable {
+    uint8_t count;                      /**< Valid points (1..CAL_MAX_POINTS) */
+    uint8_t reserved[3];                /**< Padding, keeps points aligned */
+    CalPoint points[CAL_MAX_POINTS];    /**< Points, adc_q6 strictly increasing */
+};
+
+/** @brief Calibration command results */
+enum CalStatus {
+    CAL_OK = 0,            /**< Success */
+    CAL_ERR_MODE = 1,      /**< Not (or already) in calibration mode */
+    CAL_ERR_DIRECTION = 2, /**< Direction differs from the session's */
+    CAL_ERR_FULL = 3,      /**< Working table already has CAL_MAX_POINTS */
+    CAL_ERR_ORDER = 4,     /**< Point not monotonic with the existing points */
+    CAL_ERR_NVM = 5        /**< Flash write failed */
+};
+
+// ============================================================================
+// API
+// ============================================================================
+
+/**
+ * @brief Load tables from NVM, falling back to defaults per direction
+ */
+void cal_init(void);
+
+/**
+ * @brief Convert a detector reading to reverse power
+ *
+ * @param direction Antenna direction (0-7)
+ * @param adc_q6 Detector reading, Q6 10-bit counts
+ * @return Reverse power in 0.1 W, saturated at 65535
+ */
+uint16_t cal_power_dw(uint8_t direction, uint16_t adc_q6);
+
+/**
+ * @brief Convert a forward power detector reading to forward power
+ *
+ * The forward coupler sits ahead of the phasing network, so it needs no
+ * per-direction table; it uses the square law with
+ * FWD_POWER_CONVERSION_FACTOR.
+ *
+ * @param adc_q6 Detector reading, Q6 10-bit counts
+ * @return Forward power in 0.1 W, saturated at 65535
+ */
+uint16_t cal_forward_power_dw(uint16_t adc_q6);
+
+/**
+ * @brief Installed table of a direction
+ *
+ * @param direction Antenna direction (0-7)
+ * @return Table (direction 0's for an invalid direction)
+ */
+const CalTable& cal_table(uint8_t direction);
+
+/**
+ * @brief Whether a direction's table came from NVM (vs. the default)
+ *
+ * @param direction Antenna direction (0-7)
+ * @return true if calibrated
+ */
+bool cal_is_calibrated(uint8_t direction);
+
+/**
+ * @brief Start calibrating a direction with an empty working table
+ *
+ * @param direction Antenna direction being calibrated
+ * @return CAL_OK or CAL_ERR_MODE if a session is already open
+ */
+CalStatus cal_begin(uint8_t direction);
+
+/**
+ * @brief Add a reference point to the working table
+ *
+ * A point whose reading equals an existing one replaces it.
+ *
+ * @param direction Current antenna direction (must match the session)
+ * @param adc_q6 Detector reading
+ * @param power_dw Reference reverse power (0.1 W)
+ * @return CAL_OK or an error
+ */
+CalStatus cal_add_point(uint8_t direction, uint16_t adc_q6, uint16_t power_dw);
+
+/**
+ * @brief Install the working table and save all tables to NVM
+ *
+ * @return CAL_OK, CAL_ERR_MODE (no session or no points) or CAL_ERR_NVM
+ */
+CalStatus cal_commit(void);
+
+/**
+ * @brief Discard the working table and leave calibration mode
+ */
+void cal_abort(void);
+
+/**
+ * @brief Restore a direction to the default table and save to NVM
+ *
+ * @param direction Antenna direction (0-7)
+ * @return CAL_OK, CAL_ERR_DIRECTION or CAL_ERR_NVM
+ */
+CalStatus cal_restore_default(uint8_t direction);
+
+/**
+ * @brief Whether a calibration session is open
+ */
+bool cal_active(void);
+
+/**
+ * @brief Working table of the open session
+ */
+const CalTable& cal_working_table(void);
+
+#endif // CALIBRATION_H
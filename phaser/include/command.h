@@ -0,0 +1,62 @@
+/**
+ * @file command.h
+ * @brief Read-only, bounds-checked view of a received command
+ *
+ * A command is received into a pooled packet, authenticated and checked
+ * there, and then handled straight out of the packet: the view points at
+ * the command bytes (the authentication bytes are not part of it) and
+ * never copies them. Reads past the end return '\0' rather than whatever
+ * follows in the packet, so a handler that trusts the format check a
+ * little too much still sees a terminated string.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stdint.h>
+#include <ctype.h>
+
+/**
+ * @brief Command bytes inside a received packet
+ *
+ * The byte after the command is '\0' (written over the first
+ * authentication byte once it has been checked), so from() can be given
+ * to strtoul() and friends.
+ */
+struct CommandView {
+    const char* text;              /**< First command byte */
+    uint8_t len;                   /**< Command bytes, without authentication */
+
+    /** @brief Byte i, or '\0' past the end */
+    char operator[](uint8_t i) const {
+        return (i < len) ? text[i] : '\0';
+    }
+
+    /** @brief Terminated tail starting at byte i (empty past the end) */
+    const char* from(uint8_t i) const {
+        return text + ((i < len) ? i : len);
+    }
+
+    /**
+     * @brief Value of a fixed-width hex or decimal field
+     *
+     * @param start First digit
+     * @param digits Field width
+     * @param base 10 or 16
+     * @return Value of the digits (0 where a byte is not a digit in base)
+     */
+    uint32_t number(uint8_t start, uint8_t digits, uint8_t base) const {
+        uint32_t value = 0;
+        for (uint8_t i = start; i < start + digits; i++) {
+            char c = (*this)[i];
+            uint8_t d = isdigit(c) ? c - '0' : (isxdigit(c) ? (toupper(c) - 'A' + 10) : 0);
+            value = value * base + ((d < base) ? d : 0);
+        }
+        return value;
+    }
+};
+
+#endif // COMMAND_H
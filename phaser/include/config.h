@@ -61,6 +61,156 @@
 /** @brief Relay 7/8 parallel output pin */
 #define RELAY_78 15
 
+// ============================================================================
+// RELAY OUTPUT BACKEND
+// ============================================================================
+
+/**
+ * @brief How the relay pattern reaches the relays
+ *
+ * - RELAY_BACKEND_GPIO (default) - one pin per relay (RELAY_1 ... RELAY_78),
+ *   up to six relays
+ * - RELAY_BACKEND_SPI - chained 74HC595 / TPIC6B595 shift registers on
+ *   SERCOM1, loaded by one DMA transfer and latched together, so every
+ *   output changes at the same instant
+ *
+ * Can be overridden at compile time via platformio.ini:
+ * build_flags = -D RELAY_BACKEND=RELAY_BACKEND_SPI
+ */
+#ifndef RELAY_BACKEND
+    #define RELAY_BACKEND RELAY_BACKEND_GPIO
+#endif
+
+#define RELAY_BACKEND_GPIO 1
+#define RELAY_BACKEND_SPI 2
+
+/**
+ * @brief Shift register data and clock (SERCOM1 pads 2 and 3)
+ *
+ * D10 = MOSI -> SER, D12 = SCK -> SRCK. Pad 0 (D11) is claimed as the
+ * unused MISO. These replace the RELAY_3/RELAY_56 outputs; the SPI
+ * port is the radio's and D13 is the LED, so neither can be used.
+ */
+#define RELAY_SR_MOSI_PIN 10
+#define RELAY_SR_SCK_PIN 12
+#define RELAY_SR_MISO_PIN 11
+
+/** @brief Shift register storage clock (RCK / RCLK), rising edge latches */
+#define RELAY_SR_LATCH_PIN 6
+
+/**
+ * @brief Shift register output enable (/G or /OE, active low)
+ *
+ * Needs a pull-up on the board so the outputs stay off until the first
+ * pattern is latched. Raised by the protection trip to drop every relay
+ * at once.
+ */
+#define RELAY_SR_OE_PIN 5
+
+/** @brief Registers in the chain (may exceed RELAY_PATTERN_BYTES) */
+#define RELAY_SR_CHAIN_BYTES 3
+
+/** @brief Shift clock (Hz); TPIC6B595 is rated for about 10 MHz */
+#define RELAY_SR_SPI_HZ 4000000
+
+// ============================================================================
+// RELAY COIL DRIVE
+// ============================================================================
+
+/**
+ * @brief How the relay coils are energised
+ *
+ * - RELAY_DRIVE_FULL (default) - full voltage for as long as a relay is on
+ * - RELAY_DRIVE_PWM - full voltage for RELAY_PULLIN_MS, then
+ *   TCC0 PWM at RELAY_HOLD_DUTY_PCT. A relay needs far less current to
+ *   stay closed than to close, so this cuts coil current to about the
+ *   duty cycle. GPIO backend: relay 7/8 (D15) has no TCC output and stays
+ *   at full voltage. SPI backend: the output enable is modulated.
+ * - RELAY_DRIVE_LATCH - dual-coil latching relays, shift-register backend
+ *   only. Relay n's set coil is output n and its reset coil output
+ *   RELAY_COUNT + n. Each change pulses every set or reset coil for
+ *   RELAY_LATCH_PULSE_MS; no coil current flows at rest. The latched
+ *   pattern is kept in flash so the phaser knows its direction after a
+ *   restart.
+ *
+ * Hold PWM only suits relays known to stay closed at the reduced voltage,
+ * so a site opts in at compile time via platformio.ini:
+ * build_flags = -D RELAY_DRIVE=RELAY_DRIVE_PWM
+ */
+#ifndef RELAY_DRIVE
+    #define RELAY_DRIVE RELAY_DRIVE_FULL
+#endif
+
+#define RELAY_DRIVE_FULL 1
+#define RELAY_DRIVE_PWM 2
+#define RELAY_DRIVE_LATCH 3
+
+/** @brief Full-voltage time after a change before dropping to hold (ms) */
+#define RELAY_PULLIN_MS 30
+
+/**
+ * @brief Hold duty cycle (%)
+ *
+ * Most 12 V relays hold at 30-40 % of rated voltage; 40 % leaves margin
+ * for a low bus and vibration.
+ */
+#define RELAY_HOLD_DUTY_PCT 40
+
+/**
+ * @brief Hold PWM frequency (Hz)
+ *
+ * Low enough for the optocoupler inputs of common relay modules. The coil
+ * inductance smooths the current.
+ */
+#define RELAY_HOLD_PWM_HZ 2000
+
+/** @brief Set/reset coil pulse for latching relays (ms) */
+#define RELAY_LATCH_PULSE_MS 20
+
+/**
+ * @brief Flash for the wear-levelled latched relay pattern (bytes)
+ *
+ * Sixteen rows of one-page slots hold 64 copies, so each row is erased
+ * once every 64 direction changes: at one change a minute, years of
+ * service before the rows reach their rated erase cycles.
+ */
+#define RELAY_STATE_FLASH_BYTES 4096
+
+/**
+ * @brief Time the latched relays must stay put before the pattern is saved (ms)
+ *
+ * A burst of changes (a sweep) is saved once. Power lost within this time
+ * restores the pattern before the burst; the next switch pulses every coil
+ * and corrects it.
+ */
+#define RELAY_STATE_QUIET_MS 5000
+
+// ============================================================================
+// RELAY OPERATION COUNTERS
+// ============================================================================
+
+/**
+ * @brief Flash for the wear-levelled operation counters (bytes)
+ *
+ * Four rows of one-page slots hold 16 copies of the counters (up to 13
+ * relays), so each row is erased once every 16 flushes.
+ */
+#define RELAY_WEAR_FLASH_BYTES 1024
+
+/** @brief Unsaved relay operations that trigger a flush */
+#define RELAY_WEAR_FLUSH_OPS 64
+
+/** @brief Longest an operation stays unsaved (ms) */
+#define RELAY_WEAR_FLUSH_MS (15UL * 60UL * 1000UL)
+
+/**
+ * @brief Time without a switch before a flush may start (ms)
+ *
+ * Keeps the flash erase (about 6 ms) away from a burst of direction
+ * changes.
+ */
+#define RELAY_WEAR_QUIET_MS 2000
+
 // ============================================================================
 // SENSOR PINS
 // ============================================================================
@@ -68,9 +218,23 @@
 /** @brief Analog pin for reverse power measurement */
 #define REV_POWER_PIN A2
 
+/**
+ * @brief Analog pin for forward power measurement
+ *
+ * Must be the ADC input after REV_POWER_PIN's (A2 = AIN3, A3 = AIN4): the
+ * power sampler scans the two inputs in hardware.
+ */
+#define FWD_POWER_PIN A3
+
 /** @brief I2C address of INA3221 current/voltage monitor */
 #define INA3221_I2C_ADDRESS 0x40
 
+/** @brief INA3221 critical alert output (CRI, open drain, active low) */
+#define INA3221_CRITICAL_PIN A4
+
+/** @brief INA3221 warning alert output (WAR, open drain, active low) */
+#define INA3221_WARNING_PIN A5
+
 // ============================================================================
 // ANTENNA CONFIGURATION SELECTION
 // ============================================================================
@@ -108,35 +272,78 @@ enum Direction {
     DIR_NW = 7    /**< Northwest (315°) */
 };
 
-/** @brief Direction angles in degrees */
-static const char* DIRECTION_ANGLES[] = {
-    "000", "045", "090", "135", "180", "225", "270", "315"
-};
-
 /** @brief Number of directions */
 #define NUM_DIRECTIONS 8
 
+/**
+ * @brief Direction angles in degrees, as the three digits sent on the air
+ *
+ * Defined once in config.cpp. A table of char arrays rather than of
+ * pointers: the strings sit in flash with no pointer table in SRAM, and
+ * one copy is shared by every file.
+ */
+extern const char DIRECTION_ANGLES[NUM_DIRECTIONS][4];
+
+// ============================================================================
+// RELAY PATTERN TABLES
+// ============================================================================
+
+/**
+ * @brief Pack eight relay states into one pattern byte
+ *
+ * Relay tables are packed bitmasks of RELAY_PATTERN_BYTES bytes per
+ * direction: relay n (from 0) is bit n % 8 of byte n / 8. With the
+ * shift-register backend byte k drives register k of the chain, counted
+ * from the MCU, and bit 0 drives its first output (QA / DRAIN0). For more
+ * relays, raise RELAY_COUNT and add a RELAY_BYTE() per eight relays to
+ * each row.
+ *
+ * Arguments are the states of relays 8k+1 ... 8k+8: 0 = off, 1 = on.
+ *
+ * Each table holds RELAY_PROFILE_COUNT profiles of NUM_DIRECTIONS rows,
+ * one profile per band group (phasing lines are cut for one band, so
+ * another band needs other relay states for the same direction). The
+ * controller picks the profile from the transceiver band data; profile 0
+ * is used from power-up until it does. To add a band, raise
+ * RELAY_PROFILE_COUNT, add a block of eight rows and map the band to it
+ * in BAND_PROFILES in the controller's config.h.
+ */
+#define RELAY_BYTE(r1, r2, r3, r4, r5, r6, r7, r8) \
+    ((uint8_t)((r1) | (r2) << 1 | (r3) << 2 | (r4) << 3 | \
+               (r5) << 4 | (r6) << 5 | (r7) << 6 | (r8) << 7))
+
 // ============================================================================
 // RELAY CONFIGURATION - REMOTEQTH (8-Direction)
 // ============================================================================
 
 #if ANTENNA_CONFIG == ANTENNA_REMOTEQTH
 
+/** @brief Relay outputs used by the table */
+#define RELAY_COUNT 6
+
+/** @brief Bytes per packed relay pattern */
+#define RELAY_PATTERN_BYTES ((RELAY_COUNT + 7) / 8)
+
+/** @brief Relay map profiles (band groups) in the table */
+#define RELAY_PROFILE_COUNT 1
+
 /**
  * @brief Relay configuration for RemoteQTH 8-direction controller
  *
  * Each row represents relay states {R1, R2, R3, R4, R5/6, R7/8} for that direction
  * 0 = LOW (relay off), 1 = HIGH (relay on)
  */
-static const uint8_t RELAY_POSITIONS[8][6] = {
-    {0, 0, 0, 0, 0, 0},  // N (000°): 0
-    {0, 0, 1, 1, 0, 1},  // NE (045°): 1
-    {1, 1, 1, 1, 1, 1},  // E (090°): 2
-    {0, 1, 1, 0, 0, 1},  // SE (135°): 3
-    {0, 0, 0, 0, 1, 1},  // S (180°): 4
-    {1, 1, 0, 0, 0, 1},  // SW (225°): 5
-    {1, 1, 1, 1, 0, 0},  // W (270°): 6
-    {1, 0, 0, 1, 0, 0}   // NW (315°): 7
+static const uint8_t RELAY_POSITIONS[RELAY_PROFILE_COUNT][NUM_DIRECTIONS][RELAY_PATTERN_BYTES] = {
+    {   // Profile 0: all bands
+        {RELAY_BYTE(0, 0, 0, 0, 0, 0, 0, 0)},  // N (000°): 0
+        {RELAY_BYTE(0, 0, 1, 1, 0, 1, 0, 0)},  // NE (045°): 1
+        {RELAY_BYTE(1, 1, 1, 1, 1, 1, 0, 0)},  // E (090°): 2
+        {RELAY_BYTE(0, 1, 1, 0, 0, 1, 0, 0)},  // SE (135°): 3
+        {RELAY_BYTE(0, 0, 0, 0, 1, 1, 0, 0)},  // S (180°): 4
+        {RELAY_BYTE(1, 1, 0, 0, 0, 1, 0, 0)},  // SW (225°): 5
+        {RELAY_BYTE(1, 1, 1, 1, 0, 0, 0, 0)},  // W (270°): 6
+        {RELAY_BYTE(1, 0, 0, 1, 0, 0, 0, 0)}   // NW (315°): 7
+    }
 };
 
 #elif ANTENNA_CONFIG == ANTENNA_COMTEK
@@ -153,30 +360,81 @@ static const uint8_t RELAY_POSITIONS[8][6] = {
  * The 8-element array accommodates the full direction range,
  * but indices are mapped: 0/1=N, 2/3=E, 4/5=S, 6/7=W
  */
-static const uint8_t RELAY_POSITIONS[8][6] = {
-    {0, 0, 0, 0, 0, 0},  // N (000°): Maps to NE pattern
-    {0, 0, 0, 0, 0, 0},  // NE (045°): 0
-    {1, 0, 0, 0, 0, 0},  // E (090°): Maps to SE pattern
-    {1, 0, 0, 0, 0, 0},  // SE (135°): 1
-    {0, 1, 0, 0, 0, 0},  // S (180°): Maps to SW pattern
-    {0, 1, 0, 0, 0, 0},  // SW (225°): 2
-    {1, 1, 0, 0, 0, 0},  // W (270°): Maps to NW pattern
-    {1, 1, 0, 0, 0, 0}   // NW (315°): 3
+#define RELAY_COUNT 6
+#define RELAY_PATTERN_BYTES ((RELAY_COUNT + 7) / 8)
+#define RELAY_PROFILE_COUNT 1
+
+static const uint8_t RELAY_POSITIONS[RELAY_PROFILE_COUNT][NUM_DIRECTIONS][RELAY_PATTERN_BYTES] = {
+    {   // Profile 0: all bands
+        {RELAY_BYTE(0, 0, 0, 0, 0, 0, 0, 0)},  // N (000°): Maps to NE pattern
+        {RELAY_BYTE(0, 0, 0, 0, 0, 0, 0, 0)},  // NE (045°): 0
+        {RELAY_BYTE(1, 0, 0, 0, 0, 0, 0, 0)},  // E (090°): Maps to SE pattern
+        {RELAY_BYTE(1, 0, 0, 0, 0, 0, 0, 0)},  // SE (135°): 1
+        {RELAY_BYTE(0, 1, 0, 0, 0, 0, 0, 0)},  // S (180°): Maps to SW pattern
+        {RELAY_BYTE(0, 1, 0, 0, 0, 0, 0, 0)},  // SW (225°): 2
+        {RELAY_BYTE(1, 1, 0, 0, 0, 0, 0, 0)},  // W (270°): Maps to NW pattern
+        {RELAY_BYTE(1, 1, 0, 0, 0, 0, 0, 0)}   // NW (315°): 3
+    }
 };
 
 #else
     #error "Invalid ANTENNA_CONFIG. Use ANTENNA_REMOTEQTH or ANTENNA_COMTEK"
 #endif
 
+/** @brief Rows of all profiles: position = profile x NUM_DIRECTIONS + direction */
+#define RELAY_POSITION_COUNT (RELAY_PROFILE_COUNT * NUM_DIRECTIONS)
+
 // ============================================================================
-// ADC CONFIGURATION FOR REVERSE POWER MEASUREMENT
+// ADC CONFIGURATION FOR FORWARD/REVERSE POWER MEASUREMENT
 // ============================================================================
 
-/** @brief Number of ADC samples to average for SWR reading */
-#define ADC_AVG_COUNT 10
+/**
+ * @brief Hardware averaging per result, as a power of two (0..10)
+ *
+ * The ADC free-runs, scanning reverse then forward, and accumulates
+ * 2^n conversions of each input before delivering one result by DMA, so
+ * the CPU only sees a block of results every few milliseconds. Each
+ * doubling of the count adds half a bit of resolution and halves the
+ * rate: 4 (16 samples) gives 14 bits at about RF_SAMPLE_RATE_HZ per
+ * channel, 8 (256 samples) gives 16 bits at about 250 Hz.
+ */
+#define RF_ADC_AVG_LOG2 4
+
+/**
+ * @brief Nominal result rate per channel (Hz), for the time constants below
+ *
+ * Set by the ADC timing, not a timer: GCLK0 / 32 = 1.5 MHz, about 11.5
+ * clocks per conversion with RF_ADC_SAMPLEN 8, 2^RF_ADC_AVG_LOG2
+ * conversions per result, two channels. The exact count is reported as
+ * RfPowerStats::samples.
+ */
+#define RF_SAMPLE_RATE_HZ 4000
+
+/** @brief ADC results per DMA block (even: reverse/forward pairs) */
+#define RF_DMA_BLOCK_RESULTS 32
 
-/** @brief Delay between accumulating ADC samples (ms) */
-#define ADC_SAMPLE_DELAY 10
+/** @brief Length of one statistics bucket (ms) */
+#define RF_BUCKET_MS 50
+
+/** @brief Buckets kept; bounds the longest window below (20 x 50 ms = 1 s) */
+#define RF_NUM_BUCKETS 20
+
+/** @brief Peak-hold window in buckets (1 s) */
+#define RF_PEAK_HOLD_BUCKETS 20
+
+/** @brief Mean/RMS window in buckets (500 ms) */
+#define RF_RMS_BUCKETS 10
+
+/**
+ * @brief Envelope release as a power-of-two divisor per sample
+ *
+ * Time constant = 2^shift / RF_SAMPLE_RATE_HZ (10 -> 256 ms). Attack is
+ * instantaneous.
+ */
+#define RF_ENV_DECAY_SHIFT 10
+
+/** @brief ADC sampling time in half ADC clock cycles (source impedance) */
+#define RF_ADC_SAMPLEN 8
 
 /** @brief Conversion factor: ADC counts to volts for reverse power
  *
@@ -185,18 +443,256 @@ static const uint8_t RELAY_POSITIONS[8][6] = {
  */
 #define REV_POWER_CONVERSION_FACTOR 0.5474F
 
+/** @brief Conversion factor: ADC counts to volts for forward power (same coupler) */
+#define FWD_POWER_CONVERSION_FACTOR 0.5474F
+
+// ============================================================================
+// SWR
+// ============================================================================
+
+/** @brief Minimum forward power for a valid SWR reading (0.1 W) */
+#define SWR_MIN_FWD_DW 10
+
+/** @brief SWR readings kept for windowed statistics (x 100 ms = 2 s) */
+#define SWR_WINDOW_SAMPLES 20
+
+// ============================================================================
+// REVERSE POWER CALIBRATION
+// ============================================================================
+
+/**
+ * @brief Maximum calibration points per direction
+ *
+ * Directions without a stored table use a single default point derived
+ * from REV_POWER_CONVERSION_FACTOR.
+ */
+#define CAL_MAX_POINTS 8
+
+/** @brief Flash reserved for calibration tables (whole 256-byte NVM rows) */
+#define CAL_FLASH_BYTES 512
+
+// ============================================================================
+// TELEMETRY HISTORY
+// ============================================================================
+
+/** @brief Interval between history samples (ms) */
+#define HISTORY_SAMPLE_PERIOD_MS 100
+
+/** @brief Tier 0: slot length (ms) and number of slots kept (1 s x 60 = 1 min) */
+#define HISTORY_TIER0_PERIOD_MS 1000UL
+#define HISTORY_TIER0_SLOTS 60
+
+/** @brief Tier 1: slot length (ms) and number of slots kept (1 min x 60 = 1 h) */
+#define HISTORY_TIER1_PERIOD_MS 60000UL
+#define HISTORY_TIER1_SLOTS 60
+
+/** @brief Tier 2: slot length (ms) and number of slots kept (15 min x 96 = 24 h) */
+#define HISTORY_TIER2_PERIOD_MS 900000UL
+#define HISTORY_TIER2_SLOTS 96
+
+/** @brief Bytes reserved for the encoded chunks of one bulk download */
+#define BULK_BUFFER_LEN 2048
+
+/** @brief Maximum chunks per bulk session (one bit each in the retransmit mask) */
+#define BULK_MAX_CHUNKS 16
+
+/** @brief Records staged from history per encoding pass */
+#define BULK_STAGE_RECORDS 32
+
 // ============================================================================
 // PROTOCOL CONFIGURATION
 // ============================================================================
 
-/** @brief Maximum command buffer length */
-#define MAX_COMMAND_LEN 7
+/**
+ * @brief Longest command accepted, without the AUTH_LEN authentication bytes
+ *
+ * Frames are received whole into MTU-sized packets; a longer frame is
+ * rejected before its authentication is computed. The longest command is
+ * TAXXXXXXXXD (11 bytes).
+ */
+#define MAX_COMMAND_LEN 16
+
+/**
+ * @brief Radio frames in the packet pool (see packet_pool.h)
+ *
+ * A command and its reply are in flight together; protection events and
+ * schedule confirmations are sent from other tasks, never at the same
+ * time. One spare for pipelined commands.
+ */
+#define PACKET_POOL_BLOCKS 3
+
+// ============================================================================
+// OVERCURRENT / UNDERVOLTAGE PROTECTION
+// ============================================================================
+
+/**
+ * @brief Relay load current that drops the relays at once (mA)
+ *
+ * INA3221 critical limit on channel 0, compared on every conversion
+ * (a few ms), e.g. a shorted relay coil.
+ */
+#define PROTECT_CRITICAL_MA 1500
+
+/**
+ * @brief Sustained relay load current reported as a warning (mA)
+ *
+ * INA3221 warning limit on channel 0, compared on the averaged value.
+ * Reported only; the relays stay as they are.
+ */
+#define PROTECT_WARNING_MA 1000
+
+/** @brief Bus voltage below which the relays are dropped (mV) */
+#define PROTECT_UNDERVOLT_MV 10500
+
+/** @brief Bus voltage check interval (ms) */
+#define PROTECT_UV_POLL_MS 50
+
+/** @brief Consecutive low readings before an undervoltage trip */
+#define PROTECT_UV_COUNT 3
+
+/**
+ * @brief Time the relays are held off after a trip (ms)
+ *
+ * Direction changes are refused until it has passed and the fault has
+ * cleared.
+ */
+#define PROTECT_HOLDOFF_MS 5000
+
+/** @brief Direction reported after a trip has released every relay */
+#define PROTECT_SAFE_DIRECTION DIR_N
+
+// ============================================================================
+// RELAY ACTUATION VERIFICATION
+// ============================================================================
+
+/** @brief Wait after writing the relay pins before sampling (us) */
+#define RELAY_VERIFY_SETTLE_US 1500
+
+/** @brief Coil current readings averaged after the switch */
+#define RELAY_VERIFY_SAMPLES 3
+
+/** @brief Reading interval, one INA3221 fast conversion cycle (us) */
+#define RELAY_VERIFY_SAMPLE_US 850
+
+/** @brief Step error always accepted (mA) */
+#define RELAY_VERIFY_TOL_MA 15
+
+/** @brief Step error accepted as a percentage of the expected step */
+#define RELAY_VERIFY_TOL_PCT 20
+
+/** @brief Flash reserved for the learned coil currents (bytes) */
+#define RELAY_VERIFY_FLASH_BYTES 256
+
+/**
+ * @brief Time without learning before the learned currents are saved (ms)
+ *
+ * A sweep learns several patterns in a row; they go to flash in one
+ * write, from the flush task, never from the switching path.
+ */
+#define RELAY_VERIFY_SAVE_QUIET_MS 2000
+
+// ============================================================================
+// RF HOT-SWITCH INTERLOCK
+// ============================================================================
+
+/**
+ * @brief Detector level that counts as RF present (Q6 10-bit counts)
+ *
+ * Compared by the ADC window monitor with every forward and reverse
+ * result, so a carrier is seen within a fraction of a millisecond.
+ * 16 counts (about 50 mV at the detector) is well below a few watts
+ * and well above the idle noise.
+ */
+#define RF_SENSE_THRESHOLD_Q6 (16 << 6)
+
+/**
+ * @brief RF must have been absent this long before relays switch (ms)
+ *
+ * Bridges the gaps between CW elements and SSB syllables, so a held
+ * change is applied between overs rather than between words.
+ */
+#define INTERLOCK_QUIET_MS 250
+
+/** @brief A held direction change is dropped after this long (ms) */
+#define INTERLOCK_TIMEOUT_MS 60000
+
+// ============================================================================
+// SCHEDULED DIRECTION CHANGES
+// ============================================================================
+
+/** @brief Direction changes that can be queued ahead */
+#define SCHEDULE_MAX_ENTRIES 16
+
+/**
+ * @brief Furthest ahead an entry may be scheduled (ms)
+ *
+ * Keeps every due time within half the millis() range of now, so wrapped
+ * times still compare correctly.
+ */
+#define SCHEDULE_MAX_AHEAD_MS (24UL * 60UL * 60UL * 1000UL)
+
+/**
+ * @brief A direction command waits for a scheduled change due this soon (ms)
+ *
+ * Covers the relay write and coil current check, so a command and a
+ * scheduled change never interleave.
+ */
+#define SCHEDULE_GUARD_MS 50
+
+/**
+ * @brief No flash erase or write starts with an entry due this soon (ms)
+ *
+ * The CPU stalls on flash fetches while a row erases (about 6 ms a row),
+ * so the schedule timer interrupt could not fire on time. Covers the
+ * largest store written in one go (CAL_FLASH_BYTES, two rows).
+ */
+#define SCHEDULE_FLASH_GUARD_MS 30
+
+/** @brief Confirmations that trigger a report to the controller */
+#define SCHEDULE_REPORT_BATCH 8
+
+/** @brief Longest a confirmation waits to be reported, also the retry interval (ms) */
+#define SCHEDULE_REPORT_MS 5000
+
+// ============================================================================
+// TASK SCHEDULER
+// ============================================================================
+
+/**
+ * @brief Periods, start deadlines and priorities of the loop() tasks
+ *
+ * A task may start up to its deadline after its due time; a later start
+ * is counted as a miss. Priority 0 is the most urgent.
+ */
+#define TASK_RADIO_PERIOD_MS 2
+#define TASK_RADIO_DEADLINE_MS 10
+#define TASK_RADIO_PRIORITY 0
 
-/** @brief Command buffer for receiving from controller */
-extern char command_buffer[MAX_COMMAND_LEN];
+#define TASK_RELAY_PERIOD_MS 5
+#define TASK_RELAY_DEADLINE_MS 20
+#define TASK_RELAY_PRIORITY 1
 
-/** @brief Actually received command length */
-extern int command_length;
+#define TASK_SAMPLE_PERIOD_MS HISTORY_SAMPLE_PERIOD_MS
+#define TASK_SAMPLE_DEADLINE_MS 20
+#define TASK_SAMPLE_PRIORITY 2
+
+#define TASK_REPORT_PERIOD_MS 100
+#define TASK_REPORT_DEADLINE_MS 500
+#define TASK_REPORT_PRIORITY 3
+
+#define TASK_STATUS_PERIOD_MS 10
+#define TASK_STATUS_DEADLINE_MS 100
+#define TASK_STATUS_PRIORITY 4
+
+#define TASK_FLUSH_PERIOD_MS 100
+#define TASK_FLUSH_DEADLINE_MS 1000
+#define TASK_FLUSH_PRIORITY 5
+
+/** @brief Most tasks that can be registered */
+#define TASK_MAX 8
+
+/** @brief Interval of the task statistics log line (ms) */
+#define TASK_LOG_MS 60000UL
 
 // ============================================================================
 // MEASUREMENT AVERAGING
@@ -205,6 +701,18 @@ extern int command_length;
 /** @brief Number of samples for current/voltage averaging */
 #define INA_AVG_SAMPLES 16
 
+// ============================================================================
+// RADIO SPI
+// ============================================================================
+
+/** @brief RFM95 FIFO bursts by DMA (0 = RadioHead's byte loop, for comparison) */
+#ifndef RF95_SPI_DMA
+    #define RF95_SPI_DMA 1
+#endif
+
+/** @brief RFM95 SPI clock: 8 MHz is the fastest SERCOM rate under its 10 MHz limit */
+#define RF95_SPI_FREQUENCY RHGenericSPI::Frequency8MHz
+
 // ============================================================================
 // DEBUG CONFIGURATION
 // ============================================================================
@@ -212,6 +720,11 @@ extern int command_length;
 /** @brief Enable debug output to Serial */
 #define DEBUG 0
 
+/** @brief Time FastPin against digitalWrite/digitalRead on the LED at start-up (fast_gpio.h) */
+#ifndef FAST_GPIO_BENCH
+    #define FAST_GPIO_BENCH 0
+#endif
+
 #if DEBUG
     #define DEBUG_PRINT(x) Serial.print(x)
     #define DEBUG_PRINTLN(x) Serial.println(x)
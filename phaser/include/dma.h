@@ -0,0 +1,107 @@
+/**
+ * @file dma.h
+ * @brief Minimal SAMD21 DMA controller (DMAC) helpers
+ *
+ * The DMAC keeps its channel descriptors in SRAM: one base descriptor per
+ * channel in a table, plus a write-back table for the channels' state.
+ * This module owns both tables and the DMAC interrupt, and hands out the
+ * fixed channel numbers below so each peripheral driver only has to fill
+ * in its descriptors and trigger.
+ *
+ * Block-complete and error interrupts are forwarded to a per-channel
+ * callback in interrupt context. A channel without a callback can instead
+ * be waited for with dma_channel_wait().
+ *
+ * Shared by the phaser and the controller; keep the copies in phaser/ and
+ * controller/ (and of dma.cpp) identical. A firmware that does not use a
+ * channel leaves its descriptor empty.
+ *
+ * The channel functions may be called from interrupt handlers: they leave
+ * the interrupt mask and the DMAC channel selection as they found them.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <Arduino.h>
+
+/** @brief Channels with descriptor storage (keeps the tables small) */
+#define DMA_NUM_CHANNELS 4
+
+/** @brief ADC results to the RF power sampler */
+#define DMA_CH_ADC 0
+
+/** @brief Relay pattern to the shift-register chain */
+#define DMA_CH_RELAYS 1
+
+/** @brief RFM95 FIFO to memory (SERCOM4 receive) */
+#define DMA_CH_RADIO_RX 2
+
+/** @brief Memory to RFM95 FIFO (SERCOM4 transmit) */
+#define DMA_CH_RADIO_TX 3
+
+/**
+ * @brief Channel interrupt callback
+ *
+ * @param channel DMA channel
+ * @param flags DMAC_CHINTFLAG_* bits that were set (already cleared)
+ */
+typedef void (*DmaCallback)(uint8_t channel, uint8_t flags);
+
+/**
+ * @brief Enable the DMAC and install the descriptor tables
+ *
+ * Safe to call more than once; only the first call resets the controller.
+ */
+void dma_init(void);
+
+/**
+ * @brief Base descriptor of a channel, to be filled before enabling it
+ *
+ * @param channel DMA channel
+ * @return Descriptor in the base table
+ */
+DmacDescriptor* dma_descriptor(uint8_t channel);
+
+/**
+ * @brief Reset a channel and set its trigger and interrupts
+ *
+ * Enables the block-complete and transfer-error interrupts when a
+ * callback is given.
+ *
+ * @param channel DMA channel
+ * @param trigger_src Peripheral trigger (e.g. ADC_DMAC_ID_RESRDY)
+ * @param trigger_action DMAC_CHCTRLB_TRIGACT_* value
+ * @param callback Interrupt callback, or nullptr for none
+ */
+void dma_channel_setup(uint8_t channel, uint8_t trigger_src, uint32_t trigger_action,
+                       DmaCallback callback);
+
+/**
+ * @brief Start a channel at its base descriptor
+ *
+ * @param channel DMA channel
+ */
+void dma_channel_enable(uint8_t channel);
+
+/**
+ * @brief Stop a channel
+ *
+ * @param channel DMA channel
+ */
+void dma_channel_disable(uint8_t channel);
+
+/**
+ * @brief Busy-wait for a channel without a callback to finish its block
+ *
+ * Works with interrupts disabled.
+ *
+ * @param channel DMA channel
+ * @return DMAC_CHINTFLAG_* bits that ended the wait (already cleared)
+ */
+uint8_t dma_channel_wait(uint8_t channel);
+
+#endif // DMA_H
@@ -0,0 +1,172 @@
+/**
+ * @file fast_gpio.h
+ * @brief Direct-register GPIO for the Feather M0 with compile-time pin lookup
+ *
+ * Shared by the phaser and the controller; keep the copies in phaser/ and
+ * controller/ identical.
+ *
+ * digitalWrite() and digitalRead() look the pin up in g_APinDescription
+ * and check its mode on every call (roughly 50-100 cycles). A FastPin
+ * resolves the SAMD21 port group and bit mask from the Arduino pin number
+ * when it is constructed; declared constexpr, or used with a constant pin
+ * in inline code, that happens at compile time and each access is one
+ * store or load:
+ *
+ * - high(), low(), toggle(): OUTSET / OUTCLR / OUTTGL through the
+ *   single-cycle IOBUS port
+ * - read(): IN through the APB port. The IOBUS copy of IN is only
+ *   updated with continuous sampling, which the core leaves off.
+ *
+ * Pin direction, pull-ups and the peripheral mux are still set up with
+ * pinMode(), which is not time-critical. The pin must already be in the
+ * right mode: unlike digitalWrite(), high() on an input does not turn on
+ * the pull-up.
+ *
+ * @code
+ * static constexpr FastPin STATUS_LED(LED);
+ * STATUS_LED.high();
+ * @endcode
+ *
+ * Run fast_gpio_bench() to compare against the Arduino calls on the board.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Port and bit of Feather M0 pins 0-24: group * 32 + bit
+ *
+ * Same as g_APinDescription in the adafruit_feather_m0 variant (checked by
+ * fast_gpio_verify()). A pin number past the end fails to compile when
+ * the FastPin is constexpr.
+ */
+static constexpr uint8_t FAST_PIN_MAP[] = {
+    11, 10, 14,  9,  8, 15, 20, 21,     // D0-D7: PA11 PA10 PA14 PA09 PA08 PA15 PA20 PA21
+     6,  7, 18, 16, 19, 17,             // D8-D13: PA06 PA07 PA18 PA16 PA19 PA17
+     2, 40, 41,  4,  5, 34,             // A0-A5: PA02 PB08 PB09 PA04 PA05 PB02
+    22, 23, 12, 42, 43                  // SDA SCL MISO MOSI SCK: PA22 PA23 PA12 PB10 PB11
+};
+
+/** @brief Pins in FAST_PIN_MAP */
+#define FAST_PIN_COUNT (sizeof(FAST_PIN_MAP) / sizeof(FAST_PIN_MAP[0]))
+
+/**
+ * @brief One GPIO pin as a port group and bit mask
+ */
+struct FastPin {
+    uint8_t group;                 /**< PORT group (0 = PA, 1 = PB) */
+    uint32_t mask;                 /**< Bit of the pin in the group */
+
+    /** @param pin Arduino pin number (0 to FAST_PIN_COUNT - 1) */
+    constexpr FastPin(uint8_t pin)
+        : group(FAST_PIN_MAP[pin] >> 5), mask(1UL << (FAST_PIN_MAP[pin] & 31)) {}
+
+    /** @brief Drive high */
+    void high(void) const {
+        PORT_IOBUS->Group[group].OUTSET.reg = mask;
+    }
+
+    /** @brief Drive low */
+    void low(void) const {
+        PORT_IOBUS->Group[group].OUTCLR.reg = mask;
+    }
+
+    /** @brief Invert the output */
+    void toggle(void) const {
+        PORT_IOBUS->Group[group].OUTTGL.reg = mask;
+    }
+
+    /** @brief Drive to a level (HIGH/LOW or true/false) */
+    void write(bool level) const {
+        if (level) {
+            high();
+        } else {
+            low();
+        }
+    }
+
+    /** @brief Input level, true for HIGH (the input buffer must be on) */
+    bool read(void) const {
+        return (PORT->Group[group].IN.reg & mask) != 0;
+    }
+};
+
+/**
+ * @brief Check FAST_PIN_MAP against the core's pin table
+ *
+ * @return Number of the first pin that differs, or -1 if all match
+ */
+inline int fast_gpio_verify(void) {
+    for (uint8_t pin = 0; pin < FAST_PIN_COUNT; pin++) {
+        const PinDescription& desc = g_APinDescription[pin];
+        if (FAST_PIN_MAP[pin] != desc.ulPort * 32 + desc.ulPin) {
+            return pin;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// MICROBENCHMARK
+// ============================================================================
+
+/** @brief Calls per timing run of fast_gpio_bench() */
+#define FAST_GPIO_BENCH_CALLS 10000
+
+/**
+ * @brief Time FAST_GPIO_BENCH_CALLS passes of a loop body
+ *
+ * @return Elapsed microseconds
+ */
+#define FAST_GPIO_TIME(body)                                        \
+    ({                                                              \
+        uint32_t start_us = micros();                               \
+        for (uint32_t n = 0; n < FAST_GPIO_BENCH_CALLS; n++) {      \
+            body;                                                   \
+            __asm__ volatile("" ::: "memory");                      \
+        }                                                           \
+        micros() - start_us;                                        \
+    })
+
+/**
+ * @brief Compare FastPin with digitalWrite()/digitalRead() and print the results
+ *
+ * Toggles the given output pin as fast as it can (about 30 ms in all), so
+ * use a pin nothing is connected to, or the status LED.
+ *
+ * @param out Where to print (Serial)
+ * @param pin Output pin to exercise (must be set up with pinMode(OUTPUT))
+ */
+inline void fast_gpio_bench(Print& out, uint8_t pin) {
+    const FastPin fast(pin);
+    volatile uint32_t sink = 0;
+
+    uint32_t base_us = FAST_GPIO_TIME((void)0);
+    uint32_t dw_us = FAST_GPIO_TIME(digitalWrite(pin, n & 1));
+    uint32_t fw_us = FAST_GPIO_TIME(fast.write(n & 1));
+    uint32_t dr_us = FAST_GPIO_TIME(sink += digitalRead(pin));
+    uint32_t fr_us = FAST_GPIO_TIME(sink += fast.read());
+    fast.low();
+    (void)sink;
+
+    // Cycles per call with the bare loop taken off
+    const uint32_t mhz = F_CPU / 1000000UL;
+    out.printf("GPIO bench, pin %u, %u calls (cycles/call)\n", pin, FAST_GPIO_BENCH_CALLS);
+    out.printf("  digitalWrite %4lu   FastPin::write %4lu\n",
+               (unsigned long)((dw_us - base_us) * mhz / FAST_GPIO_BENCH_CALLS),
+               (unsigned long)((fw_us - base_us) * mhz / FAST_GPIO_BENCH_CALLS));
+    out.printf("  digitalRead  %4lu   FastPin::read  %4lu\n",
+               (unsigned long)((dr_us - base_us) * mhz / FAST_GPIO_BENCH_CALLS),
+               (unsigned long)((fr_us - base_us) * mhz / FAST_GPIO_BENCH_CALLS));
+    int bad = fast_gpio_verify();
+    if (bad >= 0) {
+        out.printf("  FAST_PIN_MAP differs from the core at pin %d\n", bad);
+    }
+}
+
+#endif // FAST_GPIO_H
@@ -0,0 +1,122 @@
+/**
+ * @file history.h
+ * @brief Multi-resolution telemetry history for the phaser
+ *
+ * Keeps a fixed-RAM time series of the phaser's sensor channels in several
+ * resolution tiers (1 s, 1 min, 15 min by default, see config.h). Each slot
+ * holds min/max/mean per channel plus the antenna direction.
+ *
+ * Downsampling is incremental: raw samples accumulate into the open tier 0
+ * slot; when a slot closes it is stored in its ring and merged into the open
+ * slot of the next tier, and so on. No pass over stored data is ever needed.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+
+// ============================================================================
+// CHANNELS AND TIERS
+// ============================================================================
+
+/** @brief Recorded sensor channels */
+enum HistoryChannel {
+    HIST_CH_BUS_MV = 0,   /**< Bus voltage (mV) */
+    HIST_CH_BUS_MA = 1,   /**< Bus current (mA) */
+    HIST_CH_MCU_MV = 2,   /**< MCU supply voltage (mV) */
+    HIST_CH_REV_DW = 3,   /**< Reverse power (0.1 W) */
+    HIST_NUM_CHANNELS = 4
+};
+
+/** @brief Number of resolution tiers */
+#define HISTORY_NUM_TIERS 3
+
+/**
+ * @brief Query cursor meaning "from the oldest record held"
+ *
+ * Not 0, because the first 1 min and 15 min slots after boot start at 0.
+ * Slot starts are multiples of 1000 ms so this value never occurs.
+ */
+#define HISTORY_SINCE_OLDEST 0xFFFFFFFFUL
+
+/** @brief Direction byte flag: direction changed during the slot */
+#define HISTORY_DIR_CHANGED 0x08
+
+/** @brief Direction byte mask for the direction (0-7) at end of slot */
+#define HISTORY_DIR_MASK 0x07
+
+// ============================================================================
+// RECORD STRUCTURE
+// ============================================================================
+
+/** @brief Summary of one channel over one slot */
+struct HistoryStat {
+    int16_t min;           /**< Minimum value */
+    int16_t max;           /**< Maximum value */
+    int16_t mean;          /**< Mean value */
+};
+
+/** @brief One closed slot in a tier */
+struct HistoryRecord {
+    uint32_t start_ms;                      /**< Phaser millis() at slot start */
+    HistoryStat ch[HIST_NUM_CHANNELS];      /**< Per-channel summary */
+    uint8_t direction;                      /**< Direction | HISTORY_DIR_CHANGED */
+};
+
+// ============================================================================
+// API
+// ============================================================================
+
+/**
+ * @brief Clear all tiers
+ */
+void history_init(void);
+
+/**
+ * @brief Add one raw sample
+ *
+ * Closes and cascades any slots whose period has elapsed before adding.
+ *
+ * @param now_ms Sample time (millis())
+ * @param values One value per HistoryChannel
+ * @param direction Antenna direction at sample time
+ */
+void history_add_sample(uint32_t now_ms, const int16_t* values, uint8_t direction);
+
+/**
+ * @brief Number of closed slots stored in a tier
+ *
+ * @param tier Tier index (0 = finest)
+ * @return Record count, 0 for an invalid tier
+ */
+uint16_t history_count(uint8_t tier);
+
+/**
+ * @brief Slot length of a tier
+ *
+ * @param tier Tier index
+ * @return Period in ms, 0 for an invalid tier
+ */
+uint32_t history_period_ms(uint8_t tier);
+
+/**
+ * @brief Copy the oldest records that start after a given time
+ *
+ * Used for chunked downloads: the caller passes the start time of the last
+ * record it already has and gets the next chunk, oldest first.
+ *
+ * @param tier Tier index
+ * @param since_ms Return records starting after this time, or
+ *                 HISTORY_SINCE_OLDEST for everything held
+ * @param out Output records
+ * @param max_records Capacity of out
+ * @return Number of records copied
+ */
+uint8_t history_query(uint8_t tier, uint32_t since_ms,
+                      HistoryRecord* out, uint8_t max_records);
+
+#endif // HISTORY_H
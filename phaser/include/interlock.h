@@ -0,0 +1,76 @@
+/**
+ * @file interlock.h
+ * @brief Hot-switch interlock: hold relay changes while RF is present
+ *
+ * Switching the phasing relays under power arcs the contacts and hands
+ * the amplifier an open circuit for a few milliseconds. A direction
+ * change requested while either power detector is above
+ * RF_SENSE_THRESHOLD_Q6 is held instead, and applied from loop() once RF
+ * has been absent for INTERLOCK_QUIET_MS. A change still held after
+ * INTERLOCK_TIMEOUT_MS is dropped. A newer request replaces a held one.
+ *
+ * The time each change waited is reported in the position reply.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef INTERLOCK_H
+#define INTERLOCK_H
+
+#include <stdint.h>
+
+/** @brief State of the last direction change, also its reply character */
+enum InterlockState {
+    INTERLOCK_CLEAR = '-',         /**< Switched at once (no RF) */
+    INTERLOCK_HELD = 'H',          /**< Held, waiting for RF to drop */
+    INTERLOCK_APPLIED = 'A',       /**< Switched after RF dropped */
+    INTERLOCK_EXPIRED = 'T'        /**< Dropped after INTERLOCK_TIMEOUT_MS */
+};
+
+/**
+ * @brief Arm the RF detector (after rf_power_init())
+ */
+void interlock_init(void);
+
+/**
+ * @brief Whether RF is present now
+ *
+ * @return true if a detector exceeded the threshold within INTERLOCK_QUIET_MS
+ */
+bool interlock_rf_present(void);
+
+/**
+ * @brief Ask to switch the relays to a direction
+ *
+ * @param direction Requested direction (0-7)
+ * @param contacts_move false if the relay pattern does not change
+ * @return true to switch now; false if the change is held
+ */
+bool interlock_request(uint8_t direction, bool contacts_move);
+
+/**
+ * @brief Hold a change that found RF present elsewhere (scheduled switch)
+ *
+ * @param direction Direction to switch to once RF drops (0-7)
+ */
+void interlock_hold(uint8_t direction);
+
+/**
+ * @brief Release a held change once RF has dropped
+ *
+ * Call from loop().
+ *
+ * @return Direction to switch to now, or -1
+ */
+int interlock_poll(void);
+
+/**
+ * @brief State of the last direction change
+ *
+ * @param wait_ms Time that change waited (so far, if still held)
+ * @return State
+ */
+InterlockState interlock_status(uint32_t& wait_ms);
+
+#endif // INTERLOCK_H
@@ -0,0 +1,190 @@
+/**
+ * @file isr_queue.h
+ * @brief Wait-free handoff from interrupt handlers to loop()
+ *
+ * Shared by the phaser, the controller and Linux host tools. Plain C++
+ * with no Arduino dependencies so the same file compiles everywhere;
+ * keep the copies in phaser/ and controller/ identical.
+ *
+ * IsrQueue is a single-producer / single-consumer ring: one interrupt
+ * handler pushes, loop() pops (or the other way round). IsrEvents is a
+ * set of event counters: a handler raises, loop() takes.
+ *
+ * The Cortex-M0+ has no LDREX/STREX, so nothing here does an atomic
+ * read-modify-write. Every shared index or counter has exactly one
+ * writer and is only ever loaded or stored whole (one 32-bit LDR/STR,
+ * which cannot be torn). Ordering uses std::atomic with acquire/release:
+ * the producer writes the slot, then publishes the index with a release
+ * store; the consumer reads the index with an acquire load before it
+ * touches the slot. On the M0+ these compile to the plain load/store and
+ * a DMB, and they also keep the compiler from caching or reordering the
+ * accesses across the handoff. The same code is correct between threads
+ * on a host, which is what the stress test in tools/ exercises.
+ *
+ * Neither side ever waits for the other: push() on a full queue drops
+ * the item and counts it, pop() on an empty queue returns false.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef ISR_QUEUE_H
+#define ISR_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+// ============================================================================
+// SINGLE-PRODUCER / SINGLE-CONSUMER QUEUE
+// ============================================================================
+
+/**
+ * @brief Fixed-size ring of N items of type T
+ *
+ * Indices run freely over 32 bits and are reduced modulo N, so all N
+ * slots are usable and full/empty never need a spare slot.
+ *
+ * @tparam T Item type (copied in and out)
+ * @tparam N Capacity, a power of two
+ */
+template <typename T, uint32_t N>
+class IsrQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "IsrQueue capacity must be a power of two");
+
+public:
+    IsrQueue() : head(0), tail(0), drops(0) {}
+
+    /**
+     * @brief Add an item (producer side only)
+     *
+     * @param item Item to copy in
+     * @return false if the queue was full; the item is dropped and counted
+     */
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) {
+            drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item (consumer side only)
+     *
+     * @param item Output
+     * @return false if the queue was empty
+     */
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) {
+            return false;
+        }
+        item = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Items waiting (exact on the consumer side, a snapshot elsewhere)
+     */
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Whether no item is waiting
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Items dropped because the queue was full
+     */
+    uint32_t dropped() const {
+        return drops.load(std::memory_order_relaxed);
+    }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head;    /**< Written by the producer only */
+    std::atomic<uint32_t> tail;    /**< Written by the consumer only */
+    std::atomic<uint32_t> drops;   /**< Written by the producer only */
+};
+
+// ============================================================================
+// EVENT FLAGS
+// ============================================================================
+
+/**
+ * @brief N events, each raised by one producer and taken by one consumer
+ *
+ * A flag is a pair of counters rather than a bit: the producer counts
+ * raises, the consumer remembers how many it has taken. Setting and
+ * clearing a shared bit would need an atomic read-modify-write, and a
+ * raise landing between the consumer's read and its clear would be lost.
+ * Raises that arrive before the consumer looks are merged into one take,
+ * but the count of them is available.
+ *
+ * Different events may be raised by different handlers, as long as each
+ * event has only one.
+ *
+ * @tparam N Number of events (at most 32, one bit each in pending())
+ */
+template <uint8_t N>
+class IsrEvents {
+    static_assert(N >= 1 && N <= 32, "IsrEvents supports 1 to 32 events");
+
+public:
+    IsrEvents() {
+        for (uint8_t i = 0; i < N; i++) {
+            raised[i].store(0, std::memory_order_relaxed);
+            taken[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Signal an event (its producer only)
+     *
+     * @param event Event number (0 to N - 1)
+     */
+    void raise(uint8_t event) {
+        uint32_t n = raised[event].load(std::memory_order_relaxed);
+        raised[event].store(n + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Consume an event if it was raised (consumer only)
+     *
+     * @param event Event number (0 to N - 1)
+     * @return Raises since the last take, 0 if none
+     */
+    uint32_t take(uint8_t event) {
+        uint32_t n = raised[event].load(std::memory_order_acquire);
+        uint32_t count = n - taken[event];
+        taken[event] = n;
+        return count;
+    }
+
+    /**
+     * @brief Events raised and not yet taken, bit i = event i (consumer only)
+     */
+    uint32_t pending() const {
+        uint32_t mask = 0;
+        for (uint8_t i = 0; i < N; i++) {
+            if (raised[i].load(std::memory_order_acquire) != taken[i]) {
+                mask |= 1UL << i;
+            }
+        }
+        return mask;
+    }
+
+private:
+    std::atomic<uint32_t> raised[N];   /**< Written by each event's producer */
+    uint32_t taken[N];                 /**< Consumer's private copy */
+};
+
+#endif // ISR_QUEUE_H
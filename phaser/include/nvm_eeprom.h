@@ -0,0 +1,76 @@
+/**
+ * @file nvm_eeprom.h
+ * @brief Wear-levelled emulated EEPROM on SAMD21 flash
+ *
+ * A record that changes often would wear out a single flash row, which is
+ * rated for about 25,000 erase cycles. Instead, each write appends a new
+ * copy of the record to the next free slot of a multi-row area. A slot is
+ * one, two or four pages, and each copy carries a sequence number and a
+ * checksum. A row is erased only when the writer wraps around to it, so
+ * every row is erased once per pass through the area. The newest valid
+ * copy is the current record, so a write interrupted by a power loss
+ * leaves the previous copy in force.
+ *
+ * Example: a 4-row area with one-page slots erases each row once every
+ * 16 writes.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef NVM_EEPROM_H
+#define NVM_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "nvm_flash.h"
+
+/** @brief Largest record: one row less the slot header */
+#define NVM_EEPROM_MAX_RECORD (NVM_ROW_SIZE - 8)
+
+/** @brief State of one emulated EEPROM area */
+struct NvmEeprom {
+    const uint8_t* area;   /**< Row-aligned flash area (NVM_FLASH_AREA) */
+    uint16_t slot_bytes;   /**< Bytes per record copy, header included */
+    uint16_t slots;        /**< Copies the area holds */
+    uint16_t record_len;   /**< Payload bytes */
+    uint16_t next_slot;    /**< Slot the next write goes to */
+    int16_t newest_slot;   /**< Slot of the current record, -1 = none */
+    uint32_t next_seq;     /**< Sequence number of the next write */
+};
+
+/**
+ * @brief Attach to an area and find the newest record
+ *
+ * @param ee State to fill in
+ * @param area Flash area from NVM_FLASH_AREA(), at least two rows
+ * @param area_bytes Size of the area
+ * @param record_len Payload size, at most NVM_EEPROM_MAX_RECORD
+ * @return false if the area or record size is unusable
+ */
+bool nvm_eeprom_init(NvmEeprom& ee, const uint8_t* area, size_t area_bytes, size_t record_len);
+
+/**
+ * @brief Read the current record
+ *
+ * @param ee Attached area
+ * @param data Output, record_len bytes
+ * @return false if no valid record has been written yet
+ */
+bool nvm_eeprom_read(const NvmEeprom& ee, void* data);
+
+/**
+ * @brief Store a new copy of the record
+ *
+ * Writes the next free slot, erasing its row first when the writer
+ * enters a new row (about 6 ms). Otherwise only page writes are needed.
+ * A slot that fails to verify is skipped.
+ *
+ * @param ee Attached area
+ * @param data Record, record_len bytes
+ * @return true once a copy reads back intact
+ */
+bool nvm_eeprom_write(NvmEeprom& ee, const void* data);
+
+#endif // NVM_EEPROM_H
@@ -0,0 +1,99 @@
+/**
+ * @file nvm_flash.h
+ * @brief Minimal SAMD21 NVM (internal flash) storage helpers
+ *
+ * The SAMD21 has no EEPROM. Persistent settings live in a row-aligned
+ * const array reserved in program flash with NVM_FLASH_AREA() and are
+ * rewritten through the NVM controller. Flash is erased a row (256 bytes)
+ * at a time and written a page (64 bytes) at a time.
+ *
+ * Reserved areas are part of the firmware image, so a full-chip erase
+ * when uploading new firmware clears them; callers must treat blank or
+ * invalid contents as "use defaults".
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef NVM_FLASH_H
+#define NVM_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** @brief Erase granularity (bytes) */
+#define NVM_ROW_SIZE 256
+
+/** @brief Write granularity (bytes) */
+#define NVM_PAGE_SIZE 64
+
+/**
+ * @brief Reserve a row-aligned area of program flash for persistent data
+ *
+ * @param name Array name
+ * @param bytes Size, rounded up to whole rows
+ */
+#define NVM_FLASH_AREA(name, bytes) \
+    __attribute__((__aligned__(NVM_ROW_SIZE), used)) \
+    static const uint8_t name[(((bytes) + NVM_ROW_SIZE - 1) / NVM_ROW_SIZE) * NVM_ROW_SIZE] = {}
+
+/**
+ * @brief Copy bytes out of a flash area
+ *
+ * Reads through a volatile pointer so the compiler cannot fold the
+ * zero initializer of the reserved array into the result.
+ *
+ * @param flash_addr Source in flash
+ * @param out Destination
+ * @param len Bytes to copy
+ */
+void nvm_read(const void* flash_addr, void* out, size_t len);
+
+/**
+ * @brief Erase and rewrite a flash area
+ *
+ * Erases every row covered by len, writes the data page by page (padding
+ * the last page with 0xFF) and reads it back. Blocks for roughly 6 ms
+ * per row.
+ *
+ * @param flash_addr Row-aligned destination in flash
+ * @param data Source
+ * @param len Bytes to write
+ * @return true if the area reads back identical to data
+ */
+bool nvm_write(const void* flash_addr, const void* data, size_t len);
+
+/**
+ * @brief Erase the rows of a flash area (to 0xFF)
+ *
+ * Blocks for roughly 6 ms per row.
+ *
+ * @param flash_addr Row-aligned start in flash
+ * @param len Bytes to erase, rounded up to whole rows
+ * @return false if flash_addr is not row-aligned
+ */
+bool nvm_erase_rows(const void* flash_addr, size_t len);
+
+/**
+ * @brief Write already-erased pages of a flash area
+ *
+ * Each page can be written once between erases. The last page is padded
+ * with 0xFF, and the data is read back.
+ *
+ * @param flash_addr Page-aligned destination in flash
+ * @param data Source
+ * @param len Bytes to write
+ * @return true if the area reads back identical to data
+ */
+bool nvm_write_pages(const void* flash_addr, const void* data, size_t len);
+
+/**
+ * @brief Fletcher-16 checksum for validating stored records
+ *
+ * @param data Bytes to check
+ * @param len Length
+ * @return Checksum; seeded so an all-zero record does not check as 0
+ */
+uint16_t nvm_checksum(const void* data, size_t len);
+
+#endif // NVM_FLASH_H
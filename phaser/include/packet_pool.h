@@ -0,0 +1,176 @@
+/**
+ * @file packet_pool.h
+ * @brief Fixed-block pool of radio packet buffers
+ *
+ * Shared by the phaser and the controller; keep the copies in phaser/ and
+ * controller/ identical. Plain C++ with no Arduino dependencies.
+ *
+ * Every frame that goes over the air lives in one Packet: it is received
+ * or built in place, authenticated in place, decoded or encoded in place
+ * and sent from the same block. A layer that is done with a packet hands
+ * the pointer on (marking the new owner) instead of copying the bytes, and
+ * the last holder releases it. The pool is a fixed array of N blocks, so
+ * the SRAM used for frames is bytes() and nothing more, however many
+ * frames are in flight; the high-water mark shows how much of it is used.
+ *
+ * alloc() and release() are O(1): free blocks form a singly linked stack
+ * through their next field. Both are for loop() only. To pass a packet
+ * out of an interrupt handler, allocate it in loop() beforehand and move
+ * the pointer through an IsrQueue.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** @brief Largest frame (RH_RF95_MAX_MESSAGE_LEN, checked where RadioHead is included) */
+#define PACKET_MTU 251
+
+/** @brief Holder of a packet, for the pool statistics and debugging */
+enum PacketOwner : uint8_t {
+    PACKET_FREE = 0,               /**< In the pool */
+    PACKET_RADIO,                  /**< Being received or sent */
+    PACKET_AUTH,                   /**< Being authenticated */
+    PACKET_CODEC,                  /**< Being encoded or decoded */
+    PACKET_APP,                    /**< Held by the application */
+    PACKET_OWNER_COUNT
+};
+
+/** @brief One MTU-sized frame buffer */
+struct Packet {
+    Packet* next;                  /**< Free list link (pool use only) */
+    uint8_t len;                   /**< Valid bytes in data */
+    uint8_t owner;                 /**< PacketOwner */
+    uint8_t data[PACKET_MTU];      /**< Frame bytes */
+};
+
+// ============================================================================
+// POOL
+// ============================================================================
+
+/**
+ * @brief N packets and a free list
+ *
+ * @tparam N Number of blocks (1 to 255)
+ */
+template <uint8_t N>
+class PacketPool {
+    static_assert(N >= 1, "PacketPool needs at least one block");
+
+public:
+    PacketPool() : free_list(NULL), used(0), peak(0), fails(0), bad(0) {
+        for (uint8_t i = N; i > 0; i--) {
+            blocks[i - 1].owner = PACKET_FREE;
+            blocks[i - 1].len = 0;
+            blocks[i - 1].next = free_list;
+            free_list = &blocks[i - 1];
+        }
+    }
+
+    /**
+     * @brief Take a free packet
+     *
+     * @param owner Layer taking it (PacketOwner)
+     * @return Empty packet (len 0), or NULL if all N are in use
+     */
+    Packet* alloc(uint8_t owner) {
+        Packet* p = free_list;
+        if (p == NULL) {
+            fails++;
+            return NULL;
+        }
+        free_list = p->next;
+        p->next = NULL;
+        p->len = 0;
+        p->owner = owner;
+        if (++used > peak) {
+            peak = used;
+        }
+        return p;
+    }
+
+    /**
+     * @brief Hand a packet to another layer
+     *
+     * @param p Packet (may be NULL)
+     * @param owner New holder (PacketOwner)
+     * @return p, so the call can wrap the pointer being handed on
+     */
+    Packet* pass(Packet* p, uint8_t owner) {
+        if (p != NULL) {
+            p->owner = owner;
+        }
+        return p;
+    }
+
+    /**
+     * @brief Return a packet to the pool and clear the caller's pointer
+     *
+     * Pointers that are not from this pool, and packets already free, are
+     * ignored and counted in misuse().
+     *
+     * @param p Packet (may be NULL); set to NULL
+     */
+    void release(Packet*& p) {
+        if (p == NULL) {
+            return;
+        }
+        if (!owns(p) || p->owner == PACKET_FREE) {
+            bad++;
+            p = NULL;
+            return;
+        }
+        p->owner = PACKET_FREE;
+        p->next = free_list;
+        free_list = p;
+        used--;
+        p = NULL;
+    }
+
+    /** @brief Whether a pointer is one of this pool's blocks */
+    bool owns(const Packet* p) const {
+        return p >= &blocks[0] && p < &blocks[N];
+    }
+
+    /** @brief Packets currently allocated */
+    uint8_t in_use(void) const { return used; }
+
+    /** @brief Most packets ever allocated at once */
+    uint8_t high_water(void) const { return peak; }
+
+    /** @brief alloc() calls that found the pool empty */
+    uint32_t failures(void) const { return fails; }
+
+    /** @brief release() calls with a foreign or already free packet */
+    uint32_t misuse(void) const { return bad; }
+
+    /** @brief Packets allocated to one holder */
+    uint8_t held_by(uint8_t owner) const {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < N; i++) {
+            n += (blocks[i].owner == owner);
+        }
+        return n;
+    }
+
+    /** @brief Number of blocks */
+    static uint8_t capacity(void) { return N; }
+
+    /** @brief SRAM taken by the blocks */
+    static size_t bytes(void) { return sizeof(Packet) * N; }
+
+private:
+    Packet blocks[N];
+    Packet* free_list;
+    uint8_t used;
+    uint8_t peak;
+    uint32_t fails;
+    uint32_t bad;
+};
+
+#endif // PACKET_POOL_H
@@ -0,0 +1,62 @@
+/**
+ * @file protection.h
+ * @brief INA3221 alert-driven overcurrent and undervoltage protection
+ *
+ * The INA3221 compares the relay load current (channel 0) against two
+ * limits in hardware and pulls an alert pin low when one is exceeded:
+ * - critical (PROTECT_CRITICAL_MA), every conversion: the pin interrupt
+ *   releases every relay within microseconds, without waiting for I2C
+ * - warning (PROTECT_WARNING_MA), averaged value: reported only
+ *
+ * The INA3221's power-valid output cannot watch the bus alone because
+ * channel 1 monitors the 5 V rail, so undervoltage is checked from
+ * protection_poll() every PROTECT_UV_POLL_MS instead.
+ *
+ * After a trip the relays are held released for PROTECT_HOLDOFF_MS and
+ * until the fault has cleared. Faults are reported to the controller as
+ * unsolicited event frames.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef PROTECTION_H
+#define PROTECTION_H
+
+#include <stdint.h>
+#include "Adafruit_INA3221.h"
+
+/** @brief Fault bits */
+enum ProtectFault {
+    PROTECT_NONE = 0,
+    PROTECT_OVERCURRENT = 1 << 0,   /**< Critical alert: relays dropped */
+    PROTECT_WARNING = 1 << 1,       /**< Warning alert: reported only */
+    PROTECT_UNDERVOLTAGE = 1 << 2,  /**< Bus below PROTECT_UNDERVOLT_MV: relays dropped */
+    PROTECT_CLEARED = 1 << 3        /**< Trip hold-off over, relays usable again */
+};
+
+/**
+ * @brief Program the INA3221 alert limits and attach the alert interrupts
+ *
+ * @param ina Initialised INA3221 (channel 0 = relay load)
+ */
+void protection_init(Adafruit_INA3221& ina);
+
+/**
+ * @brief Check undervoltage and collect faults raised since the last call
+ *
+ * Call from loop(). Reads the bus voltage over I2C at most every
+ * PROTECT_UV_POLL_MS.
+ *
+ * @return ProtectFault bits to report (PROTECT_NONE if nothing new)
+ */
+uint8_t protection_poll(void);
+
+/**
+ * @brief Whether the relays are being held released after a trip
+ *
+ * @return true while direction changes must be refused
+ */
+bool protection_tripped(void);
+
+#endif // PROTECTION_H
@@ -44,6 +44,87 @@
 /** @brief PTT / Power request command */
 #define CMD_TYPE_POWER 'V'
 
+/** @brief Telemetry history query: HTSSSSSSSS (T = tier, S = since, hex ms) */
+#define CMD_TYPE_HISTORY 'H'
+
+/** @brief Length of the history query command */
+#define CMD_HISTORY_LEN 10
+
+/** @brief Compressed bulk history download: BTSSSSSSSS (same fields as H) */
+#define CMD_TYPE_BULK 'B'
+
+/** @brief Length of the bulk download command */
+#define CMD_BULK_LEN 10
+
+/** @brief Bulk chunk retransmit request: RSSMMMM (S = session, M = chunk mask, hex) */
+#define CMD_TYPE_RESEND 'R'
+
+/** @brief Length of the bulk retransmit command */
+#define CMD_RESEND_LEN 7
+
+/** @brief Reverse power calibration: "C" + sub-command (see below) */
+#define CMD_TYPE_CAL 'C'
+
+/** @brief Calibration sub-commands */
+#define CAL_SUB_BEGIN 'B'        // CB: start calibrating the current direction
+#define CAL_SUB_POINT 'P'        // CPNNNNN: record point, N = reference power, 0.1 W
+#define CAL_SUB_END 'E'          // CE: install and save the working table
+#define CAL_SUB_ABORT 'A'        // CA: discard the working table
+#define CAL_SUB_QUERY 'Q'        // CQ: report the current direction's table
+#define CAL_SUB_DEFAULT 'D'      // CD: restore the current direction's default
+
+/** @brief Length of the calibration commands other than CP */
+#define CMD_CAL_LEN 2
+
+/** @brief Length of the calibration point command */
+#define CMD_CAL_POINT_LEN 7
+
+/** @brief Forget the learned relay coil currents and learn them again */
+#define CMD_TYPE_RELEARN 'L'
+
+/** @brief Sensor statistics query: "S" + scope (A = all, 0-7 = direction, R = reset) */
+#define CMD_TYPE_STATS 'S'
+
+/** @brief Statistics scopes other than a direction digit */
+#define STATS_SUB_ALL 'A'        // SA: all samples since reset
+#define STATS_SUB_RESET 'R'      // SR: clear all statistics, then report SA
+
+/** @brief Length of the statistics command */
+#define CMD_STATS_LEN 2
+
+/** @brief Relay operation counters: "OQ" = report, "OZnn" = restart relay nn (01-99) */
+#define CMD_TYPE_WEAR 'O'
+
+/** @brief Operation counter sub-commands */
+#define WEAR_SUB_QUERY 'Q'       // OQ: report the counters
+#define WEAR_SUB_CLEAR 'Z'       // OZnn: zero relay nn after replacing it, then report
+
+/** @brief Length of the counter query */
+#define CMD_WEAR_LEN 2
+
+/** @brief Length of the counter clear command */
+#define CMD_WEAR_CLEAR_LEN 4
+
+/** @brief Scheduled direction changes: "TAXXXXXXXXD" = add, "TC" = clear, "TQ" = query */
+#define CMD_TYPE_SCHEDULE 'T'
+
+/** @brief Schedule sub-commands */
+#define SCHED_SUB_ADD 'A'        // TAXXXXXXXXD: switch to D at phaser millis() XXXXXXXX (hex)
+#define SCHED_SUB_CLEAR 'C'      // TC: drop every queued entry
+#define SCHED_SUB_QUERY 'Q'      // TQ: report the queue
+
+/** @brief Length of the clear and query commands */
+#define CMD_SCHED_LEN 2
+
+/** @brief Length of the add command */
+#define CMD_SCHED_ADD_LEN 11
+
+/** @brief Relay map profile select: "P" + profile (hex digit), replies with the position */
+#define CMD_TYPE_PROFILE 'P'
+
+/** @brief Length of the profile command */
+#define CMD_PROFILE_LEN 2
+
 /** @brief Information request commands */
 #define CMD_TYPE_INFO_M 'M'      // Execute movement
 #define CMD_TYPE_INFO_I 'I'      // Report information/position
@@ -71,6 +152,102 @@
 /** @brief Battery voltage field marker */
 #define REPLY_FIELD_BATT 'b'
 
+/** @brief Position reply field: last relay switch check, result + step in mA */
+#define REPLY_FIELD_RELAY 'k'
+
+/** @brief Position reply field: hot-switch interlock state + wait in ms */
+#define REPLY_FIELD_INTERLOCK 'w'
+
+/** @brief Position reply field: relay map profile in use, 1 hex digit */
+#define REPLY_FIELD_PROFILE 'g'
+
+/** @brief Power reply field: peak-hold (PEP) reverse power, 6 chars in W */
+#define REPLY_FIELD_PEAK 'p'
+
+/** @brief Power reply field: decaying envelope reverse power, 6 chars in W */
+#define REPLY_FIELD_ENV 'e'
+
+/** @brief Power reply field: average forward power, 6 chars in W */
+#define REPLY_FIELD_FWD 'f'
+
+/** @brief Power reply field: SWR x 100, 4 digits (0000 = no carrier) */
+#define REPLY_FIELD_SWR 's'
+
+/** @brief Power reply field: return loss in 0.1 dB, 3 digits */
+#define REPLY_FIELD_RL 'l'
+
+/** @brief Power reply field: highest SWR x 100 over the SWR window, 4 digits */
+#define REPLY_FIELD_SWR_MAX 'x'
+
+/** @brief History reply prefix */
+#define REPLY_PREFIX_HIST 'H'
+
+/** @brief Characters per record in a history reply */
+#define HISTORY_RECORD_TEXT_LEN 57
+
+/** @brief Bulk session reply prefix */
+#define REPLY_PREFIX_BULK 'B'
+
+/** @brief Length of the bulk session reply (before the time-sync trailer) */
+#define REPLY_BULK_FIELD_LEN 15
+
+/** @brief Bulk retransmit reply prefix */
+#define REPLY_PREFIX_RESEND 'R'
+
+/** @brief Calibration reply prefix */
+#define REPLY_PREFIX_CAL 'C'
+
+/** @brief Sensor statistics reply prefix */
+#define REPLY_PREFIX_STATS 'S'
+
+/** @brief Length of the statistics reply header */
+#define REPLY_STATS_HEADER_LEN 10
+
+/** @brief Characters per channel in a statistics reply */
+#define STATS_CHANNEL_TEXT_LEN 20
+
+/** @brief Relay operation counter reply prefix */
+#define REPLY_PREFIX_WEAR 'O'
+
+/** @brief Length of the counter reply header: 'O' + relay count + direction changes */
+#define REPLY_WEAR_HEADER_LEN 11
+
+/** @brief Characters per relay in a counter reply */
+#define WEAR_RELAY_TEXT_LEN 8
+
+/** @brief Schedule reply prefix */
+#define REPLY_PREFIX_SCHEDULE 'T'
+
+/** @brief Length of the schedule reply: 'T' + sub-command + status + 2 hex pending */
+#define REPLY_SCHED_LEN 5
+
+/** @brief Scheduled change confirmations prefix (sent unsolicited) */
+#define REPLY_PREFIX_SCHED_REPORT 'X'
+
+/** @brief Characters per confirmation */
+#define SCHED_REPORT_TEXT_LEN 14
+
+/** @brief Most confirmations in one frame (one hex digit) */
+#define SCHED_REPORT_MAX 15
+
+/** @brief Unsolicited protection event prefix */
+#define REPLY_PREFIX_EVENT 'E'
+
+/** @brief Protection event codes */
+#define EVENT_OVERCURRENT 'C'    // Critical current alert, relays released
+#define EVENT_WARNING 'W'        // Warning current alert
+#define EVENT_UNDERVOLTAGE 'U'   // Bus undervoltage, relays released
+#define EVENT_CLEARED 'K'        // Trip cleared, direction changes accepted again
+
+/** @brief Length of an event frame */
+#define REPLY_EVENT_LEN 14
+
+/** @brief Time-sync field marker (appended to every reply) */
+#define REPLY_FIELD_TIME 't'
+
+/** @brief Length of the time-sync field: 't' + 8 hex (rx) + 8 hex (tx) */
+#define REPLY_TIME_FIELD_LEN 17
+
 // ============================================================================
 // REPLY STRUCTURE
 // ============================================================================
@@ -91,16 +268,182 @@
  * - III = 3-digit current in mA (e.g., 500)
  * - b = Battery field marker
  * - BBBB = 4-digit battery voltage (e.g., 4200 = 4.2V)
+ *
+ * followed by the relay check of the last switch, "kXSSSSS":
+ * - k = Relay check field marker
+ * - X = V (verified), F (failed), L (pattern current learned),
+ *   - (no switch yet, or same relay pattern)
+ * - SSSSS = Measured coil current step, signed mA (e.g., +0045)
+ *
+ * and the hot-switch interlock state of the last direction change, "wXWWWWW":
+ * - w = Interlock field marker
+ * - X = - (switched at once), H (held while RF is present),
+ *   A (switched after RF dropped), T (dropped after the timeout)
+ * - WWWWW = Time the change waited, or has waited so far, in ms (max 99999)
  */
 
 /**
  * @brief Power report reply format:
  *
- * "VPPPPPP"
+ * "VPPPPPPpKKKKKKeEEEEEEfFFFFFFsSSSSlLLLxXXXX"
  *
  * Where:
  * - V = Power reply marker
- * - PPPPPP = 6 characters of power/voltage reading (e.g., "1500.6" = 1500.6W)
+ * - PPPPPP = 6 characters of average reverse power (e.g., "1500.6" = 1500.6W)
+ * - p = Peak field marker
+ * - KKKKKK = peak-hold (PEP) reverse power, same format
+ * - e = Envelope field marker
+ * - EEEEEE = decaying envelope reverse power, same format
+ * - f = Forward field marker
+ * - FFFFFF = average forward power, same format
+ * - s = SWR field marker
+ * - SSSS = SWR x 100 (e.g., "0136" = 1.36:1, "0000" = no carrier)
+ * - l = Return loss field marker
+ * - LLL = return loss in 0.1 dB (e.g., "230" = 23.0 dB)
+ * - x = Window max field marker
+ * - XXXX = highest SWR x 100 over the last SWR_WINDOW_SAMPLES readings
+ */
+
+/**
+ * @brief History reply format:
+ *
+ * "HTN" followed by N records of "SSSSSSSSD" + 4 x "mmmmMMMMaaaa"
+ *
+ * Where:
+ * - H = History reply marker
+ * - T = Tier digit (0 = 1 s, 1 = 1 min, 2 = 15 min)
+ * - N = Number of records in this chunk (0 = no more data)
+ * - SSSSSSSS = Slot start, phaser millis() (hex)
+ * - D = Direction at end of slot, bit 3 set if it changed during the slot (hex)
+ * - mmmm/MMMM/aaaa = min/max/mean per channel as 16-bit two's complement hex,
+ *   channels in order: bus mV, bus mA, MCU mV, reverse power 0.1 W
+ *
+ * Records are oldest first. To fetch the next chunk the controller repeats
+ * the query with S = start time of the last record received; S = FFFFFFFF
+ * starts from the oldest record held.
+ */
+
+/**
+ * @brief Bulk download session reply format:
+ *
+ * "BTSSCCLLLLLLLLM"
+ *
+ * Where:
+ * - B = Bulk session reply marker
+ * - T = Tier digit
+ * - SS = Session id (hex)
+ * - CC = Number of data chunks that follow (hex)
+ * - LLLLLLLL = Start time of the newest record in the session (hex)
+ * - M = '1' if more records remain for a follow-up session, else '0'
+ *
+ * After this reply is ACKed the phaser streams CC binary chunks (see
+ * bulk_codec.h) as unacknowledged datagrams. The controller asks for any
+ * it missed with RSSMMMM; the phaser answers "RSSMMMM" with the mask it
+ * will resend (0000 if the session is no longer current) and streams them.
+ */
+
+/**
+ * @brief Calibration reply format:
+ *
+ * "CXSDFN" followed by N points of "AAAAPPPP"
+ *
+ * Where:
+ * - C = Calibration reply marker
+ * - X = Sub-command being answered (B, P, E, A, Q or D)
+ * - S = Status digit (CalStatus, 0 = OK)
+ * - D = Direction digit
+ * - F = 'W' while a calibration session is open and the working table is
+ *   listed, '1' for a stored table, '0' for the default table
+ * - N = Number of points (hex)
+ * - AAAA = Detector reading, Q6 10-bit ADC counts (hex)
+ * - PPPP = Reverse power, 0.1 W (hex)
+ */
+
+/**
+ * @brief Sensor statistics reply format:
+ *
+ * "SXNNNNNNNN" followed by 4 x "mmmmMMMMaaaaVVVVVVVV"
+ *
+ * Where:
+ * - S = Statistics reply marker
+ * - X = Scope answered (A or a direction digit; R is answered as A)
+ * - NNNNNNNN = Samples in the scope (hex)
+ * - Per channel (bus mV, bus mA, MCU mV, reverse power 0.1 W):
+ *   mmmm = minimum, MMMM = maximum, aaaa = mean (int16, hex),
+ *   VVVVVVVV = sample variance in units squared (hex)
+ */
+
+/**
+ * @brief Relay operation counter reply format:
+ *
+ * "ONNCCCCCCCC" followed by NN x "OOOOOOOO"
+ *
+ * Where:
+ * - O = Counter reply marker
+ * - NN = Relays reported (hex)
+ * - CCCCCCCC = Direction changes that moved at least one relay (hex)
+ * - OOOOOOOO = Transitions of relay 1, 2, ... (hex), counting both
+ *   pull-in and release
+ *
+ * Counts are kept in RAM and saved in batches, so a power loss can lose
+ * the last few minutes of operations.
+ */
+
+/**
+ * @brief Schedule reply format:
+ *
+ * "TXSNN"
+ *
+ * Where:
+ * - T = Schedule reply marker
+ * - X = Sub-command answered (A, C or Q)
+ * - S = Status digit (ScheduleStatus: 0 = OK, 1 = queue full,
+ *   2 = time already past or too far ahead)
+ * - NN = Entries queued (hex)
+ */
+
+/**
+ * @brief Scheduled change confirmations (sent unsolicited, no time-sync trailer):
+ *
+ * "XN" followed by N x "DTTTTTTTTLLLLR"
+ *
+ * Where:
+ * - X = Confirmation marker
+ * - N = Confirmations in the frame (hex)
+ * - D = Direction digit
+ * - TTTTTTTT = Scheduled time, phaser millis() (hex)
+ * - LLLL = Relay write time minus scheduled time, us (int16, hex)
+ * - R = Result (A = switched, H = RF present, held by the interlock,
+ *   P = protection trip, not switched)
+ */
+
+/**
+ * @brief Protection event frame (sent unsolicited, no time-sync trailer):
+ *
+ * "EXDvVVVVViIIII"
+ *
+ * Where:
+ * - E = Event marker
+ * - X = Event code (C, W, U or K)
+ * - D = Direction digit after the event
+ * - v = Voltage field marker
+ * - VVVVV = 5-digit bus voltage in mV
+ * - i = Current field marker
+ * - IIII = 4-digit relay load current in mA
+ */
+
+/**
+ * @brief Time-sync trailer appended to every reply:
+ *
+ * "tRRRRRRRRXXXXXXXX"
+ *
+ * Where:
+ * - t = Time field marker
+ * - RRRRRRRR = phaser millis() when the command was received (hex)
+ * - XXXXXXXX = phaser millis() when the reply was handed to the radio (hex)
+ *
+ * These are the NTP T2/T3 timestamps. The controller supplies T1/T4 from
+ * its own clock, so no extra bytes are added to commands.
  */
 
 // ============================================================================
@@ -0,0 +1,98 @@
+/**
+ * @file relay_verify.h
+ * @brief Relay actuation verification from the coil-current signature
+ *
+ * Every relay pattern draws a characteristic coil current on the relay
+ * load channel (INA3221 channel 0). Around each switch the INA3221 is put
+ * into its fastest single-conversion mode for a few milliseconds, and the
+ * change in load current is compared with the change expected from the
+ * learned current of the old and new patterns. A stuck, open or shorted
+ * coil makes the step wrong and the switch is reported as failed.
+ *
+ * The current of each table position's pattern (every direction of every
+ * relay map profile) is learned on the first switch into it and kept in
+ * flash, so verification works from the first switch after a restart.
+ * relay_verify_forget() starts learning again (e.g. after replacing a
+ * relay board).
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef RELAY_VERIFY_H
+#define RELAY_VERIFY_H
+
+#include <stdint.h>
+#include "Adafruit_INA3221.h"
+
+/** @brief Outcome of the last switch, also its reply character */
+enum RelayVerifyResult {
+    RELAY_VERIFY_NONE = '-',       /**< No switch yet, or pattern unchanged */
+    RELAY_VERIFY_OK = 'V',         /**< Step matched the learned currents */
+    RELAY_VERIFY_LEARNED = 'L',    /**< New pattern current learned, nothing to compare */
+    RELAY_VERIFY_FAILED = 'F'      /**< Step outside tolerance */
+};
+
+/**
+ * @brief Load the learned pattern currents from flash
+ *
+ * @param ina Initialised INA3221 (channel 0 = relay load)
+ */
+void relay_verify_init(Adafruit_INA3221& ina);
+
+/**
+ * @brief Take the baseline and switch the INA3221 to fast conversions
+ *
+ * The old pattern is put back on full drive (relays_full_drive()) and
+ * sampled like relay_verify_end() samples the new one, about 3 ms. Call
+ * immediately before writing the relay pins. Does nothing (and the
+ * result becomes RELAY_VERIFY_NONE) if both positions use the same
+ * relay pattern.
+ *
+ * @param from_position Table position before the switch (relays_position())
+ * @param to_position Table position after the switch
+ */
+void relay_verify_begin(uint8_t from_position, uint8_t to_position);
+
+/**
+ * @brief Sample the coil current after the switch and check the step
+ *
+ * Call immediately after writing the relay pins. Blocks for about
+ * RELAY_VERIFY_SETTLE_US + RELAY_VERIFY_SAMPLES x RELAY_VERIFY_SAMPLE_US
+ * (about 3 ms) and restores the normal INA3221 averaging.
+ *
+ * @return Result, also kept for relay_verify_last()
+ */
+RelayVerifyResult relay_verify_end(void);
+
+/**
+ * @brief Abandon a relay_verify_begin() whose switch did not happen
+ *
+ * Restores the normal INA3221 averaging; nothing is learned or checked.
+ */
+void relay_verify_cancel(void);
+
+/**
+ * @brief Result of the last switch
+ *
+ * @param step_ma Measured current step of that switch (mA)
+ * @return Result
+ */
+RelayVerifyResult relay_verify_last(int16_t& step_ma);
+
+/**
+ * @brief Forget every learned pattern current (in RAM and flash)
+ *
+ * Flash is cleared by the next relay_verify_poll().
+ */
+void relay_verify_forget(void);
+
+/**
+ * @brief Save newly learned currents once learning has paused
+ *
+ * Writes flash RELAY_VERIFY_SAVE_QUIET_MS after the last change, and not
+ * while a scheduled change is due. Call from the flush task.
+ */
+void relay_verify_poll(void);
+
+#endif // RELAY_VERIFY_H
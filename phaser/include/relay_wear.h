@@ -0,0 +1,77 @@
+/**
+ * @file relay_wear.h
+ * @brief Per-relay operation counters kept in wear-levelled flash
+ *
+ * Every direction change adds one to the counter of each relay whose
+ * state actually toggles. Counting is an XOR of the two packed patterns
+ * and one increment per toggled relay, in RAM. The counters reach flash
+ * later, from loop(): after RELAY_WEAR_FLUSH_OPS operations, or
+ * RELAY_WEAR_FLUSH_MS after the oldest unsaved one, and only once no
+ * switch has happened for RELAY_WEAR_QUIET_MS and no scheduled change is
+ * due within SCHEDULE_FLASH_GUARD_MS. The switching path never waits for
+ * flash.
+ *
+ * A power loss forgets at most the operations since the last flush.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef RELAY_WEAR_H
+#define RELAY_WEAR_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+/**
+ * @brief Load the counters from flash (zero if none are stored)
+ *
+ * @param held Pattern the relays hold now
+ */
+void relay_wear_init(const uint8_t held[RELAY_PATTERN_BYTES]);
+
+/**
+ * @brief Count the relays that toggle to a new pattern
+ *
+ * @param pattern Pattern just written to the relays
+ */
+void relay_wear_count(const uint8_t pattern[RELAY_PATTERN_BYTES]);
+
+/**
+ * @brief Count a protection release (every relay drops out)
+ */
+void relay_wear_release(void);
+
+/**
+ * @brief Flush the counters to flash when a batch is due
+ *
+ * Call from loop().
+ */
+void relay_wear_poll(void);
+
+/**
+ * @brief Operations of one relay
+ *
+ * @param relay Relay (0 to RELAY_COUNT - 1)
+ * @return Transitions counted, saved or not
+ */
+uint32_t relay_wear_ops(uint8_t relay);
+
+/**
+ * @brief Direction changes that moved at least one relay
+ *
+ * @return Count since the counters were first stored
+ */
+uint32_t relay_wear_changes(void);
+
+/**
+ * @brief Restart one relay's count after it has been replaced
+ *
+ * Saved at once.
+ *
+ * @param relay Relay (0 to RELAY_COUNT - 1)
+ */
+void relay_wear_clear(uint8_t relay);
+
+#endif // RELAY_WEAR_H
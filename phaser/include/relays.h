@@ -0,0 +1,141 @@
+/**
+ * @file relays.h
+ * @brief Relay output backends: GPIO pins or DMA-loaded shift registers
+ *
+ * Patterns are packed bitmasks from the relay tables in config.h
+ * (RELAY_PATTERN_BYTES bytes, relay n = bit n % 8 of byte n / 8), so the
+ * rest of the firmware does not depend on how many relays there are or
+ * how they are wired.
+ *
+ * The GPIO backend writes RELAY_1 ... RELAY_78 one after the other. The
+ * SPI backend copies the pattern into a transmit buffer, and one DMA
+ * transfer clocks it through the shift-register chain on SERCOM1. The
+ * DMA-complete interrupt pulses the storage clock, so every output
+ * changes on the same edge, however long the chain.
+ *
+ * Coils are driven as set by RELAY_DRIVE: continuously, at a PWM hold
+ * current after a full-voltage pull-in, or by set/reset pulses to
+ * latching relays.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef RELAYS_H
+#define RELAYS_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+/**
+ * @brief Configure the relay outputs, all released
+ */
+void relays_init(void);
+
+/**
+ * @brief Drive every relay output from a packed pattern
+ *
+ * With the SPI backend the transfer runs in the background and the
+ * outputs change a few microseconds after the call returns. A write that
+ * finds a transfer in progress never waits for it: the pattern is kept
+ * and the DMA-complete interrupt shifts it in instead of latching the
+ * earlier one (a third write replaces it), so the newest pattern wins.
+ *
+ * Rule for this module: nothing may wait for the DMA to finish. Its
+ * interrupt is below the schedule timer's priority and cannot run with
+ * interrupts masked, so a wait there would never end.
+ *
+ * Refused while protection_tripped(). The check and the write are one
+ * critical section, so a trip cannot land between them and have its
+ * release undone.
+ *
+ * Safe to call from any interrupt and with interrupts masked; it never
+ * touches flash.
+ *
+ * @param pattern RELAY_PATTERN_BYTES bytes, e.g. relays_pattern(position)
+ * @return false if refused after a protection trip (relays left released)
+ */
+bool relays_write(const uint8_t pattern[RELAY_PATTERN_BYTES]);
+
+/**
+ * @brief Put the energised coils back on full voltage until the next write
+ *
+ * With RELAY_DRIVE_PWM this ends the hold early, so the relay verifier can
+ * read the current of the old pattern in the same state as the new one
+ * during its pull-in. Does nothing with the other drives, after a release,
+ * or while a write is still shifting out.
+ */
+void relays_full_drive(void);
+
+/**
+ * @brief Save the latched pattern to flash after a change
+ *
+ * Call from loop(). Does nothing unless RELAY_DRIVE is RELAY_DRIVE_LATCH.
+ * The pattern goes to wear-levelled flash (nvm_eeprom.h) once the relays
+ * have not moved for RELAY_STATE_QUIET_MS.
+ */
+void relays_poll(void);
+
+/**
+ * @brief Release every relay at once
+ *
+ * Safe to call from an interrupt. With the SPI backend this only raises
+ * the output enable, which stays high until the next relays_write().
+ */
+void relays_release(void);
+
+/**
+ * @brief Select the relay map profile used for later switches
+ *
+ * Only changes the table lookup; the relays move with the next switch.
+ * Safe against the schedule timer, which reads the profile once per
+ * change.
+ *
+ * @param profile Profile (0 to RELAY_PROFILE_COUNT - 1)
+ * @return false if out of range (profile unchanged)
+ */
+bool relays_set_profile(uint8_t profile);
+
+/**
+ * @brief Relay map profile in use
+ */
+uint8_t relays_profile(void);
+
+/**
+ * @brief Table position of a direction in the active profile
+ *
+ * @param direction Direction (0-7)
+ * @return Position (0 to RELAY_POSITION_COUNT - 1)
+ */
+uint8_t relays_position(uint8_t direction);
+
+/**
+ * @brief Pattern of a table position
+ *
+ * @param position Position from relays_position()
+ * @return RELAY_PATTERN_BYTES bytes in flash
+ */
+const uint8_t* relays_pattern(uint8_t position);
+
+/**
+ * @brief Whether two table positions drive the relays the same way
+ *
+ * @param a Position
+ * @param b Position
+ * @return true if their patterns are identical (no contact moves)
+ */
+bool relays_same_pattern(uint8_t a, uint8_t b);
+
+/**
+ * @brief Table position the relays are in at power-up
+ *
+ * Latching relays keep their state without power; it is read back from
+ * the pattern saved by relays_poll() and looked up in every profile.
+ * Other relays are all released at power-up.
+ *
+ * @return Position whose pattern was last latched, else DIR_N of profile 0
+ */
+uint8_t relays_startup_position(void);
+
+#endif // RELAYS_H
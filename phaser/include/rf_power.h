@@ -0,0 +1,97 @@
+/**
+ * @file rf_power.h
+ * @brief Continuous forward/reverse power sampler with peak-hold, envelope and RMS
+ *
+ * The forward and reverse power detectors (FWD_POWER_PIN, REV_POWER_PIN)
+ * are sampled in the background at about RF_SAMPLE_RATE_HZ each by the
+ * SAMD21 ADC, free-running with hardware averaging and DMA, as
+ * back-to-back pairs so the two channels see the same point of the
+ * modulation. Every sample updates, in O(1):
+ * - a ring of RF_BUCKET_MS buckets holding sum, sum of squares and max
+ * - a fast-attack, exponential-release envelope
+ *
+ * Windowed mean, RMS and peak-hold are assembled from the buckets on demand,
+ * so a 'V' reply costs a few microseconds instead of a 100 ms blocking
+ * average, and SSB/CW peaks are no longer averaged away.
+ *
+ * The ADC window monitor also flags any result above a threshold, which
+ * the hot-switch interlock uses to tell when RF is present.
+ *
+ * All values are detector voltages in Q6 10-bit ADC counts: 64 = one count
+ * of the original 10-bit analogRead() scale, 65535 = full scale; with
+ * 16x averaging the bottom two fractional bits are real resolution. The
+ * ADC is owned by this module; do not call analogRead() once it is running.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef RF_POWER_H
+#define RF_POWER_H
+
+#include <stdint.h>
+
+/** @brief Fractional bits of the sampler's count scale */
+#define RF_Q_SHIFT 6
+
+/** @brief Sampled detector channels */
+enum RfChannel {
+    RF_CH_REV = 0,         /**< Reverse power detector */
+    RF_CH_FWD = 1,         /**< Forward power detector */
+    RF_NUM_CHANNELS = 2
+};
+
+/** @brief Snapshot of one channel's statistics */
+struct RfPowerStats {
+    uint16_t mean;         /**< Mean over RF_RMS_BUCKETS */
+    uint16_t rms;          /**< RMS over RF_RMS_BUCKETS */
+    uint16_t peak;         /**< Peak-hold over RF_PEAK_HOLD_BUCKETS */
+    uint16_t envelope;     /**< Decaying envelope, current value */
+    uint32_t samples;      /**< Total samples taken since start */
+};
+
+/**
+ * @brief Configure the ADC and its DMA channel and start sampling
+ *
+ * @return false if FWD_POWER_PIN is not the ADC input after REV_POWER_PIN
+ */
+bool rf_power_init(void);
+
+/**
+ * @brief Take a consistent snapshot of one channel's statistics
+ *
+ * @param channel Channel to read
+ * @param stats Output snapshot
+ */
+void rf_power_read(RfChannel channel, RfPowerStats& stats);
+
+/**
+ * @brief Feed one sample into a channel's statistics
+ *
+ * Called from the DMA interrupt; exposed so other sampling back ends can
+ * reuse the same statistics. Buckets advance on time, not sample count.
+ *
+ * @param channel Channel the sample belongs to
+ * @param value Detector voltage, Q6 10-bit counts
+ */
+void rf_power_add_sample(RfChannel channel, uint16_t value);
+
+/**
+ * @brief Arm the RF-present detector on the ADC window monitor
+ *
+ * Every forward and reverse result above the threshold is flagged by the
+ * ADC in hardware. The interrupt is taken at most once per DMA block,
+ * so a carrier costs one extra interrupt every few milliseconds.
+ *
+ * @param threshold_q6 Detector level, Q6 10-bit counts
+ */
+void rf_power_sense_arm(uint16_t threshold_q6);
+
+/**
+ * @brief Time since either detector last exceeded the sense threshold
+ *
+ * @return Milliseconds, or UINT32_MAX if it never has (or is not armed)
+ */
+uint32_t rf_power_sense_quiet_ms(void);
+
+#endif // RF_POWER_H
@@ -0,0 +1,134 @@
+/**
+ * @file schedule.h
+ * @brief Direction changes queued ahead and executed by a hardware timer
+ *
+ * The controller queues (time, direction) entries on the phaser's own
+ * millis() timebase (it converts with its time-sync estimate), so radio
+ * retries no longer add to the switching time. TC3 runs a chain of
+ * one-shots towards the earliest entry, and its interrupt writes the
+ * relays within a few microseconds of the due time, whatever loop() is
+ * doing. A long radio exchange cannot delay it. The one thing that could,
+ * a flash erase stalling the CPU, is kept clear of due entries: no flash
+ * write starts within SCHEDULE_FLASH_GUARD_MS of one.
+ *
+ * The interrupt does only the relay write. loop() picks up each executed
+ * entry with schedule_next_fired() for the bookkeeping, and the
+ * confirmations are kept until they have been reported to the controller
+ * in one batch.
+ *
+ * A change that finds RF present is not made; it is handed to the
+ * interlock instead. A change during a protection trip is dropped.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdint.h>
+
+/** @brief Result of queueing an entry, also the status digit of the reply */
+enum ScheduleStatus {
+    SCHEDULE_OK = 0,               /**< Queued */
+    SCHEDULE_FULL = 1,             /**< SCHEDULE_MAX_ENTRIES already queued */
+    SCHEDULE_BAD_TIME = 2          /**< Already past, or beyond SCHEDULE_MAX_AHEAD_MS */
+};
+
+/** @brief What happened at the due time, also the report character */
+enum ScheduleResult {
+    SCHEDULE_APPLIED = 'A',        /**< Relays switched */
+    SCHEDULE_HELD = 'H',           /**< RF present, handed to the interlock */
+    SCHEDULE_BLOCKED = 'P'         /**< Protection trip, not switched */
+};
+
+/** @brief Confirmation of one executed entry */
+struct ScheduleReport {
+    uint32_t due_ms;               /**< Scheduled time, phaser millis() */
+    int16_t late_us;               /**< Time of the write minus due time (us) */
+    uint8_t direction;             /**< Direction (0-7) */
+    uint8_t position;              /**< Relay table position written (APPLIED) */
+    char result;                   /**< ScheduleResult */
+};
+
+/**
+ * @brief Set up TC3 and empty the queue
+ */
+void schedule_init(void);
+
+/**
+ * @brief Queue a direction change
+ *
+ * Entries are kept in time order; two for the same time run in the
+ * order they were added.
+ *
+ * @param due_ms Phaser millis() to switch at
+ * @param direction Direction (0-7)
+ * @return SCHEDULE_OK or the reason the entry was refused
+ */
+ScheduleStatus schedule_add(uint32_t due_ms, uint8_t direction);
+
+/**
+ * @brief Drop every queued entry (executed ones are still reported)
+ */
+void schedule_clear(void);
+
+/**
+ * @brief Entries waiting for their time
+ */
+uint8_t schedule_pending(void);
+
+/**
+ * @brief Whether an entry is due within a window
+ *
+ * For work that can be put off, like a flash flush: a row erase stalls
+ * every flash fetch, the timer interrupt's included, for several ms.
+ *
+ * @param window_ms Window (ms)
+ */
+bool schedule_due_within(uint32_t window_ms);
+
+/**
+ * @brief Wait until no entry is due within a window
+ *
+ * Returns at once unless an entry is due within window_ms; then returns
+ * once the timer has executed it. Call before a flash write that cannot
+ * be put off, with SCHEDULE_FLASH_GUARD_MS.
+ *
+ * @param window_ms Window (ms)
+ */
+void schedule_wait_clear(uint32_t window_ms);
+
+/**
+ * @brief Next entry executed by the timer and not yet seen by loop()
+ *
+ * @param report Output
+ * @return false if there is none
+ */
+bool schedule_next_fired(ScheduleReport& report);
+
+/**
+ * @brief Whether the waiting confirmations should be reported now
+ *
+ * True once SCHEDULE_REPORT_BATCH are waiting or the oldest has waited
+ * SCHEDULE_REPORT_MS, and at most once per SCHEDULE_REPORT_MS.
+ */
+bool schedule_report_due(void);
+
+/**
+ * @brief Copy the oldest unreported confirmations
+ *
+ * @param reports Output
+ * @param max Capacity of reports
+ * @return Number copied
+ */
+uint8_t schedule_unreported(ScheduleReport* reports, uint8_t max);
+
+/**
+ * @brief Mark confirmations as reported once the controller has them
+ *
+ * @param count Number returned by schedule_unreported()
+ */
+void schedule_reported(uint8_t count);
+
+#endif // SCHEDULE_H
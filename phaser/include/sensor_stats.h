@@ -0,0 +1,59 @@
+/**
+ * @file sensor_stats.h
+ * @brief Streaming min/max/mean/variance of every sensor channel
+ *
+ * One accumulator per history channel over all samples since the last
+ * reset, plus one per direction over the samples taken while that
+ * direction was selected. Each sample is folded in with Welford's
+ * algorithm in fixed point (mean in Q8, sum of squared deviations in
+ * Q16), so the result stays exact over days of samples without storing
+ * any of them.
+ *
+ * Fed from sample_history() with the same values as the history tiers.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef SENSOR_STATS_H
+#define SENSOR_STATS_H
+
+#include <stdint.h>
+
+#include "history.h"
+
+/** @brief Accumulator scope: all samples (directions use 0 - 7) */
+#define STATS_SCOPE_ALL 0xFF
+
+/** @brief Summary of one channel */
+struct SensorStat {
+    int16_t min;           /**< Minimum */
+    int16_t max;           /**< Maximum */
+    int16_t mean;          /**< Mean, rounded */
+    uint32_t variance;     /**< Sample variance, units squared, rounded */
+};
+
+/**
+ * @brief Clear every accumulator
+ */
+void sensor_stats_reset(void);
+
+/**
+ * @brief Fold one sample of every channel into the all-time and
+ *        per-direction accumulators
+ *
+ * @param values One value per HistoryChannel
+ * @param direction Direction selected while sampling (0-7)
+ */
+void sensor_stats_add(const int16_t values[HIST_NUM_CHANNELS], uint8_t direction);
+
+/**
+ * @brief Summarise one scope
+ *
+ * @param scope STATS_SCOPE_ALL or a direction (0-7)
+ * @param out One summary per HistoryChannel
+ * @return Samples in the scope (0 = no data; out is zeroed)
+ */
+uint32_t sensor_stats_read(uint8_t scope, SensorStat out[HIST_NUM_CHANNELS]);
+
+#endif // SENSOR_STATS_H
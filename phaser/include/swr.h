@@ -0,0 +1,84 @@
+/**
+ * @file swr.h
+ * @brief Fixed-point SWR and return loss from forward and reverse power
+ *
+ * |Gamma| = sqrt(Prev / Pfwd), SWR = (1 + |Gamma|) / (1 - |Gamma|) and
+ * return loss = 10 log10(Pfwd / Prev), all in integer arithmetic: the
+ * square root and logarithm come from small interpolated lookup tables.
+ *
+ * A short window of readings (one per history sample) gives min/max/mean
+ * SWR, so a momentary mismatch on voice peaks is visible as well as the
+ * average match.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef SWR_H
+#define SWR_H
+
+#include <stdint.h>
+
+/** @brief Largest SWR reported, x 100 (also used for |Gamma| >= 0.98) */
+#define SWR_MAX_X100 9999
+
+/** @brief Largest return loss reported, 0.1 dB (no reflected power) */
+#define SWR_MAX_RL_X10 999
+
+/** @brief One SWR reading */
+struct SwrReading {
+    bool valid;            /**< Forward power was at least SWR_MIN_FWD_DW */
+    uint16_t rho_q16;      /**< |Gamma|, Q16 (65535 = total reflection) */
+    uint16_t swr_x100;     /**< SWR x 100 (100 = 1.00:1) */
+    uint16_t rl_x10;       /**< Return loss, 0.1 dB */
+};
+
+/** @brief SWR statistics over the last SWR_WINDOW_SAMPLES readings */
+struct SwrWindowStats {
+    uint16_t min_x100;     /**< Lowest valid SWR x 100 */
+    uint16_t max_x100;     /**< Highest valid SWR x 100 */
+    uint16_t mean_x100;    /**< Mean of valid SWR x 100 */
+    uint8_t count;         /**< Valid readings in the window (0 = no carrier) */
+};
+
+/**
+ * @brief Square root of a fraction in [0, 1)
+ *
+ * @param x_q32 Input, Q32 (0x80000000 = 0.5)
+ * @return sqrt(x), Q16
+ */
+uint16_t sqrt_frac_q16(uint32_t x_q32);
+
+/**
+ * @brief Base-2 logarithm
+ *
+ * @param v Input, > 0
+ * @return log2(v), Q12 (unsigned 20.12)
+ */
+uint32_t log2_q12(uint32_t v);
+
+/**
+ * @brief Compute SWR and return loss from calibrated powers
+ *
+ * @param fwd_dw Forward power, 0.1 W
+ * @param rev_dw Reverse power, 0.1 W
+ * @param out Result; zeroed and invalid below SWR_MIN_FWD_DW
+ * @return out.valid
+ */
+bool swr_compute(uint16_t fwd_dw, uint16_t rev_dw, SwrReading& out);
+
+/**
+ * @brief Add a reading to the window (invalid readings count as gaps)
+ *
+ * @param reading Reading to add
+ */
+void swr_window_add(const SwrReading& reading);
+
+/**
+ * @brief Statistics over the window
+ *
+ * @param stats Output
+ */
+void swr_window_read(SwrWindowStats& stats);
+
+#endif // SWR_H
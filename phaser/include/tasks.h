@@ -0,0 +1,91 @@
+/**
+ * @file tasks.h
+ * @brief Cooperative task scheduler for loop()
+ *
+ * loop() no longer runs everything in one pass. Each job (radio service,
+ * relay sequencing, sensor sampling, reporting, status/logging, flash
+ * flush) is a task with its own period, priority and start deadline, and
+ * every pass of loop() runs the single most urgent task that is due. The
+ * radio is checked again between any two other tasks, so background work
+ * adds at most one task's run time to the command path.
+ *
+ * Tasks run to completion; nothing is preempted. A task that starts more
+ * than its deadline after its due time is counted as a miss, and the
+ * worst start delay and run time of each task are kept, so a task that
+ * blocks for too long shows up in the statistics.
+ *
+ * The task table is a fixed array of TASK_MAX entries.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <stdint.h>
+
+/** @brief Task body, runs to completion */
+typedef void (*TaskFunction)(void);
+
+/** @brief Run statistics of one task */
+struct TaskStats {
+    uint32_t runs;                 /**< Times run */
+    uint32_t misses;               /**< Starts later than the deadline */
+    uint32_t max_late_ms;          /**< Worst start delay after the due time */
+    uint32_t max_run_us;           /**< Longest run */
+};
+
+/**
+ * @brief Register a task, first due at once
+ *
+ * @param name Short name for the log (kept, not copied)
+ * @param fn Task body
+ * @param period_ms Interval between due times
+ * @param deadline_ms Start delay tolerated after the due time
+ * @param priority 0 = most urgent; equal priorities run earliest due first
+ * @return Task id, or -1 if TASK_MAX tasks are registered
+ */
+int8_t tasks_add(const char* name, TaskFunction fn, uint32_t period_ms,
+                 uint32_t deadline_ms, uint8_t priority);
+
+/**
+ * @brief Run the most urgent task that is due
+ *
+ * Call from loop().
+ *
+ * @return false if no task was due
+ */
+bool tasks_run(void);
+
+/**
+ * @brief Number of tasks registered
+ */
+uint8_t tasks_count(void);
+
+/**
+ * @brief Name of a task
+ *
+ * @param id Task id
+ */
+const char* tasks_name(uint8_t id);
+
+/**
+ * @brief Statistics of a task since the last tasks_reset_stats()
+ *
+ * @param id Task id
+ * @param stats Output
+ */
+void tasks_stats(uint8_t id, TaskStats& stats);
+
+/**
+ * @brief Clear every task's statistics
+ */
+void tasks_reset_stats(void);
+
+/**
+ * @brief Print one line per task with its statistics to Serial
+ */
+void tasks_log(void);
+
+#endif // TASKS_H
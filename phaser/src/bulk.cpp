@@ -0,0 +1,151 @@
+/**
+ * @file bulk.cpp
+ * @brief Compressed bulk history download sessions on the phaser
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <RH_RF95.h>
+
+#include "config.h"
+#include "history.h"
+#include "bulk_codec.h"
+#include "bulk.h"
+
+// ============================================================================
+// SESSION STATE
+// ============================================================================
+
+/** @brief Encoded chunks, back to back */
+static uint8_t bulk_buffer[BULK_BUFFER_LEN];
+
+/** @brief Offset of each chunk in bulk_buffer */
+static uint16_t chunk_offset[BULK_MAX_CHUNKS];
+
+/** @brief Length of each chunk */
+static uint8_t chunk_len[BULK_MAX_CHUNKS];
+
+/** @brief Records staged for the encoder */
+static BulkRecord stage[BULK_STAGE_RECORDS];
+
+static uint8_t session_id = 0;
+static uint8_t num_chunks = 0;
+static uint32_t last_start_ms = 0;
+static bool more_pending = false;
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Fill the stage with history records after a cursor
+ *
+ * @param tier History tier
+ * @param since_ms Cursor (HISTORY_SINCE_OLDEST for everything held)
+ * @return Records staged
+ */
+static uint16_t fill_stage(uint8_t tier, uint32_t since_ms) {
+    HistoryRecord batch[8];
+    uint16_t staged = 0;
+
+    while (staged < BULK_STAGE_RECORDS) {
+        uint8_t want = min(8, BULK_STAGE_RECORDS - staged);
+        uint8_t got = history_query(tier, since_ms, batch, want);
+        for (uint8_t i = 0; i < got; i++) {
+            BulkRecord& rec = stage[staged++];
+            rec.start_ms = batch[i].start_ms;
+            rec.direction = batch[i].direction;
+            for (uint8_t c = 0; c < BULK_NUM_CHANNELS; c++) {
+                rec.min[c] = batch[i].ch[c].min;
+                rec.max[c] = batch[i].ch[c].max;
+                rec.mean[c] = batch[i].ch[c].mean;
+            }
+        }
+        if (got < want) {
+            break;
+        }
+        since_ms = batch[got - 1].start_ms;
+    }
+    return staged;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+uint8_t bulk_start(uint8_t tier, uint32_t since_ms) {
+    session_id++;
+    num_chunks = 0;
+    last_start_ms = since_ms;
+    more_pending = false;
+
+    uint32_t period_ms = history_period_ms(tier);
+    uint16_t used = 0;
+
+    while (true) {
+        uint16_t staged = fill_stage(tier, last_start_ms);
+        if (staged == 0) {
+            break;
+        }
+        if (num_chunks >= BULK_MAX_CHUNKS) {
+            more_pending = true;
+            break;
+        }
+
+        uint16_t room = BULK_BUFFER_LEN - used;
+        if (room > RH_RF95_MAX_MESSAGE_LEN) {
+            room = RH_RF95_MAX_MESSAGE_LEN;
+        }
+
+        // Chunk count is not known until the end; patched in below
+        BulkChunkHeader hdr = {session_id, num_chunks, 0, tier};
+        uint16_t consumed;
+        size_t len = bulk_encode_chunk(hdr, period_ms, stage, staged,
+                                       bulk_buffer + used, room, &consumed);
+        if (len == 0) {
+            more_pending = true;
+            break;
+        }
+
+        chunk_offset[num_chunks] = used;
+        chunk_len[num_chunks] = (uint8_t)len;
+        num_chunks++;
+        used += len;
+        last_start_ms = stage[consumed - 1].start_ms;
+    }
+
+    for (uint8_t i = 0; i < num_chunks; i++) {
+        bulk_buffer[chunk_offset[i] + 3] = num_chunks;
+    }
+
+    DEBUG_PRINTF("Bulk session %d: tier %d, %d chunks, %d bytes%s\n",
+                 session_id, tier, num_chunks, used, more_pending ? " (more)" : "");
+    return num_chunks;
+}
+
+uint8_t bulk_session(void) {
+    return session_id;
+}
+
+uint8_t bulk_chunk_count(void) {
+    return num_chunks;
+}
+
+uint32_t bulk_last_start_ms(void) {
+    return last_start_ms;
+}
+
+bool bulk_more(void) {
+    return more_pending;
+}
+
+const uint8_t* bulk_chunk(uint8_t index, uint8_t& len) {
+    if (index >= num_chunks) {
+        len = 0;
+        return NULL;
+    }
+    len = chunk_len[index];
+    return bulk_buffer + chunk_offset[index];
+}
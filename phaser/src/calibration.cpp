@@ -0,0 +1,278 @@
+/**
+ * @file calibration.cpp
+ * @brief Per-direction reverse power calibration tables
+ *
+ * NVM layout: one CalStore record (magic, version, checksum, one CalTable
+ * per direction) at the start of a reserved flash area. A table with
+ * count 0 in the store means "not calibrated, use the default".
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "calibration.h"
+#include "nvm_flash.h"
+#include "rf_power.h"
+#include "schedule.h"
+
+// ============================================================================
+// STORAGE
+// ============================================================================
+
+/** @brief Store record marker ("CAL1") */
+#define CAL_MAGIC 0x314C4143UL
+
+/** @brief Store layout version */
+#define CAL_VERSION 1
+
+/** @brief Persistent record of all tables */
+struct CalStore {
+    uint32_t magic;                     /**< CAL_MAGIC */
+    uint16_t version;                   /**< CAL_VERSION */
+    uint16_t checksum;                  /**< nvm_checksum() of tables */
+    CalTable tables[NUM_DIRECTIONS];    /**< count 0 = use default */
+};
+
+static_assert(sizeof(CalStore) <= CAL_FLASH_BYTES, "CAL_FLASH_BYTES too small");
+
+NVM_FLASH_AREA(cal_flash, CAL_FLASH_BYTES);
+
+/** @brief Default point: full scale, original square-law formula */
+static const uint16_t CAL_DEFAULT_ADC_Q6 = 1023U << RF_Q_SHIFT;
+static const uint16_t CAL_DEFAULT_POWER_DW = (uint16_t)(
+    (1023.0f * REV_POWER_CONVERSION_FACTOR) *
+    (1023.0f * REV_POWER_CONVERSION_FACTOR) / 10.0f);
+
+/** @brief Forward channel: full scale, square law with its own factor */
+static const CalPoint CAL_FORWARD_POINT = {
+    CAL_DEFAULT_ADC_Q6,
+    (uint16_t)((1023.0f * FWD_POWER_CONVERSION_FACTOR) *
+               (1023.0f * FWD_POWER_CONVERSION_FACTOR) / 10.0f)
+};
+
+/** @brief Installed tables */
+static CalTable tables[NUM_DIRECTIONS];
+
+/** @brief Which tables came from NVM */
+static uint8_t calibrated_mask = 0;
+
+/** @brief Open calibration session */
+static bool session_active = false;
+static uint8_t session_direction = 0;
+static CalTable working;
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Fill a table with the default single point
+ *
+ * @param t Table to fill
+ */
+static void cal_set_default(CalTable& t) {
+    memset(&t, 0, sizeof(t));
+    t.count = 1;
+    t.points[0].adc_q6 = CAL_DEFAULT_ADC_Q6;
+    t.points[0].power_dw = CAL_DEFAULT_POWER_DW;
+}
+
+/**
+ * @brief Check a table is usable: 1..CAL_MAX_POINTS points, readings
+ *        strictly increasing and nonzero, powers non-decreasing
+ *
+ * @param t Table to check
+ * @return true if valid
+ */
+static bool cal_table_valid(const CalTable& t) {
+    if (t.count == 0 || t.count > CAL_MAX_POINTS || t.points[0].adc_q6 == 0) {
+        return false;
+    }
+    for (uint8_t i = 1; i < t.count; i++) {
+        if (t.points[i].adc_q6 <= t.points[i - 1].adc_q6 ||
+            t.points[i].power_dw < t.points[i - 1].power_dw) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write the installed tables to NVM
+ *
+ * @return CAL_OK or CAL_ERR_NVM
+ */
+static CalStatus cal_save(void) {
+    CalStore store;
+    memset(&store, 0, sizeof(store));
+    store.magic = CAL_MAGIC;
+    store.version = CAL_VERSION;
+    for (uint8_t d = 0; d < NUM_DIRECTIONS; d++) {
+        if (calibrated_mask & (1U << d)) {
+            store.tables[d] = tables[d];
+        }
+    }
+    store.checksum = nvm_checksum(store.tables, sizeof(store.tables));
+
+    schedule_wait_clear(SCHEDULE_FLASH_GUARD_MS);
+    return nvm_write(cal_flash, &store, sizeof(store)) ? CAL_OK : CAL_ERR_NVM;
+}
+
+/**
+ * @brief Interpolate power along one segment, linear in reading squared
+ *
+ * @param x2 Reading squared
+ * @param a Segment start
+ * @param b Segment end (b.adc_q6 > a.adc_q6)
+ * @return Power in 0.1 W, saturated to 0..65535
+ */
+static uint16_t cal_interpolate(uint32_t x2, const CalPoint& a, const CalPoint& b) {
+    uint32_t a2 = (uint32_t)a.adc_q6 * a.adc_q6;
+    uint32_t b2 = (uint32_t)b.adc_q6 * b.adc_q6;
+
+    int64_t p = (int64_t)a.power_dw +
+                ((int64_t)((int32_t)b.power_dw - a.power_dw) * ((int64_t)x2 - a2)) /
+                (int64_t)(b2 - a2);
+
+    if (p < 0) return 0;
+    if (p > UINT16_MAX) return UINT16_MAX;
+    return (uint16_t)p;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void cal_init(void) {
+    CalStore store;
+    nvm_read(cal_flash, &store, sizeof(store));
+
+    bool store_ok = store.magic == CAL_MAGIC && store.version == CAL_VERSION &&
+                    store.checksum == nvm_checksum(store.tables, sizeof(store.tables));
+
+    calibrated_mask = 0;
+    for (uint8_t d = 0; d < NUM_DIRECTIONS; d++) {
+        if (store_ok && cal_table_valid(store.tables[d])) {
+            tables[d] = store.tables[d];
+            calibrated_mask |= 1U << d;
+        } else {
+            cal_set_default(tables[d]);
+        }
+    }
+    session_active = false;
+}
+
+uint16_t cal_power_dw(uint8_t direction, uint16_t adc_q6) {
+    static const CalPoint origin = {0, 0};
+    const CalTable& t = cal_table(direction);
+    uint32_t x2 = (uint32_t)adc_q6 * adc_q6;
+
+    uint8_t i = 0;
+    while (i < t.count && t.points[i].adc_q6 < adc_q6) {
+        i++;
+    }
+
+    if (i == 0) {
+        return cal_interpolate(x2, origin, t.points[0]);
+    }
+    if (i == t.count) {
+        // Extend the last segment
+        const CalPoint& a = (t.count >= 2) ? t.points[t.count - 2] : origin;
+        return cal_interpolate(x2, a, t.points[t.count - 1]);
+    }
+    return cal_interpolate(x2, t.points[i - 1], t.points[i]);
+}
+
+uint16_t cal_forward_power_dw(uint16_t adc_q6) {
+    static const CalPoint origin = {0, 0};
+    return cal_interpolate((uint32_t)adc_q6 * adc_q6, origin, CAL_FORWARD_POINT);
+}
+
+const CalTable& cal_table(uint8_t direction) {
+    return tables[direction < NUM_DIRECTIONS ? direction : 0];
+}
+
+bool cal_is_calibrated(uint8_t direction) {
+    return direction < NUM_DIRECTIONS && (calibrated_mask & (1U << direction));
+}
+
+CalStatus cal_begin(uint8_t direction) {
+    if (session_active || direction >= NUM_DIRECTIONS) {
+        return CAL_ERR_MODE;
+    }
+    memset(&working, 0, sizeof(working));
+    session_direction = direction;
+    session_active = true;
+    return CAL_OK;
+}
+
+CalStatus cal_add_point(uint8_t direction, uint16_t adc_q6, uint16_t power_dw) {
+    if (!session_active) {
+        return CAL_ERR_MODE;
+    }
+    if (direction != session_direction) {
+        return CAL_ERR_DIRECTION;
+    }
+    if (adc_q6 == 0) {
+        return CAL_ERR_ORDER;  // (0, 0) is implied
+    }
+
+    // Sorted insert, replacing an equal reading
+    uint8_t i = 0;
+    while (i < working.count && working.points[i].adc_q6 < adc_q6) {
+        i++;
+    }
+    bool replace = (i < working.count && working.points[i].adc_q6 == adc_q6);
+    if (!replace && working.count >= CAL_MAX_POINTS) {
+        return CAL_ERR_FULL;
+    }
+
+    CalTable candidate = working;
+    if (!replace) {
+        memmove(&candidate.points[i + 1], &candidate.points[i],
+                (candidate.count - i) * sizeof(CalPoint));
+        candidate.count++;
+    }
+    candidate.points[i].adc_q6 = adc_q6;
+    candidate.points[i].power_dw = power_dw;
+
+    if (!cal_table_valid(candidate)) {
+        return CAL_ERR_ORDER;
+    }
+    working = candidate;
+    return CAL_OK;
+}
+
+CalStatus cal_commit(void) {
+    if (!session_active || working.count == 0) {
+        return CAL_ERR_MODE;
+    }
+    tables[session_direction] = working;
+    calibrated_mask |= 1U << session_direction;
+    session_active = false;
+    return cal_save();
+}
+
+void cal_abort(void) {
+    session_active = false;
+}
+
+CalStatus cal_restore_default(uint8_t direction) {
+    if (direction >= NUM_DIRECTIONS) {
+        return CAL_ERR_DIRECTION;
+    }
+    cal_set_default(tables[direction]);
+    calibrated_mask &= ~(1U << direction);
+    return cal_save();
+}
+
+bool cal_active(void) {
+    return session_active;
+}
+
+const CalTable& cal_working_table(void) {
+    return working;
+}
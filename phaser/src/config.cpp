@@ -0,0 +1,16 @@
+/**
+ * @file config.cpp
+ * @brief Lookup tables declared in config.h
+ *
+ * The tables are const, so they stay in flash; defining them here rather
+ * than as statics in the header keeps a single copy in the image.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include "config.h"
+
+const char DIRECTION_ANGLES[NUM_DIRECTIONS][4] = {
+    "000", "045", "090", "135", "180", "225", "270", "315"
+};
@@ -0,0 +1,139 @@
+/**
+ * @file dma.cpp
+ * @brief Minimal SAMD21 DMA controller (DMAC) helpers
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "dma.h"
+
+// ============================================================================
+// DESCRIPTOR TABLES
+// ============================================================================
+
+/** @brief Base descriptors, indexed by channel (DMAC BASEADDR) */
+__attribute__((__aligned__(16)))
+static DmacDescriptor base_descriptors[DMA_NUM_CHANNELS];
+
+/** @brief Channel state written back by the DMAC (DMAC WRBADDR) */
+__attribute__((__aligned__(16)))
+static volatile DmacDescriptor writeback_descriptors[DMA_NUM_CHANNELS];
+
+static DmaCallback callbacks[DMA_NUM_CHANNELS];
+
+static bool dma_ready = false;
+
+/**
+ * @brief Select a channel with interrupts off, remembering what to restore
+ *
+ * CHID is shared by every channel access, including DMAC_Handler() and
+ * the radio driver in the EIC interrupt, so each access restores it.
+ */
+struct ChannelSelect {
+    uint32_t primask;
+    uint8_t chid;
+
+    explicit ChannelSelect(uint8_t channel) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        chid = DMAC->CHID.reg;
+        DMAC->CHID.reg = DMAC_CHID_ID(channel);
+    }
+
+    ~ChannelSelect() {
+        DMAC->CHID.reg = chid;
+        __set_PRIMASK(primask);
+    }
+};
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void dma_init(void) {
+    if (dma_ready) {
+        return;
+    }
+    memset(base_descriptors, 0, sizeof(base_descriptors));
+    memset((void*)writeback_descriptors, 0, sizeof(writeback_descriptors));
+    memset(callbacks, 0, sizeof(callbacks));
+
+    PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+    PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+
+    DMAC->CTRL.bit.DMAENABLE = 0;
+    DMAC->CTRL.bit.SWRST = 1;
+    while (DMAC->CTRL.bit.SWRST);
+    DMAC->BASEADDR.reg = (uintptr_t)base_descriptors;
+    DMAC->WRBADDR.reg = (uintptr_t)writeback_descriptors;
+    DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+    // Same level as the peripherals it serves, below the radio
+    NVIC_SetPriority(DMAC_IRQn, 2);
+    NVIC_EnableIRQ(DMAC_IRQn);
+    dma_ready = true;
+}
+
+DmacDescriptor* dma_descriptor(uint8_t channel) {
+    return &base_descriptors[channel];
+}
+
+void dma_channel_setup(uint8_t channel, uint8_t trigger_src, uint32_t trigger_action,
+                       DmaCallback callback) {
+    ChannelSelect select(channel);
+    DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    while (DMAC->CHCTRLA.bit.SWRST);
+    DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(trigger_src) | trigger_action;
+    callbacks[channel] = callback;
+    if (callback) {
+        DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL | DMAC_CHINTENSET_TERR;
+    }
+}
+
+void dma_channel_enable(uint8_t channel) {
+    ChannelSelect select(channel);
+    DMAC->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+}
+
+void dma_channel_disable(uint8_t channel) {
+    ChannelSelect select(channel);
+    DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    while (DMAC->CHCTRLA.bit.ENABLE);
+}
+
+uint8_t dma_channel_wait(uint8_t channel) {
+    ChannelSelect select(channel);
+    uint8_t flags;
+    while (!((flags = DMAC->CHINTFLAG.reg) & (DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR)));
+    DMAC->CHINTFLAG.reg = flags;
+    return flags;
+}
+
+// ============================================================================
+// INTERRUPT
+// ============================================================================
+
+/**
+ * @brief Dispatch every channel with a pending interrupt to its callback
+ */
+void DMAC_Handler(void) {
+    uint32_t pending = DMAC->INTSTATUS.reg;
+    for (uint8_t ch = 0; ch < DMA_NUM_CHANNELS; ch++) {
+        if (!(pending & (1UL << ch))) {
+            continue;
+        }
+        uint8_t flags;
+        {
+            ChannelSelect select(ch);
+            flags = DMAC->CHINTFLAG.reg;
+            DMAC->CHINTFLAG.reg = flags;
+        }
+        if (callbacks[ch]) {
+            callbacks[ch](ch, flags);
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file history.cpp
+ * @brief Multi-resolution telemetry history for the phaser
+ *
+ * RAM use is fixed at compile time:
+ *   (HISTORY_TIER0_SLOTS + HISTORY_TIER1_SLOTS + HISTORY_TIER2_SLOTS)
+ *   * sizeof(HistoryRecord) plus one accumulator per tier.
+ *
+ * Slots are aligned to multiples of their period in phaser millis(), so a
+ * 1 min slot always contains whole 1 s slots.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "history.h"
+
+// ============================================================================
+// STORAGE
+// ============================================================================
+
+/** @brief Open (still accumulating) slot of a tier */
+struct HistoryAccumulator {
+    uint32_t start_ms;                  /**< Aligned slot start */
+    int16_t min[HIST_NUM_CHANNELS];     /**< Running minimum */
+    int16_t max[HIST_NUM_CHANNELS];     /**< Running maximum */
+    int32_t sum[HIST_NUM_CHANNELS];     /**< Running sum of inputs */
+    uint16_t count;                     /**< Inputs merged so far */
+    uint8_t direction;                  /**< Direction | HISTORY_DIR_CHANGED */
+};
+
+/** @brief One resolution tier: ring of closed slots plus its open slot */
+struct HistoryTier {
+    HistoryRecord* records;             /**< Ring storage */
+    uint16_t slots;                     /**< Ring capacity */
+    uint32_t period_ms;                 /**< Slot length */
+    uint16_t head;                      /**< Next write index */
+    uint16_t count;                     /**< Valid records */
+    HistoryAccumulator acc;             /**< Open slot */
+};
+
+static HistoryRecord tier0_records[HISTORY_TIER0_SLOTS];
+static HistoryRecord tier1_records[HISTORY_TIER1_SLOTS];
+static HistoryRecord tier2_records[HISTORY_TIER2_SLOTS];
+
+static HistoryTier tiers[HISTORY_NUM_TIERS] = {
+    {tier0_records, HISTORY_TIER0_SLOTS, HISTORY_TIER0_PERIOD_MS, 0, 0, {}},
+    {tier1_records, HISTORY_TIER1_SLOTS, HISTORY_TIER1_PERIOD_MS, 0, 0, {}},
+    {tier2_records, HISTORY_TIER2_SLOTS, HISTORY_TIER2_PERIOD_MS, 0, 0, {}}
+};
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+static void history_merge(uint8_t tier, uint32_t start_ms,
+                          const HistoryStat* stats, uint8_t direction);
+
+/**
+ * @brief Close the open slot of a tier and cascade it upwards
+ *
+ * @param tier Tier index
+ */
+static void history_close(uint8_t tier) {
+    HistoryTier& t = tiers[tier];
+    HistoryAccumulator& acc = t.acc;
+    if (acc.count == 0) {
+        return;
+    }
+
+    HistoryRecord& rec = t.records[t.head];
+    rec.start_ms = acc.start_ms;
+    for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+        rec.ch[c].min = acc.min[c];
+        rec.ch[c].max = acc.max[c];
+        rec.ch[c].mean = (int16_t)(acc.sum[c] / acc.count);
+    }
+    rec.direction = acc.direction;
+
+    t.head = (t.head + 1) % t.slots;
+    if (t.count < t.slots) {
+        t.count++;
+    }
+    acc.count = 0;
+
+    if (tier + 1 < HISTORY_NUM_TIERS) {
+        history_merge(tier + 1, rec.start_ms, rec.ch, rec.direction);
+    }
+}
+
+/**
+ * @brief Merge one input (raw sample or closed child slot) into a tier
+ *
+ * @param tier Tier index
+ * @param start_ms Time of the input
+ * @param stats Per-channel min/max/mean of the input
+ * @param direction Direction | HISTORY_DIR_CHANGED of the input
+ */
+static void history_merge(uint8_t tier, uint32_t start_ms,
+                          const HistoryStat* stats, uint8_t direction) {
+    HistoryTier& t = tiers[tier];
+    HistoryAccumulator& acc = t.acc;
+
+    if (acc.count > 0 && (int32_t)(start_ms - acc.start_ms) >= (int32_t)t.period_ms) {
+        history_close(tier);
+    }
+
+    if (acc.count == 0) {
+        acc.start_ms = start_ms - (start_ms % t.period_ms);
+        for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+            acc.min[c] = stats[c].min;
+            acc.max[c] = stats[c].max;
+            acc.sum[c] = 0;
+        }
+        acc.direction = direction;
+    } else {
+        for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+            if (stats[c].min < acc.min[c]) acc.min[c] = stats[c].min;
+            if (stats[c].max > acc.max[c]) acc.max[c] = stats[c].max;
+        }
+        uint8_t changed = (direction | acc.direction) & HISTORY_DIR_CHANGED;
+        if ((direction & HISTORY_DIR_MASK) != (acc.direction & HISTORY_DIR_MASK)) {
+            changed = HISTORY_DIR_CHANGED;
+        }
+        acc.direction = (direction & HISTORY_DIR_MASK) | changed;
+    }
+
+    for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+        acc.sum[c] += stats[c].mean;
+    }
+    acc.count++;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void history_init(void) {
+    for (uint8_t i = 0; i < HISTORY_NUM_TIERS; i++) {
+        tiers[i].head = 0;
+        tiers[i].count = 0;
+        tiers[i].acc.count = 0;
+    }
+}
+
+void history_add_sample(uint32_t now_ms, const int16_t* values, uint8_t direction) {
+    HistoryStat stats[HIST_NUM_CHANNELS];
+    for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+        stats[c].min = values[c];
+        stats[c].max = values[c];
+        stats[c].mean = values[c];
+    }
+    history_merge(0, now_ms, stats, direction & HISTORY_DIR_MASK);
+}
+
+uint16_t history_count(uint8_t tier) {
+    if (tier >= HISTORY_NUM_TIERS) {
+        return 0;
+    }
+    return tiers[tier].count;
+}
+
+uint32_t history_period_ms(uint8_t tier) {
+    if (tier >= HISTORY_NUM_TIERS) {
+        return 0;
+    }
+    return tiers[tier].period_ms;
+}
+
+uint8_t history_query(uint8_t tier, uint32_t since_ms,
+                      HistoryRecord* out, uint8_t max_records) {
+    if (tier >= HISTORY_NUM_TIERS) {
+        return 0;
+    }
+
+    const HistoryTier& t = tiers[tier];
+    uint16_t oldest = (t.head + t.slots - t.count) % t.slots;
+    uint8_t copied = 0;
+
+    for (uint16_t i = 0; i < t.count && copied < max_records; i++) {
+        const HistoryRecord& rec = t.records[(oldest + i) % t.slots];
+        if (since_ms == HISTORY_SINCE_OLDEST || (int32_t)(rec.start_ms - since_ms) > 0) {
+            out[copied++] = rec;
+        }
+    }
+    return copied;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file interlock.cpp
+ * @brief Hot-switch interlock: hold relay changes while RF is present
+ *
+ * RF detection is done by the ADC window monitor in rf_power.cpp; this
+ * module only keeps the held request and its timing. The worst-case delay
+ * between RF dropping and the relays switching is INTERLOCK_QUIET_MS plus
+ * one pass of loop().
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "interlock.h"
+#include "rf_power.h"
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+/** @brief A direction change is being held */
+static bool pending = false;
+
+/** @brief Direction of the held change */
+static uint8_t pending_direction = 0;
+
+/** @brief millis() when the held change was first requested */
+static uint32_t pending_since_ms = 0;
+
+/** @brief Last direction change */
+static InterlockState last_state = INTERLOCK_CLEAR;
+static uint32_t last_wait_ms = 0;
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void interlock_init(void) {
+    rf_power_sense_arm(RF_SENSE_THRESHOLD_Q6);
+    pending = false;
+    last_state = INTERLOCK_CLEAR;
+    last_wait_ms = 0;
+}
+
+bool interlock_rf_present(void) {
+    return rf_power_sense_quiet_ms() < INTERLOCK_QUIET_MS;
+}
+
+bool interlock_request(uint8_t direction, bool contacts_move) {
+    if (!contacts_move || !interlock_rf_present()) {
+        pending = false;  // Supersedes any held change
+        last_state = INTERLOCK_CLEAR;
+        last_wait_ms = 0;
+        return true;
+    }
+
+    interlock_hold(direction);
+    return false;
+}
+
+void interlock_hold(uint8_t direction) {
+    if (!pending) {
+        pending_since_ms = millis();
+        pending = true;
+    }
+    pending_direction = direction;
+    last_state = INTERLOCK_HELD;
+}
+
+int interlock_poll(void) {
+    if (!pending) {
+        return -1;
+    }
+
+    uint32_t waited = millis() - pending_since_ms;
+    if (interlock_rf_present()) {
+        if (waited >= INTERLOCK_TIMEOUT_MS) {
+            pending = false;
+            last_state = INTERLOCK_EXPIRED;
+            last_wait_ms = waited;
+            Serial.printf("Held direction change dropped, RF present for %lu ms\n",
+                          (unsigned long)waited);
+        }
+        return -1;
+    }
+
+    pending = false;
+    last_state = INTERLOCK_APPLIED;
+    last_wait_ms = waited;
+    return pending_direction;
+}
+
+InterlockState interlock_status(uint32_t& wait_ms) {
+    wait_ms = pending ? millis() - pending_since_ms : last_wait_ms;
+    return last_state;
+}
@@ -32,12 +32,11 @@
 // ============================================================================
 
 #include <Arduino.h>
+#include <stdarg.h>
 #include <Wire.h>
 #include <SPI.h>
-#include <avr/dtostrf.h>
 
 // Radio libraries
-#include <RH_RF95.h>
 #include <RHReliableDatagram.h>
 
 // Sensor libraries
@@ -46,18 +45,42 @@
 // Project headers
 #include "config.h"
 #include "protocol.h"
+#include "history.h"
+#include "bulk.h"
+#include "rf_power.h"
+#include "swr.h"
+#include "calibration.h"
+#include "protection.h"
+#include "sensor_stats.h"
+#include "relay_verify.h"
+#include "interlock.h"
+#include "relays.h"
+#include "relay_wear.h"
+#include "schedule.h"
+#include "tasks.h"
+#include "packet_pool.h"
+#include "command.h"
+#include "fast_gpio.h"
+#include "rf95_dma.h"
 
 // ============================================================================
 // GLOBAL OBJECTS
 // ============================================================================
 
-// LoRa radio objects
-RH_RF95 rf95(RF95_CS, RF95_INT);
+// LoRa radio objects (FIFO bursts by DMA)
+Rf95Dma rf95(RF95_CS, RF95_INT);
 RHReliableDatagram rf95_manager(rf95, MY_ADDRESS);
 
 // Current and voltage monitor
 Adafruit_INA3221 ina3221;
 
+// Radio frame buffers
+PacketPool<PACKET_POOL_BLOCKS> packet_pool;
+
+// Status LED
+static constexpr FastPin STATUS_LED(LED);
+static_assert(PACKET_MTU == RH_RF95_MAX_MESSAGE_LEN, "PACKET_MTU must match the RFM95 MTU");
+
 // ============================================================================
 // APPLICATION STATE
 // ============================================================================
@@ -65,6 +88,9 @@ Adafruit_INA3221 ina3221;
 /** @brief Current antenna direction (0-7) */
 int current_direction = DIR_N;
 
+/** @brief Relay table position last written (profile x 8 + direction) */
+uint8_t applied_position = DIR_N;
+
 /** @brief Target direction (for future movement) */
 int target_direction = DIR_N;
 
@@ -74,14 +100,8 @@ int bus_voltage_mv = 0;
 /** @brief Bus current in milliamps */
 int bus_current_ma = 0;
 
-/** @brief Command buffer from controller */
-char command_buffer[MAX_COMMAND_LEN];
-
-/** @brief Actual command length received */
-int command_length = 0;
-
-/** @brief Reply buffer */
-uint8_t reply_buffer[RH_RF95_MAX_MESSAGE_LEN];
+/** @brief Reply being built, from the packet pool while a command is processed */
+Packet* reply_packet = NULL;
 
 /** @brief Reply buffer length */
 int reply_length = 0;
@@ -89,21 +109,57 @@ int reply_length = 0;
 /** @brief Packet counter */
 int16_t packet_count = 0;
 
+/** @brief millis() when the current command was received (NTP T2) */
+uint32_t command_rx_ms = 0;
+
+/** @brief Status LED lit by led_flash(), and when it goes off */
+bool led_lit = false;
+uint32_t led_off_ms = 0;
+
+/** @brief Bulk chunks to stream once the current reply has been ACKed */
+uint16_t bulk_stream_mask = 0;
+
 // ============================================================================
 // FUNCTION PROTOTYPES
 // ============================================================================
 
 void init_all_hardware(void);
 void set_antenna_direction(int direction);
+void apply_antenna_direction(int direction);
 void measure_sensors(void);
-int read_reverse_power_adc(void);
+void sample_history(void);
 void build_position_reply(int direction);
 void build_power_reply(void);
+void build_history_reply(uint8_t tier, uint32_t since_ms);
+void build_stats_reply(char scope);
+void build_wear_reply(void);
 void append_to_reply(const char* str, int len);
-void process_command(void);
-void handle_set_direction(int direction);
+void append_format(const char* format, ...) __attribute__((format(printf, 1, 2)));
+void append_time_field(void);
+bool command_format_valid(const CommandView& cmd);
+bool open_command(Packet* frame, uint8_t from, CommandView& cmd);
+void process_command(const CommandView& cmd);
+void handle_set_direction(int direction, const CommandView& cmd);
 void handle_position_query(void);
 void handle_power_query(void);
+void handle_history_query(const CommandView& cmd);
+void handle_bulk_start(const CommandView& cmd);
+void handle_bulk_resend(const CommandView& cmd);
+void handle_calibration(const CommandView& cmd);
+void handle_stats_query(const CommandView& cmd);
+void handle_wear_command(const CommandView& cmd);
+void handle_schedule_command(const CommandView& cmd);
+void handle_profile_command(const CommandView& cmd);
+void process_scheduled_changes(void);
+void send_schedule_reports(void);
+void stream_bulk_chunks(uint8_t to);
+void send_protection_events(uint8_t faults);
+void led_flash(uint32_t ms);
+void task_radio(void);
+void task_relays(void);
+void task_report(void);
+void task_status(void);
+void task_flush(void);
 
 // ============================================================================
 // INITIALIZATION
@@ -126,26 +182,32 @@ void init_all_hardware(void) {
     delay(1000);
     Serial.println("\n========== LoRa Antenna Phaser Starting ==========");
     
-    // Set up relay control pins
-    pinMode(RELAY_1, OUTPUT);
-    pinMode(RELAY_2, OUTPUT);
-    pinMode(RELAY_3, OUTPUT);
-    pinMode(RELAY_4, OUTPUT);
-    pinMode(RELAY_56, OUTPUT);
-    pinMode(RELAY_78, OUTPUT);
+    // Set up relay outputs (pins or shift-register chain)
+    relays_init();
     pinMode(LED, OUTPUT);
+#if FAST_GPIO_BENCH
+    fast_gpio_bench(Serial, LED);
+#endif
     
-    // Initialize all relays to safe state
-    set_antenna_direction(DIR_N);
+    // Initialize all relays to safe state (latching relays: re-assert the
+    // stored state, in the profile it belongs to)
+    uint8_t startup_position = relays_startup_position();
+    relays_set_profile(startup_position / NUM_DIRECTIONS);
+    set_antenna_direction(startup_position % NUM_DIRECTIONS);
     Serial.println("✓ Relay outputs configured");
     
+    // Count relay operations from here on (the start-up switch is not one)
+    relay_wear_init(relays_pattern(applied_position));
+    Serial.printf("✓ Relay operation counters loaded, %lu direction changes\n",
+                  (unsigned long)relay_wear_changes());
+    
     // Initialize LoRa radio
     if (!rf95_manager.init()) {
         Serial.println("ERROR: RF95 radio initialization failed!");
         while (1) {
-            digitalWrite(LED, HIGH);
+            STATUS_LED.high();
             delay(100);
-            digitalWrite(LED, LOW);
+            STATUS_LED.low();
             delay(100);
         }
     }
@@ -159,11 +221,13 @@ void init_all_hardware(void) {
     rf95.setTxPower(20, false);
     rf95_manager.setTimeout(1000);
     Serial.printf("✓ Radio configured: %.1f MHz, TX Power 20 dBm\n", RF95_FREQ);
+    Serial.printf("✓ Packet pool: %u x %u bytes = %u bytes\n", packet_pool.capacity(),
+                  (unsigned)sizeof(Packet), (unsigned)packet_pool.bytes());
     
     // Initialize INA3221 current/voltage monitor
     if (!ina3221.begin(INA3221_I2C_ADDRESS, &Wire)) {
         Serial.println("ERROR: INA3221 initialization failed!");
-        digitalWrite(LED, HIGH);
+        STATUS_LED.high();
         while (1);
     }
     ina3221.setAveragingMode(INA3221_AVG_16_SAMPLES);
@@ -171,8 +235,43 @@ void init_all_hardware(void) {
     ina3221.setShuntResistance(1, 0.10);  // Channel 1: 5V supply
     Serial.println("✓ INA3221 Current/Voltage Monitor initialized");
     
+    // Arm the INA3221 alert limits before any relay is energised
+    protection_init(ina3221);
+    Serial.printf("✓ Protection armed: %d mA critical, %d mA warning, %d mV minimum\n",
+                  PROTECT_CRITICAL_MA, PROTECT_WARNING_MA, PROTECT_UNDERVOLT_MV);
+    
+    // Fast I2C keeps the coil current check around a switch to a few ms
+    Wire.setClock(400000);
+    relay_verify_init(ina3221);
+    Serial.println("✓ Relay coil current verification ready");
+    
+    // Load per-direction reverse power calibration, start background sampling
+    cal_init();
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (cal_is_calibrated(d)) {
+            Serial.printf("✓ Reverse power calibration loaded for %s°\n", DIRECTION_ANGLES[d]);
+        }
+    }
+    if (!rf_power_init()) {
+        Serial.println("ERROR: FWD_POWER_PIN must be the ADC input after REV_POWER_PIN!");
+        STATUS_LED.high();
+        while (1);
+    }
+    Serial.printf("✓ Forward/reverse power sampler running, %dx hardware averaging\n",
+                  1 << RF_ADC_AVG_LOG2);
+    
+    // Hold relay changes while RF is present (uses the sampler's ADC)
+    interlock_init();
+    Serial.println("✓ Hot-switch interlock armed");
+    
+    // Timed direction changes (uses TC3)
+    schedule_init();
+    Serial.printf("✓ Direction change scheduler ready, %d entries\n", SCHEDULE_MAX_ENTRIES);
+    
     // Initial sensor reading
     measure_sensors();
+    history_init();
+    sensor_stats_reset();
     
     Serial.println("========== All systems ready ==========\n");
 }
@@ -184,8 +283,9 @@ void init_all_hardware(void) {
 /**
  * @brief Set antenna relays for specified direction
  *
- * Configures all 6 relay outputs according to the RemoteQTH
- * antenna configuration table for the given direction.
+ * Switches at once unless RF is present and the relay pattern changes;
+ * then the change is held by the interlock and applied from loop() when
+ * RF drops.
  *
  * @param direction Direction enum (0-7)
  */
@@ -194,16 +294,54 @@ void set_antenna_direction(int direction) {
         return;  // Invalid direction
     }
     
+    // A scheduled change due any moment goes first, then current_direction
+    // is brought up to date with it
+    process_scheduled_changes();
+    
+    uint8_t position = relays_position((uint8_t)direction);
+    bool contacts_move = !relays_same_pattern(position, applied_position);
+    if (!interlock_request((uint8_t)direction, contacts_move)) {
+        Serial.printf("RF present, switch to %s° held until it drops\n",
+                      DIRECTION_ANGLES[direction]);
+        return;
+    }
+    apply_antenna_direction(direction);
+}
+
+/**
+ * @brief Switch the antenna relays now
+ *
+ * Drives every relay output from the antenna configuration table
+ * for the given direction in the active relay map profile.
+ *
+ * @param direction Direction enum (0-7)
+ */
+void apply_antenna_direction(int direction) {
+    if (protection_tripped()) {
+        Serial.println("Relays held off after a protection trip, direction unchanged");
+        return;
+    }
+    
     DEBUG_PRINTF("Setting relays for direction %d\n", direction);
     
-    // Apply relay configuration
-    digitalWrite(RELAY_1, RELAY_POSITIONS[direction][0]);
-    digitalWrite(RELAY_2, RELAY_POSITIONS[direction][1]);
-    digitalWrite(RELAY_3, RELAY_POSITIONS[direction][2]);
-    digitalWrite(RELAY_4, RELAY_POSITIONS[direction][3]);
-    digitalWrite(RELAY_56, RELAY_POSITIONS[direction][4]);
-    digitalWrite(RELAY_78, RELAY_POSITIONS[direction][5]);
+    // Apply relay configuration, checking the coil current step
+    uint8_t position = relays_position((uint8_t)direction);
+    relay_verify_begin(applied_position, position);
+    if (!relays_write(relays_pattern(position))) {
+        // Tripped since the check above (during the baseline read)
+        relay_verify_cancel();
+        Serial.println("Relays held off after a protection trip, direction unchanged");
+        return;
+    }
+    if (relay_verify_end() == RELAY_VERIFY_FAILED) {
+        int16_t step_ma;
+        relay_verify_last(step_ma);
+        Serial.printf("ERROR: Relay check failed switching to %s° (step %d mA)\n",
+                      DIRECTION_ANGLES[direction], step_ma);
+    }
+    relay_wear_count(relays_pattern(position));
     
+    applied_position = position;
     current_direction = direction;
     DEBUG_PRINTF("✓ Antenna direction set to %d (%s°)\n",
                 direction, DIRECTION_ANGLES[direction]);
@@ -243,26 +381,6 @@ int read_mcu_voltage(void) {
     return (int)round(1000.0f * voltage);
 }
 
-/**
- * @brief Read reverse power ADC and average samples
- *
- * Accumulates ADC_AVG_COUNT samples with small delays between reads.
- *
- * @return Averaged ADC count (0-1023 for 10-bit ADC)
- */
-int read_reverse_power_adc(void) {
-    long adc_sum = 0;
-    
-    for (int i = 0; i < ADC_AVG_COUNT; i++) {
-        adc_sum += analogRead(REV_POWER_PIN);
-        delay(ADC_SAMPLE_DELAY);
-    }
-    
-    int avg = adc_sum / ADC_AVG_COUNT;
-    DEBUG_PRINTF("Reverse power ADC average: %d\n", avg);
-    return avg;
-}
-
 /**
  * @brief Measure all sensors and update global state
  *
@@ -279,6 +397,35 @@ void measure_sensors(void) {
     DEBUG_PRINTF("MCU Supply: %d mV\n", read_mcu_voltage());
 }
 
+/**
+ * @brief Take one history sample of every channel
+ *
+ * Reverse power is the windowed average power from the background sampler.
+ * Also feeds the SWR window.
+ */
+void sample_history(void) {
+    int16_t values[HIST_NUM_CHANNELS];
+    RfPowerStats fwd, rev;
+    SwrReading swr;
+    
+    bus_voltage_mv = read_bus_voltage();
+    bus_current_ma = read_bus_current();
+    
+    rf_power_read(RF_CH_FWD, fwd);
+    rf_power_read(RF_CH_REV, rev);
+    uint16_t rev_power_dw = cal_power_dw(current_direction, rev.rms);
+    swr_compute(cal_forward_power_dw(fwd.rms), rev_power_dw, swr);
+    swr_window_add(swr);
+    
+    values[HIST_CH_BUS_MV] = (int16_t)constrain(bus_voltage_mv, INT16_MIN, INT16_MAX);
+    values[HIST_CH_BUS_MA] = (int16_t)constrain(bus_current_ma, INT16_MIN, INT16_MAX);
+    values[HIST_CH_MCU_MV] = (int16_t)constrain(read_mcu_voltage(), INT16_MIN, INT16_MAX);
+    values[HIST_CH_REV_DW] = (int16_t)min(rev_power_dw, (uint16_t)INT16_MAX);
+    
+    history_add_sample(millis(), values, (uint8_t)current_direction);
+    sensor_stats_add(values, (uint8_t)current_direction);
+}
+
 // ============================================================================
 // REPLY BUILDING
 // ============================================================================
@@ -286,7 +433,7 @@ void measure_sensors(void) {
 /**
  * @brief Build a position reply
  *
- * Format: ";XYZrRRRRvVVVVViIIIbBBBB"
+ * Format: ";XYZrRRRRvVVVVViIIIbBBBBkXSSSSSwXWWWWWgP"
  *
  * @param direction Antenna direction (0-7)
  */
@@ -294,73 +441,226 @@ void build_position_reply(int direction) {
     reply_length = 0;
     
     // Position prefix and azimuth
-    reply_buffer[reply_length++] = REPLY_PREFIX_POS;
-    reply_buffer[reply_length++] = DIRECTION_ANGLES[direction][0];
-    reply_buffer[reply_length++] = DIRECTION_ANGLES[direction][1];
-    reply_buffer[reply_length++] = DIRECTION_ANGLES[direction][2];
+    reply_packet->data[reply_length++] = REPLY_PREFIX_POS;
+    reply_packet->data[reply_length++] = DIRECTION_ANGLES[direction][0];
+    reply_packet->data[reply_length++] = DIRECTION_ANGLES[direction][1];
+    reply_packet->data[reply_length++] = DIRECTION_ANGLES[direction][2];
     
-    // RSSI
-    char rssi_str[6];
-    sprintf(rssi_str, "r%+04d", rf95.lastRssi());
-    for (int i = 0; rssi_str[i] != '\0'; i++) {
-        reply_buffer[reply_length++] = rssi_str[i];
-    }
+    // RSSI, bus voltage (5 digits, no decimal), bus current (3 digits,
+    // e.g. "i500" = 500mA) and MCU battery voltage
+    append_format("r%+04dv%05di%03db%04d", rf95.lastRssi(), bus_voltage_mv, bus_current_ma,
+                  read_mcu_voltage());
     
-    // Bus voltage (5 digits, no decimal)
-    char volt_str[8];
-    sprintf(volt_str, "v%05d", bus_voltage_mv);
-    for (int i = 0; volt_str[i] != '\0'; i++) {
-        reply_buffer[reply_length++] = volt_str[i];
-    }
+    // Coil current check of the last switch
+    int16_t step_ma;
+    RelayVerifyResult check = relay_verify_last(step_ma);
+    append_format("%c%c%+05d", REPLY_FIELD_RELAY, (char)check, constrain(step_ma, -9999, 9999));
     
-    // Bus current (3 digits, e.g., "i500" = 500mA)
-    char curr_str[6];
-    sprintf(curr_str, "i%03d", bus_current_ma);
-    for (int i = 0; curr_str[i] != '\0'; i++) {
-        reply_buffer[reply_length++] = curr_str[i];
-    }
+    // Interlock state and wait of the last direction change
+    uint32_t wait_ms;
+    InterlockState hold = interlock_status(wait_ms);
+    append_format("%c%c%05lu", REPLY_FIELD_INTERLOCK, (char)hold,
+                  (unsigned long)min(wait_ms, (uint32_t)99999));
     
-    // MCU battery voltage
-    int mcu_volt = read_mcu_voltage();
-    char batt_str[8];
-    sprintf(batt_str, "b%04d", mcu_volt);
-    for (int i = 0; batt_str[i] != '\0'; i++) {
-        reply_buffer[reply_length++] = batt_str[i];
-    }
+    // Relay map profile the direction is in
+    append_format("%c%X", REPLY_FIELD_PROFILE, relays_profile());
     
     DEBUG_PRINTF("Position reply length: %d\n", reply_length);
 }
 
+/**
+ * @brief Append a one-letter power field: prefix + 6 characters of watts
+ *
+ * @param prefix Field letter
+ * @param power_dw Power in 0.1 W (65535 max = "6553.5")
+ */
+static void append_power_field(char prefix, uint16_t power_dw) {
+    append_format("%c%4u.%u", prefix, power_dw / 10, power_dw % 10);
+}
+
 /**
  * @brief Build a power/telemetry reply
  *
- * Format: "VPPPPPP" where PPPPPP is reverse power in watts
- * Example: "V1500.6" = 1500.6W
+ * Format: "VPPPPPPpKKKKKKeEEEEEEfFFFFFFsSSSSlLLLxXXXX" (see protocol.h)
+ * Example: "V  12.3p 150.2e  48.0f 500.0s0136l230x0141"
+ *
+ * Values come from the background sampler, so the reply is built without
+ * touching the ADC, and converted with the current direction's calibration
+ * table in integer arithmetic.
  */
 void build_power_reply(void) {
+    RfPowerStats fwd, rev;
+    SwrReading swr;
+    SwrWindowStats swr_window;
+    
     reply_length = 0;
+    rf_power_read(RF_CH_FWD, fwd);
+    rf_power_read(RF_CH_REV, rev);
     
-    // Read reverse power
-    int adc_reading = read_reverse_power_adc();
+    uint16_t avg_dw = cal_power_dw(current_direction, rev.rms);
+    uint16_t peak_dw = cal_power_dw(current_direction, rev.peak);
+    uint16_t env_dw = cal_power_dw(current_direction, rev.envelope);
+    uint16_t fwd_dw = cal_forward_power_dw(fwd.rms);
     
-    // Convert ADC to power in watts
-    // RemoteQTH calibration factor
-    float rev_voltage = adc_reading * REV_POWER_CONVERSION_FACTOR;
-    float rev_power = (rev_voltage * rev_voltage) / 100.0f;  // Z0=50Ω formula
+    swr_compute(fwd_dw, avg_dw, swr);
+    swr_window_read(swr_window);
     
-    // Format power string: "V" + 6 characters
-    reply_buffer[reply_length++] = REPLY_PREFIX_PWR;
+    append_power_field(REPLY_PREFIX_PWR, avg_dw);
+    append_power_field(REPLY_FIELD_PEAK, peak_dw);
+    append_power_field(REPLY_FIELD_ENV, env_dw);
+    append_power_field(REPLY_FIELD_FWD, fwd_dw);
     
-    char power_str[8];
-    dtostrf(rev_power, 6, 1, power_str);  // 6 chars total, 1 decimal
-    for (int i = 0; power_str[i] != '\0' && reply_length < (int)sizeof(reply_buffer); i++) {
-        reply_buffer[reply_length++] = power_str[i];
-    }
+    // SWR x 100, return loss 0.1 dB, window max SWR; zeros when no carrier
+    append_format("%c%04u%c%03u%c%04u", REPLY_FIELD_SWR, swr.swr_x100, REPLY_FIELD_RL,
+                  swr.rl_x10, REPLY_FIELD_SWR_MAX, swr_window.max_x100);
     
-    DEBUG_PRINTF("Power: %.1f W (ADC: %d)\n", rev_power, adc_reading);
+    DEBUG_PRINTF("Power: fwd %u dW, rev avg %u dW, peak %u dW, env %u dW (%lu samples)\n",
+                 fwd_dw, avg_dw, peak_dw, env_dw, (unsigned long)rev.samples);
+    DEBUG_PRINTF("SWR %u.%02u RL %u.%u dB (window %u.%02u-%u.%02u)\n",
+                 swr.swr_x100 / 100, swr.swr_x100 % 100, swr.rl_x10 / 10, swr.rl_x10 % 10,
+                 swr_window.min_x100 / 100, swr_window.min_x100 % 100,
+                 swr_window.max_x100 / 100, swr_window.max_x100 % 100);
     DEBUG_PRINTF("Power reply length: %d\n", reply_length);
 }
 
+/**
+ * @brief Build a telemetry history reply
+ *
+ * Format: "HTN" + N records (see protocol.h). As many records as fit in one
+ * LoRa frame alongside the time-sync trailer are sent; the controller pages
+ * through the rest by repeating the query with the last start time.
+ *
+ * @param tier History tier (0 = finest)
+ * @param since_ms Send records starting after this phaser time (or
+ *                 HISTORY_SINCE_OLDEST for everything held)
+ */
+void build_history_reply(uint8_t tier, uint32_t since_ms) {
+    const uint8_t max_records =
+        (RH_RF95_MAX_MESSAGE_LEN - 3 - REPLY_TIME_FIELD_LEN) / HISTORY_RECORD_TEXT_LEN;
+    HistoryRecord records[max_records];
+    uint8_t count = history_query(tier, since_ms, records, max_records);
+    
+    reply_length = 0;
+    reply_packet->data[reply_length++] = REPLY_PREFIX_HIST;
+    reply_packet->data[reply_length++] = '0' + tier;
+    reply_packet->data[reply_length++] = '0' + count;
+    
+    for (uint8_t r = 0; r < count; r++) {
+        char rec_str[HISTORY_RECORD_TEXT_LEN + 1];
+        int pos = snprintf(rec_str, sizeof(rec_str), "%08lX%1X",
+                           (unsigned long)records[r].start_ms, records[r].direction);
+        for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+            pos += snprintf(rec_str + pos, sizeof(rec_str) - pos, "%04X%04X%04X",
+                            (uint16_t)records[r].ch[c].min,
+                            (uint16_t)records[r].ch[c].max,
+                            (uint16_t)records[r].ch[c].mean);
+        }
+        append_to_reply(rec_str, HISTORY_RECORD_TEXT_LEN);
+    }
+    
+    DEBUG_PRINTF("History reply: tier %d, %d records\n", tier, count);
+}
+
+/**
+ * @brief Build a sensor statistics reply
+ *
+ * Format: "SXNNNNNNNN" + 4 x "mmmmMMMMaaaaVVVVVVVV"
+ *
+ * @param scope STATS_SUB_ALL or a direction digit
+ */
+void build_stats_reply(char scope) {
+    SensorStat stats[HIST_NUM_CHANNELS];
+    uint32_t count = sensor_stats_read(
+        (scope == STATS_SUB_ALL) ? STATS_SCOPE_ALL : (uint8_t)(scope - '0'), stats);
+    
+    char header[REPLY_STATS_HEADER_LEN + 1];
+    snprintf(header, sizeof(header), "%c%c%08lX", REPLY_PREFIX_STATS, scope,
+             (unsigned long)count);
+    reply_length = 0;
+    append_to_reply(header, REPLY_STATS_HEADER_LEN);
+    
+    for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+        char ch_str[STATS_CHANNEL_TEXT_LEN + 1];
+        snprintf(ch_str, sizeof(ch_str), "%04X%04X%04X%08lX",
+                 (uint16_t)stats[c].min, (uint16_t)stats[c].max,
+                 (uint16_t)stats[c].mean, (unsigned long)stats[c].variance);
+        append_to_reply(ch_str, STATS_CHANNEL_TEXT_LEN);
+    }
+    
+    DEBUG_PRINTF("Stats reply: scope %c, %lu samples\n", scope, (unsigned long)count);
+}
+
+static_assert(REPLY_WEAR_HEADER_LEN + RELAY_COUNT * WEAR_RELAY_TEXT_LEN +
+              REPLY_TIME_FIELD_LEN <= RH_RF95_MAX_MESSAGE_LEN,
+              "Too many relays for one operation counter reply");
+
+/**
+ * @brief Build relay operation counter reply
+ *
+ * Format: "ONNCCCCCCCC" + NN x "OOOOOOOO"
+ */
+void build_wear_reply(void) {
+    char field[REPLY_WEAR_HEADER_LEN + 1];
+    snprintf(field, sizeof(field), "%c%02X%08lX", REPLY_PREFIX_WEAR, RELAY_COUNT,
+             (unsigned long)relay_wear_changes());
+    reply_length = 0;
+    append_to_reply(field, REPLY_WEAR_HEADER_LEN);
+    
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        snprintf(field, sizeof(field), "%08lX", (unsigned long)relay_wear_ops(r));
+        append_to_reply(field, WEAR_RELAY_TEXT_LEN);
+    }
+}
+
+/**
+ * @brief Append raw characters to the reply buffer
+ *
+ * Silently truncates if the reply buffer would overflow.
+ *
+ * @param str Characters to append
+ * @param len Number of characters
+ */
+void append_to_reply(const char* str, int len) {
+    for (int i = 0; i < len && reply_length < PACKET_MTU; i++) {
+        reply_packet->data[reply_length++] = str[i];
+    }
+}
+
+/**
+ * @brief Format a field straight into the reply buffer
+ *
+ * Saves a stack string and a copy per field. The terminator printf()
+ * writes lands on the byte the next field starts at; a field that does
+ * not fit is cut short, leaving the last byte of the buffer unused.
+ *
+ * @param format printf() format of the field
+ */
+void append_format(const char* format, ...) {
+    if (reply_length >= PACKET_MTU - 1) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf((char*)reply_packet->data + reply_length, PACKET_MTU - reply_length,
+                      format, args);
+    va_end(args);
+    if (n > 0) {
+        reply_length = min(reply_length + n, PACKET_MTU - 1);
+    }
+}
+
+/**
+ * @brief Append the time-sync trailer to the reply
+ *
+ * Format: "tRRRRRRRRXXXXXXXX" (see protocol.h). Called last, immediately
+ * before the reply is handed to the radio, so XXXXXXXX is as close to the
+ * actual transmit time as the application can get.
+ */
+void append_time_field(void) {
+    append_format("%c%08lX%08lX", REPLY_FIELD_TIME, (unsigned long)command_rx_ms,
+                  (unsigned long)millis());
+}
+
 // ============================================================================
 // COMMAND PROCESSING
 // ============================================================================
@@ -375,14 +675,14 @@ void build_power_reply(void) {
  *
  * @return Direction enum (0-7), or current_direction if parse error
  */
-int parse_direction_from_command(void) {
-    if (command_length < 7) {
+int parse_direction_from_command(const CommandView& cmd) {
+    if (cmd.len < 7) {
         return current_direction;  // Invalid command
     }
     
-    // Extract digits from command_buffer[3], command_buffer[4], command_buffer[5]
+    // Extract digits from cmd[3], cmd[4], cmd[5]
     // which contain the azimuth (e.g., "045" for northeast)
-    int digit2 = (int)command_buffer[4] - '0';  // Middle digit
+    int digit2 = (int)cmd[4] - '0';  // Middle digit
     
     // Map angle to direction
     switch (digit2) {
@@ -404,12 +704,12 @@ int parse_direction_from_command(void) {
  *
  * @param direction Direction enum (0-7)
  */
-void handle_set_direction(int direction) {
+void handle_set_direction(int direction, const CommandView& cmd) {
     Serial.printf("Setting target direction to %d (%s°)\n",
                   direction, DIRECTION_ANGLES[direction]);
     
     // Check if terminator is CR (execute now) or semicolon (store only)
-    char terminator = command_buffer[command_length - 1];
+    char terminator = cmd[cmd.len - 1];
     
     if (terminator == CMD_TERMINATOR_CR) {
         // Execute immediately
@@ -442,6 +742,232 @@ void handle_power_query(void) {
     build_power_reply();
 }
 
+/**
+ * @brief Handle sensor statistics query (SA, S0-S7, SR)
+ */
+void handle_stats_query(const CommandView& cmd) {
+    char scope = cmd[1];
+    if (scope == STATS_SUB_RESET) {
+        Serial.println("Sensor statistics reset");
+        sensor_stats_reset();
+        scope = STATS_SUB_ALL;
+    }
+    build_stats_reply(scope);
+}
+
+/**
+ * @brief Handle relay operation counter command (OQ or OZnn)
+ */
+void handle_wear_command(const CommandView& cmd) {
+    if (cmd[1] == WEAR_SUB_CLEAR) {
+        uint8_t relay = (cmd[2] - '0') * 10 + (cmd[3] - '0');
+        if (relay >= 1 && relay <= RELAY_COUNT) {
+            Serial.printf("Relay %d operation count restarted (was %lu)\n",
+                          relay, (unsigned long)relay_wear_ops(relay - 1));
+            relay_wear_clear(relay - 1);
+        }
+    }
+    build_wear_reply();
+}
+
+/**
+ * @brief Handle scheduled direction change command (TAXXXXXXXXD, TC or TQ)
+ *
+ * Replies "TXSNN": sub-command, ScheduleStatus digit, entries queued.
+ */
+void handle_schedule_command(const CommandView& cmd) {
+    char sub = cmd[1];
+    ScheduleStatus status = SCHEDULE_OK;
+    
+    if (sub == SCHED_SUB_ADD) {
+        uint32_t due_ms = cmd.number(2, 8, 16);
+        uint8_t direction = cmd[10] - '0';
+        status = schedule_add(due_ms, direction);
+        Serial.printf("Switch to %s° scheduled at %lu (in %ld ms): status %d\n",
+                      DIRECTION_ANGLES[direction], (unsigned long)due_ms,
+                      (long)(int32_t)(due_ms - millis()), status);
+    } else if (sub == SCHED_SUB_CLEAR) {
+        schedule_clear();
+        Serial.println("Scheduled direction changes cleared");
+    }
+    
+    char reply[REPLY_SCHED_LEN + 1];
+    snprintf(reply, sizeof(reply), "%c%c%u%02X", REPLY_PREFIX_SCHEDULE, sub, status,
+             schedule_pending());
+    reply_length = 0;
+    append_to_reply(reply, REPLY_SCHED_LEN);
+}
+
+static_assert(RELAY_PROFILE_COUNT <= 16, "Profile command carries one hex digit");
+
+/**
+ * @brief Handle relay map profile select (Pn)
+ *
+ * Re-applies the current direction from the new profile's table in the
+ * same exchange, so the array is ready for the new band when the reply
+ * goes out (unless RF is present; then the interlock holds the switch).
+ * An unknown profile leaves everything as it was; the 'g' field of the
+ * position reply tells the controller which profile is in use.
+ */
+void handle_profile_command(const CommandView& cmd) {
+    uint8_t profile = (uint8_t)cmd.number(1, 1, 16);
+    
+    if (!relays_set_profile(profile)) {
+        Serial.printf("ERROR: Relay map profile %u not configured\n", profile);
+    } else {
+        Serial.printf("Relay map profile %u selected\n", profile);
+        set_antenna_direction(current_direction);
+    }
+    
+    measure_sensors();
+    build_position_reply(current_direction);
+}
+
+/**
+ * @brief Handle telemetry history query (HTSSSSSSSS)
+ */
+void handle_history_query(const CommandView& cmd) {
+    uint8_t tier = cmd[1] - '0';
+    uint32_t since_ms = cmd.number(2, 8, 16);
+    DEBUG_PRINTF("History query: tier %d since %08lX\n", tier, (unsigned long)since_ms);
+    build_history_reply(tier, since_ms);
+}
+
+/**
+ * @brief Handle compressed bulk download request (BTSSSSSSSS)
+ *
+ * Encodes the session and replies "BTSSCCLLLLLLLLM"; the chunks themselves
+ * are streamed from loop() after the reply has been ACKed.
+ */
+void handle_bulk_start(const CommandView& cmd) {
+    uint8_t tier = cmd[1] - '0';
+    uint32_t since_ms = cmd.number(2, 8, 16);
+    uint8_t chunks = bulk_start(tier, since_ms);
+    
+    char bulk_str[REPLY_BULK_FIELD_LEN + 1];
+    snprintf(bulk_str, sizeof(bulk_str), "%c%c%02X%02X%08lX%c",
+             REPLY_PREFIX_BULK, '0' + tier, bulk_session(), chunks,
+             (unsigned long)bulk_last_start_ms(), bulk_more() ? '1' : '0');
+    reply_length = 0;
+    append_to_reply(bulk_str, REPLY_BULK_FIELD_LEN);
+    
+    bulk_stream_mask = (chunks >= 16) ? 0xFFFF : (uint16_t)((1U << chunks) - 1);
+}
+
+/**
+ * @brief Handle bulk chunk retransmit request (RSSMMMM)
+ *
+ * Only chunks of the current session are resent; a stale session id gets
+ * an empty mask so the controller restarts the download.
+ */
+void handle_bulk_resend(const CommandView& cmd) {
+    uint8_t session = cmd.number(1, 2, 16);
+    uint16_t mask = cmd.number(3, 4, 16);
+    
+    if (session != bulk_session()) {
+        mask = 0;
+    }
+    uint8_t chunks = bulk_chunk_count();
+    if (chunks < 16) {
+        mask &= (1U << chunks) - 1;
+    }
+    
+    char resend_str[CMD_RESEND_LEN + 1];
+    snprintf(resend_str, sizeof(resend_str), "%c%02X%04X",
+             REPLY_PREFIX_RESEND, session, mask);
+    reply_length = 0;
+    append_to_reply(resend_str, CMD_RESEND_LEN);
+    
+    bulk_stream_mask = mask;
+}
+
+/**
+ * @brief Handle a reverse power calibration command (CB/CPNNNNN/CE/CA/CQ/CD)
+ *
+ * Calibration applies to the current direction. For each reference point
+ * the operator transmits a steady carrier, reads reflected power on an
+ * external wattmeter and sends it with CP; the phaser pairs it with its
+ * own windowed RMS detector reading. Replies list the table afterwards
+ * (the working table while a session is open).
+ */
+void handle_calibration(const CommandView& cmd) {
+    char sub = cmd[1];
+    uint8_t direction = (uint8_t)current_direction;
+    CalStatus status = CAL_OK;
+    
+    switch (sub) {
+        case CAL_SUB_BEGIN:
+            status = cal_begin(direction);
+            break;
+        case CAL_SUB_POINT: {
+            RfPowerStats rev;
+            rf_power_read(RF_CH_REV, rev);
+            uint32_t ref_dw = cmd.number(2, 5, 10);
+            if (ref_dw > UINT16_MAX) {
+                ref_dw = UINT16_MAX;
+            }
+            status = cal_add_point(direction, rev.rms, (uint16_t)ref_dw);
+            DEBUG_PRINTF("Cal point: ADC %u (Q6) = %lu dW\n", rev.rms, (unsigned long)ref_dw);
+            break;
+        }
+        case CAL_SUB_END:
+            status = cal_commit();
+            break;
+        case CAL_SUB_ABORT:
+            cal_abort();
+            break;
+        case CAL_SUB_QUERY:
+            break;
+        case CAL_SUB_DEFAULT:
+            status = cal_restore_default(direction);
+            break;
+    }
+    
+    const CalTable& table = cal_active() ? cal_working_table() : cal_table(direction);
+    char flag = cal_active() ? 'W' : (cal_is_calibrated(direction) ? '1' : '0');
+    char field[12];
+    
+    reply_length = 0;
+    snprintf(field, sizeof(field), "%c%c%u%u%c%X",
+             REPLY_PREFIX_CAL, sub, status, direction, flag, table.count);
+    append_to_reply(field, strlen(field));
+    for (uint8_t i = 0; i < table.count; i++) {
+        snprintf(field, sizeof(field), "%04X%04X",
+                 table.points[i].adc_q6, table.points[i].power_dw);
+        append_to_reply(field, 8);
+    }
+    
+    Serial.printf("Calibration %c for %s°: status %d, %d points\n",
+                  sub, DIRECTION_ANGLES[direction], status, table.count);
+}
+
+/**
+ * @brief Stream pending bulk chunks to the controller
+ *
+ * Sent as plain datagrams: the bulk layer does its own selective
+ * retransmission, so waiting for an ACK after every chunk would only
+ * add turnarounds.
+ *
+ * @param to Destination address
+ */
+void stream_bulk_chunks(uint8_t to) {
+    for (uint8_t i = 0; i < 16 && bulk_stream_mask; i++) {
+        if (!(bulk_stream_mask & (1U << i))) {
+            continue;
+        }
+        bulk_stream_mask &= ~(1U << i);
+        
+        uint8_t len;
+        const uint8_t* chunk = bulk_chunk(i, len);
+        if (chunk == NULL) {
+            continue;
+        }
+        rf95_manager.sendto((uint8_t*)chunk, len, to);
+        rf95_manager.waitPacketSent();
+        DEBUG_PRINTF("Bulk chunk %d sent (%d bytes)\n", i, len);
+    }
+}
+
 /**
  * @brief Process received command from controller
  *
@@ -450,38 +976,52 @@ void handle_power_query(void) {
  * - AI1 ; or AM1        = Report position/execute
  * - V                   = Report power/telemetry
  * - ;                   = Stop/emergency stop
+ * - L                   = Relearn relay coil currents
+ * - HTSSSSSSSS          = Fetch telemetry history chunk
+ * - BTSSSSSSSS          = Start compressed bulk history download
+ * - RSSMMMM             = Resend bulk chunks
+ * - CB/CPNNNNN/CE/CA/CQ/CD = Reverse power calibration
+ * - SA/S0-S7/SR         = Sensor statistics (all, per direction, reset)
+ * - OQ/OZnn             = Relay operation counters (report, restart relay nn)
+ * - TAXXXXXXXXD/TC/TQ   = Scheduled direction changes (add, clear, query)
  */
-void process_command(void) {
-    if (command_length == 0) {
+void process_command(const CommandView& cmd) {
+    if (cmd.len == 0) {
         return;  // Empty command
     }
     
-    DEBUG_PRINTF("Processing command length %d: %s\n", command_length, command_buffer);
+    DEBUG_PRINTF("Processing command length %d: %s\n", cmd.len, cmd.text);
     
     // Single character commands
-    if (command_length == 1) {
-        switch (command_buffer[0]) {
+    if (cmd.len == 1) {
+        switch (cmd[0]) {
             case CMD_TYPE_POWER:      // 'V' - Report power
                 handle_power_query();
                 break;
+            case CMD_TYPE_RELEARN:    // 'L' - Relearn relay coil currents
+                Serial.println("Relay coil currents cleared, relearning");
+                relay_verify_forget();
+                measure_sensors();
+                build_position_reply(current_direction);
+                break;
             case ';':                 // ';' - Stop
                 DEBUG_PRINTLN("Stop command");
                 measure_sensors();
                 build_position_reply(current_direction);
                 break;
             default:
-                Serial.printf("Unknown single-char command: %c\n", command_buffer[0]);
+                Serial.printf("Unknown single-char command: %c\n", cmd[0]);
                 break;
         }
         return;
     }
     
     // Multi-character commands (3 or 7 bytes)
-    if (command_length == 3) {
+    if (cmd.len == 3) {
         // Format: "?I1" or "?M1" where ? is ignored
-        if (command_buffer[1] == CMD_TYPE_INFO_I) {
+        if (cmd[1] == CMD_TYPE_INFO_I) {
             handle_position_query();
-        } else if (command_buffer[1] == CMD_TYPE_INFO_M) {
+        } else if (cmd[1] == CMD_TYPE_INFO_M) {
             DEBUG_PRINTLN("Movement command - executing stored target direction");
             set_antenna_direction(target_direction);
             measure_sensors();
@@ -490,140 +1030,523 @@ void process_command(void) {
         return;
     }
     
-    if (command_length == 7) {
+    if (cmd.len == CMD_RESEND_LEN && cmd[0] == CMD_TYPE_RESEND) {
+        handle_bulk_resend(cmd);
+        return;
+    }
+    
+    if ((cmd.len == CMD_CAL_LEN || cmd.len == CMD_CAL_POINT_LEN) &&
+        cmd[0] == CMD_TYPE_CAL) {
+        handle_calibration(cmd);
+        return;
+    }
+    
+    if (cmd.len == CMD_STATS_LEN && cmd[0] == CMD_TYPE_STATS) {
+        handle_stats_query(cmd);
+        return;
+    }
+    
+    if ((cmd.len == CMD_WEAR_LEN || cmd.len == CMD_WEAR_CLEAR_LEN) &&
+        cmd[0] == CMD_TYPE_WEAR) {
+        handle_wear_command(cmd);
+        return;
+    }
+    
+    if ((cmd.len == CMD_SCHED_LEN || cmd.len == CMD_SCHED_ADD_LEN) &&
+        cmd[0] == CMD_TYPE_SCHEDULE) {
+        handle_schedule_command(cmd);
+        return;
+    }
+    
+    if (cmd.len == CMD_PROFILE_LEN && cmd[0] == CMD_TYPE_PROFILE) {
+        handle_profile_command(cmd);
+        return;
+    }
+    
+    if (cmd.len == 7) {
         // Format: AP1###\r  - Set direction
-        if (command_buffer[0] == CMD_PREFIX_A && 
-            command_buffer[1] == CMD_PREFIX_P &&
-            command_buffer[2] == CMD_PREFIX_1) {
+        if (cmd[0] == CMD_PREFIX_A && 
+            cmd[1] == CMD_PREFIX_P &&
+            cmd[2] == CMD_PREFIX_1) {
             
-            int direction = parse_direction_from_command();
-            handle_set_direction(direction);
+            int direction = parse_direction_from_command(cmd);
+            handle_set_direction(direction, cmd);
         } else {
             Serial.printf("Malformed set-direction command\n");
         }
         return;
     }
     
-    DEBUG_PRINTF("Unexpected command length: %d\n", command_length);
+    if (cmd.len == CMD_HISTORY_LEN && cmd[0] == CMD_TYPE_HISTORY) {
+        handle_history_query(cmd);
+        return;
+    }
+    
+    if (cmd.len == CMD_BULK_LEN && cmd[0] == CMD_TYPE_BULK) {
+        handle_bulk_start(cmd);
+        return;
+    }
+    
+    DEBUG_PRINTF("Unexpected command length: %d\n", cmd.len);
 }
 
 // ============================================================================
-// MAIN SETUP AND LOOP
+// PROTECTION EVENTS
 // ============================================================================
 
-void setup() {
-    init_all_hardware();
+/**
+ * @brief Report protection faults to the controller
+ *
+ * Sends one "EXDvVVVVViIIII" frame per fault bit. A trip has already
+ * released the relays from the alert interrupt; this only records the
+ * new direction and tells the controller.
+ *
+ * @param faults ProtectFault bits from protection_poll()
+ */
+void send_protection_events(uint8_t faults) {
+    static const struct {
+        uint8_t fault;
+        char code;
+        const char* text;
+    } EVENTS[] = {
+        {PROTECT_OVERCURRENT, EVENT_OVERCURRENT, "overcurrent, relays released"},
+        {PROTECT_UNDERVOLTAGE, EVENT_UNDERVOLTAGE, "undervoltage, relays released"},
+        {PROTECT_WARNING, EVENT_WARNING, "relay current warning"},
+        {PROTECT_CLEARED, EVENT_CLEARED, "trip cleared"},
+    };
+    
+#if RELAY_DRIVE != RELAY_DRIVE_LATCH
+    // Latching relays keep their contacts when the coils are cut
+    if (faults & (PROTECT_OVERCURRENT | PROTECT_UNDERVOLTAGE)) {
+        relay_wear_release();
+        current_direction = PROTECT_SAFE_DIRECTION;
+        applied_position = relays_position(PROTECT_SAFE_DIRECTION);
+    }
+#endif
+    measure_sensors();
+    
+    for (uint8_t e = 0; e < sizeof(EVENTS) / sizeof(EVENTS[0]); e++) {
+        if (!(faults & EVENTS[e].fault)) {
+            continue;
+        }
+        Serial.printf("PROTECTION: %s (%d mV, %d mA)\n",
+                      EVENTS[e].text, bus_voltage_mv, bus_current_ma);
+        
+        Packet* frame = packet_pool.alloc(PACKET_RADIO);
+        if (frame == NULL) {
+            Serial.println("ERROR: Packet pool empty, protection event not sent");
+            continue;
+        }
+        snprintf((char*)frame->data, REPLY_EVENT_LEN + 1, "%c%c%dv%05di%04d",
+                 REPLY_PREFIX_EVENT, EVENTS[e].code, current_direction,
+                 constrain(bus_voltage_mv, 0, 99999), constrain(bus_current_ma, 0, 9999));
+        frame->len = REPLY_EVENT_LEN;
+        if (!rf95_manager.sendtoWait(frame->data, frame->len, CTRL_ADDRESS)) {
+            Serial.println("ERROR: Failed to send protection event (no ACK)");
+        }
+        packet_pool.release(frame);
+    }
 }
 
-void loop() {
-    // Check if a message is available
-    if (rf95_manager.available()) {
-        uint8_t len = sizeof(command_buffer);
-        uint8_t from;
+// ============================================================================
+// SCHEDULED DIRECTION CHANGES
+// ============================================================================
+
+/**
+ * @brief Account for direction changes made by the schedule timer
+ *
+ * The timer interrupt only writes the relays. Waits first for an entry
+ * due within SCHEDULE_GUARD_MS, so a command never switches in the
+ * middle of a scheduled change.
+ */
+void process_scheduled_changes(void) {
+    schedule_wait_clear(SCHEDULE_GUARD_MS);
+    
+    ScheduleReport done;
+    while (schedule_next_fired(done)) {
+        switch (done.result) {
+            case SCHEDULE_APPLIED:
+                interlock_request(done.direction, false);  // Supersedes a held change
+                relay_wear_count(relays_pattern(done.position));
+                applied_position = done.position;
+                current_direction = done.direction;
+                Serial.printf("Scheduled switch to %s° made %d us after its time\n",
+                              DIRECTION_ANGLES[done.direction], done.late_us);
+                break;
+            case SCHEDULE_HELD:
+                interlock_hold(done.direction);
+                Serial.printf("RF present, scheduled switch to %s° held until it drops\n",
+                              DIRECTION_ANGLES[done.direction]);
+                break;
+            case SCHEDULE_BLOCKED:
+                Serial.printf("Scheduled switch to %s° dropped after a protection trip\n",
+                              DIRECTION_ANGLES[done.direction]);
+                break;
+        }
+    }
+}
+
+static_assert(2 + SCHED_REPORT_MAX * SCHED_REPORT_TEXT_LEN < PACKET_MTU,
+              "Schedule confirmation frame too long");
+
+/**
+ * @brief Report a batch of scheduled change confirmations to the controller
+ *
+ * Sends one "XN" + N x "DTTTTTTTTLLLLR" frame. Confirmations that are not
+ * ACKed stay queued for the next attempt.
+ */
+void send_schedule_reports(void) {
+    ScheduleReport done[SCHED_REPORT_MAX];
+    uint8_t count = schedule_unreported(done, SCHED_REPORT_MAX);
+    if (count == 0) {
+        return;
+    }
+    
+    Packet* frame = packet_pool.alloc(PACKET_RADIO);
+    if (frame == NULL) {
+        return;  // Stays queued for the next attempt
+    }
+    char* text = (char*)frame->data;
+    snprintf(text, PACKET_MTU, "%c%X", REPLY_PREFIX_SCHED_REPORT, count);
+    for (uint8_t i = 0; i < count; i++) {
+        snprintf(text + 2 + i * SCHED_REPORT_TEXT_LEN, SCHED_REPORT_TEXT_LEN + 1,
+                 "%u%08lX%04X%c", done[i].direction, (unsigned long)done[i].due_ms,
+                 (uint16_t)done[i].late_us, done[i].result);
+    }
+    
+    frame->len = 2 + count * SCHED_REPORT_TEXT_LEN;
+    if (rf95_manager.sendtoWait(frame->data, frame->len, CTRL_ADDRESS)) {
+        schedule_reported(count);
+        DEBUG_PRINTF("Reported %d scheduled changes\n", count);
+    } else {
+        Serial.println("ERROR: Failed to send schedule confirmations (no ACK)");
+    }
+    packet_pool.release(frame);
+}
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+/**
+ * @brief Light the status LED; the status task turns it off
+ *
+ * @param ms Time to stay lit
+ */
+void led_flash(uint32_t ms) {
+    STATUS_LED.high();
+    led_off_ms = millis() + ms;
+    led_lit = true;
+}
+
+/**
+ * @brief Check a command's length and format before it is processed
+ *
+ * @param cmd Authenticated command
+ * @return true if it is one of the commands process_command() handles
+ */
+bool command_format_valid(const CommandView& cmd) {
+    bool valid_format = false;
+    if (cmd.len == 1 && (cmd[0] == 'V' || cmd[0] == ';' ||
+                         cmd[0] == CMD_TYPE_RELEARN)) {
+        valid_format = true;  // Single-char commands: V, ; or L
+    } else if (cmd.len == 3 && cmd[0] == 'A' && 
+              (cmd[1] == 'I' || cmd[1] == 'M')) {
+        valid_format = true;  // AI1 or AM1 format
+    } else if (cmd.len == 7 && cmd[0] == 'A' && 
+              cmd[1] == 'P' && cmd[2] == '1') {
+        // AP1### format - validate angle digits
+        valid_format = (isdigit(cmd[3]) && 
+                       isdigit(cmd[4]) && 
+                       isdigit(cmd[5]));
+    } else if ((cmd.len == CMD_HISTORY_LEN && cmd[0] == CMD_TYPE_HISTORY) ||
+               (cmd.len == CMD_BULK_LEN && cmd[0] == CMD_TYPE_BULK)) {
+        // HTSSSSSSSS / BTSSSSSSSS format - tier digit and 8 hex digits
+        valid_format = (cmd[1] >= '0' &&
+                        cmd[1] < '0' + HISTORY_NUM_TIERS);
+        for (int i = 2; i < cmd.len; i++) {
+            valid_format = valid_format && isxdigit(cmd[i]);
+        }
+    } else if (cmd.len == CMD_CAL_LEN && cmd[0] == CMD_TYPE_CAL) {
+        // CB, CE, CA, CQ, CD
+        valid_format = (cmd[1] == CAL_SUB_BEGIN ||
+                        cmd[1] == CAL_SUB_END ||
+                        cmd[1] == CAL_SUB_ABORT ||
+                        cmd[1] == CAL_SUB_QUERY ||
+                        cmd[1] == CAL_SUB_DEFAULT);
+    } else if (cmd.len == CMD_CAL_POINT_LEN && cmd[0] == CMD_TYPE_CAL) {
+        // CPNNNNN format - 5 decimal digits
+        valid_format = (cmd[1] == CAL_SUB_POINT);
+        for (int i = 2; i < CMD_CAL_POINT_LEN; i++) {
+            valid_format = valid_format && isdigit(cmd[i]);
+        }
+    } else if (cmd.len == CMD_STATS_LEN && cmd[0] == CMD_TYPE_STATS) {
+        // SA, SR or S0-S7
+        valid_format = (cmd[1] == STATS_SUB_ALL ||
+                        cmd[1] == STATS_SUB_RESET ||
+                        (cmd[1] >= '0' &&
+                         cmd[1] < '0' + NUM_DIRECTIONS));
+    } else if (cmd.len == CMD_WEAR_LEN && cmd[0] == CMD_TYPE_WEAR) {
+        // OQ
+        valid_format = (cmd[1] == WEAR_SUB_QUERY);
+    } else if (cmd.len == CMD_WEAR_CLEAR_LEN && cmd[0] == CMD_TYPE_WEAR) {
+        // OZnn format - 2 decimal digits
+        valid_format = (cmd[1] == WEAR_SUB_CLEAR &&
+                        isdigit(cmd[2]) && isdigit(cmd[3]));
+    } else if (cmd.len == CMD_SCHED_LEN && cmd[0] == CMD_TYPE_SCHEDULE) {
+        // TC or TQ
+        valid_format = (cmd[1] == SCHED_SUB_CLEAR ||
+                        cmd[1] == SCHED_SUB_QUERY);
+    } else if (cmd.len == CMD_SCHED_ADD_LEN && cmd[0] == CMD_TYPE_SCHEDULE) {
+        // TAXXXXXXXXD format - 8 hex digits and a direction digit
+        valid_format = (cmd[1] == SCHED_SUB_ADD &&
+                        cmd[10] >= '0' &&
+                        cmd[10] < '0' + NUM_DIRECTIONS);
+        for (int i = 2; i < 10; i++) {
+            valid_format = valid_format && isxdigit(cmd[i]);
+        }
+    } else if (cmd.len == CMD_PROFILE_LEN && cmd[0] == CMD_TYPE_PROFILE) {
+        // Pn format - 1 hex digit
+        valid_format = isxdigit(cmd[1]);
+    } else if (cmd.len == CMD_RESEND_LEN && cmd[0] == CMD_TYPE_RESEND) {
+        // RSSMMMM format - 6 hex digits
+        valid_format = true;
+        for (int i = 1; i < CMD_RESEND_LEN; i++) {
+            valid_format = valid_format && isxdigit(cmd[i]);
+        }
+    }
+    return valid_format;
+}
+
+/**
+ * @brief Authenticate and validate a received frame in place
+ *
+ * Cheap checks come first (sender, length), so a frame that cannot be a
+ * command is dropped before its hash is computed. On success the first
+ * authentication byte is overwritten with '\0' to terminate the command.
+ *
+ * @param frame Received frame
+ * @param from Sender address
+ * @param cmd Set to the command inside the frame
+ * @return true if the frame holds a valid command
+ */
+bool open_command(Packet* frame, uint8_t from, CommandView& cmd) {
+    // Only process messages from controller
+    if (from != CTRL_ADDRESS) {
+        DEBUG_PRINTF("Message from unknown address %d, ignoring\n", from);
+        return false;
+    }
+    
+    // ====================================================================
+    // AUTHENTICATION CHECK
+    // ====================================================================
+    // Commands should be: [actual_command] + [auth_hi][auth_lo]
+    if (frame->len < 1 + AUTH_LEN || frame->len > MAX_COMMAND_LEN + AUTH_LEN) {
+        Serial.printf("ERROR: Packet length %d out of range, rejecting\n", frame->len);
+        return false;
+    }
+    
+    packet_pool.pass(frame, PACKET_AUTH);
+    uint8_t cmd_len = frame->len - AUTH_LEN;  // Actual command length (without auth)
+    uint16_t received_auth = ((uint16_t)frame->data[cmd_len] << 8) | frame->data[cmd_len + 1];
+    uint16_t computed_auth = compute_auth(frame->data, cmd_len);
+    
+    if (received_auth != computed_auth) {
+        Serial.printf("ERROR: Authentication failed! Received [%04X] but expected [%04X]\n",
+                     received_auth, computed_auth);
+        return false;  // Drop packet silently
+    }
+    
+    DEBUG_PRINTF("✓ Authentication valid [%04X]\n", computed_auth);
+    
+    // ====================================================================
+    // FORMAT VALIDATION
+    // ====================================================================
+    frame->data[cmd_len] = '\0';  // Terminate over the checked auth bytes
+    cmd.text = (const char*)frame->data;
+    cmd.len = cmd_len;
+    
+    if (!command_format_valid(cmd)) {
+        Serial.printf("ERROR: Invalid command format (len=%d)\n", cmd_len);
+        return false;  // Drop packet
+    }
+    
+    DEBUG_PRINTLN("✓ Format validation passed");
+    packet_pool.pass(frame, PACKET_APP);
+    return true;
+}
+
+/**
+ * @brief Radio task: receive, authenticate, validate, process and reply
+ *
+ * The frame is received whole into a pooled packet and the command is
+ * handled where it landed; the packet goes back to the pool as soon as
+ * the reply has been built.
+ */
+void task_radio(void) {
+    if (!rf95_manager.available()) {
+        return;
+    }
+    
+    // Receive message (left in the radio until a packet is free)
+    Packet* frame = packet_pool.alloc(PACKET_RADIO);
+    if (frame == NULL) {
+        return;
+    }
+    frame->len = PACKET_MTU;
+    uint8_t from;
+    if (!rf95_manager.recvfromAck(frame->data, &frame->len, &from)) {
+        packet_pool.release(frame);
+        return;
+    }
+    command_rx_ms = millis();
+    
+    CommandView cmd;
+    if (!open_command(frame, from, cmd)) {
+        packet_pool.release(frame);
+        return;
+    }
+    
+    // ========================================================================
+    // COMMAND PROCESSING
+    // ========================================================================
+    packet_count++;
+    
+    if (DEBUG) {
+        Serial.println("================================");
+        Serial.printf("Packet #%d from #%d [RSSI:%d]: ",
+                     packet_count, from, rf95.lastRssi());
+        Serial.println(cmd.text);
+    } else {
+        Serial.printf("Packet #%d from #%d\n", packet_count, from);
+    }
+    
+    // Process the command, building the reply in place
+    reply_packet = packet_pool.alloc(PACKET_APP);
+    if (reply_packet == NULL) {
+        Serial.println("ERROR: Packet pool empty, command dropped");
+        packet_pool.release(frame);
+        return;
+    }
+    reply_length = 0;
+    process_command(cmd);
+    packet_pool.release(frame);
+    append_time_field();
+    
+    // Send reply
+    reply_packet->len = (uint8_t)reply_length;
+    packet_pool.pass(reply_packet, PACKET_RADIO);
+    if (DEBUG) {
+        Serial.printf("Sending reply, length %d\n", reply_packet->len);
+    }
+    
+    bool sent = rf95_manager.sendtoWait(reply_packet->data, reply_packet->len, from);
+    packet_pool.release(reply_packet);
+    if (!sent) {
+        Serial.println("ERROR: Failed to send reply (no ACK)");
+        bulk_stream_mask = 0;
+        led_flash(50);
+    } else {
+        // Blink LED to indicate successful transmission
+        led_flash(10);
         
-        // Receive message
-        if (rf95_manager.recvfromAck((uint8_t*)command_buffer, &len, &from)) {
-            
-            // Only process messages from controller
-            if (from != CTRL_ADDRESS) {
-                DEBUG_PRINTF("Message from unknown address %d, ignoring\n", from);
-                return;
-            }
-            
-            // ================================================================
-            // AUTHENTICATION CHECK
-            // ================================================================
-            // Commands should be: [actual_command] + [auth_hi][auth_lo]
-            if (len < 3) {  // Minimum: 1 byte command + 2 auth bytes
-                Serial.printf("ERROR: Packet too short (%d bytes), rejecting\n", len);
-                return;
-            }
-            
-            uint8_t cmd_len = len - AUTH_LEN;  // Actual command length (without auth)
-            uint16_t received_auth = ((uint16_t)command_buffer[cmd_len] << 8) | 
-                                     command_buffer[cmd_len + 1];
-            uint16_t computed_auth = compute_auth((uint8_t*)command_buffer, cmd_len);
-            
-            if (received_auth != computed_auth) {
-                Serial.printf("ERROR: Authentication failed! Received [%04X] but expected [%04X]\n",
-                             received_auth, computed_auth);
-                return;  // Drop packet silently
-            }
-            
-            DEBUG_PRINTF("✓ Authentication valid [%04X]\n", computed_auth);
-            
-            // ================================================================
-            // FORMAT VALIDATION
-            // ================================================================
-            // Validate command format before processing
-            bool valid_format = false;
-            
-            if (cmd_len == 1 && (command_buffer[0] == 'V' || command_buffer[0] == ';')) {
-                valid_format = true;  // Single-char commands: V or ;
-            } else if (cmd_len == 3 && command_buffer[0] == 'A' && 
-                      (command_buffer[1] == 'I' || command_buffer[1] == 'M')) {
-                valid_format = true;  // AI1 or AM1 format
-            } else if (cmd_len == 7 && command_buffer[0] == 'A' && 
-                      command_buffer[1] == 'P' && command_buffer[2] == '1') {
-                // AP1### format - validate angle digits
-                valid_format = (isdigit(command_buffer[3]) && 
-                               isdigit(command_buffer[4]) && 
-                               isdigit(command_buffer[5]));
-            }
-            
-            if (!valid_format) {
-                Serial.printf("ERROR: Invalid command format (len=%d)\n", cmd_len);
-                return;  // Drop packet
-            }
-            
-            DEBUG_PRINTLN("✓ Format validation passed");
-            
-            // ================================================================
-            // COMMAND PROCESSING
-            // ================================================================
-            // Strip auth bytes and process
-            command_length = cmd_len;
-            if (command_length > MAX_COMMAND_LEN - 1) {
-                command_length = MAX_COMMAND_LEN - 1;
-            }
-            command_buffer[command_length] = '\0';  // Null terminate
-            
-            packet_count++;
-            
-            if (DEBUG) {
-                Serial.println("================================");
-                Serial.printf("Packet #%d from #%d [RSSI:%d]: ",
-                             packet_count, from, rf95.lastRssi());
-                Serial.println(command_buffer);
-            } else {
-                Serial.printf("Packet #%d from #%d\n", packet_count, from);
-            }
-            
-            // Process the command
-            process_command();
-            
-            // Send reply
-            uint8_t rlen = (uint8_t)reply_length;
-            if (DEBUG) {
-                Serial.printf("Sending reply, length %d\n", rlen);
-            }
-            
-            if (!rf95_manager.sendtoWait(reply_buffer, rlen, from)) {
-                Serial.println("ERROR: Failed to send reply (no ACK)");
-                digitalWrite(LED, HIGH);
-                delay(50);
-                digitalWrite(LED, LOW);
-            } else {
-                // Blink LED to indicate successful transmission
-                digitalWrite(LED, HIGH);
-                delay(10);
-                digitalWrite(LED, LOW);
-            }
+        // Follow a bulk session reply with its data chunks
+        if (bulk_stream_mask) {
+            stream_bulk_chunks(from);
         }
     }
+}
+
+/**
+ * @brief Relay task: book scheduled changes, apply a held change, report trips
+ */
+void task_relays(void) {
+    // Book the changes made by the schedule timer
+    process_scheduled_changes();
+    
+    // Apply a direction change held while RF was present
+    int held_direction = interlock_poll();
+    if (held_direction >= 0) {
+        uint32_t wait_ms;
+        interlock_status(wait_ms);
+        Serial.printf("RF dropped, switching to %s° after %lu ms\n",
+                      DIRECTION_ANGLES[held_direction], (unsigned long)wait_ms);
+        apply_antenna_direction(held_direction);
+    }
+    
+    // Report protection trips raised by the INA3221 alerts
+    uint8_t faults = protection_poll();
+    if (faults) {
+        send_protection_events(faults);
+    }
+}
+
+/**
+ * @brief Report task: confirm executed schedule entries in batches
+ */
+void task_report(void) {
+    if (schedule_report_due()) {
+        send_schedule_reports();
+    }
+}
+
+/**
+ * @brief Status task: end an LED flash, log the task, packet pool and radio
+ * FIFO statistics
+ */
+void task_status(void) {
+    static uint32_t last_log_ms = 0;
     
-    // Small delay to reduce CPU usage
-    delay(10);
+    if (led_lit && (int32_t)(millis() - led_off_ms) >= 0) {
+        STATUS_LED.low();
+        led_lit = false;
+    }
+    if (millis() - last_log_ms >= TASK_LOG_MS) {
+        last_log_ms = millis();
+        tasks_log();
+        Serial.printf("Packets: %u of %u in use, peak %u, %lu allocations failed\n",
+                      packet_pool.in_use(), packet_pool.capacity(), packet_pool.high_water(),
+                      (unsigned long)packet_pool.failures());
+        rf95.timing_print(Serial);
+    }
+}
+
+/**
+ * @brief Flush task: save the latched relay pattern, the operation
+ * counters once a batch is due and switching is quiet, and newly learned
+ * coil currents
+ */
+void task_flush(void) {
+    relays_poll();
+    relay_wear_poll();
+    relay_verify_poll();
 }
 
+// ============================================================================
+// MAIN SETUP AND LOOP
+// ============================================================================
+
+void setup() {
+    init_all_hardware();
+    
+    tasks_add("radio", task_radio, TASK_RADIO_PERIOD_MS, TASK_RADIO_DEADLINE_MS,
+              TASK_RADIO_PRIORITY);
+    tasks_add("relays", task_relays, TASK_RELAY_PERIOD_MS, TASK_RELAY_DEADLINE_MS,
+              TASK_RELAY_PRIORITY);
+    tasks_add("sample", sample_history, TASK_SAMPLE_PERIOD_MS, TASK_SAMPLE_DEADLINE_MS,
+              TASK_SAMPLE_PRIORITY);
+    tasks_add("report", task_report, TASK_REPORT_PERIOD_MS, TASK_REPORT_DEADLINE_MS,
+              TASK_REPORT_PRIORITY);
+    tasks_add("status", task_status, TASK_STATUS_PERIOD_MS, TASK_STATUS_DEADLINE_MS,
+              TASK_STATUS_PRIORITY);
+    tasks_add("flush", task_flush, TASK_FLUSH_PERIOD_MS, TASK_FLUSH_DEADLINE_MS,
+              TASK_FLUSH_PRIORITY);
+}
 
+void loop() {
+    // The most urgent task that is due; with none due, sleep until the
+    // next interrupt (SysTick wakes every millisecond)
+    if (!tasks_run()) {
+        __WFI();
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file nvm_eeprom.cpp
+ * @brief Wear-levelled emulated EEPROM on SAMD21 flash
+ *
+ * Slot layout: {sequence (4), length (2), checksum (2), payload}. Erased
+ * flash reads as 0xFF, so a blank slot has sequence 0xFFFFFFFF, which is
+ * never written. The checksum covers the sequence, length and payload.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "nvm_eeprom.h"
+
+// ============================================================================
+// SLOT FORMAT
+// ============================================================================
+
+/** @brief Header in front of every record copy */
+struct NvmEepromHeader {
+    uint32_t seq;          /**< Write sequence number, 0xFFFFFFFF = blank */
+    uint16_t len;          /**< Payload bytes */
+    uint16_t checksum;     /**< nvm_checksum() of the slot, this field as 0 */
+};
+
+static_assert(sizeof(NvmEepromHeader) == 8, "NVM_EEPROM_MAX_RECORD assumes an 8-byte header");
+
+/** @brief Blank slot sequence number */
+#define NVM_EEPROM_BLANK_SEQ 0xFFFFFFFFUL
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Flash address of a slot
+ */
+static const uint8_t* slot_addr(const NvmEeprom& ee, uint16_t slot) {
+    return ee.area + (size_t)slot * ee.slot_bytes;
+}
+
+/**
+ * @brief Checksum of a slot image
+ *
+ * @param image Header + payload, checksum field ignored
+ * @param len Payload bytes
+ * @return Checksum
+ */
+static uint16_t slot_checksum(uint8_t* image, uint16_t len) {
+    NvmEepromHeader* h = (NvmEepromHeader*)image;
+    uint16_t stored = h->checksum;
+    h->checksum = 0;
+    uint16_t sum = nvm_checksum(image, sizeof(NvmEepromHeader) + len);
+    h->checksum = stored;
+    return sum;
+}
+
+/**
+ * @brief Read and validate one slot
+ *
+ * @param ee Attached area
+ * @param slot Slot
+ * @param image Output, slot_bytes long
+ * @return Sequence number, or NVM_EEPROM_BLANK_SEQ if blank or invalid
+ */
+static uint32_t slot_load(const NvmEeprom& ee, uint16_t slot, uint8_t* image) {
+    nvm_read(slot_addr(ee, slot), image, ee.slot_bytes);
+    const NvmEepromHeader* h = (const NvmEepromHeader*)image;
+    if (h->seq == NVM_EEPROM_BLANK_SEQ || h->len != ee.record_len ||
+        h->checksum != slot_checksum(image, ee.record_len)) {
+        return NVM_EEPROM_BLANK_SEQ;
+    }
+    return h->seq;
+}
+
+/**
+ * @brief Whether a slot is still erased
+ */
+static bool slot_blank(const NvmEeprom& ee, uint16_t slot) {
+    const volatile uint8_t* p = slot_addr(ee, slot);
+    for (uint16_t i = 0; i < ee.slot_bytes; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool nvm_eeprom_init(NvmEeprom& ee, const uint8_t* area, size_t area_bytes, size_t record_len) {
+    ee.area = area;
+    ee.record_len = (uint16_t)record_len;
+    ee.newest_slot = -1;
+    ee.next_slot = 0;
+    ee.next_seq = 0;
+
+    if ((uintptr_t)area % NVM_ROW_SIZE || area_bytes < 2 * NVM_ROW_SIZE ||
+        record_len > NVM_EEPROM_MAX_RECORD) {
+        ee.slots = 0;
+        return false;
+    }
+
+    // 1, 2 or 4 pages per slot, so slots never straddle a row
+    uint16_t need = sizeof(NvmEepromHeader) + record_len;
+    ee.slot_bytes = NVM_PAGE_SIZE;
+    while (ee.slot_bytes < need) {
+        ee.slot_bytes *= 2;
+    }
+    ee.slots = (uint16_t)((area_bytes / NVM_ROW_SIZE) * (NVM_ROW_SIZE / ee.slot_bytes));
+
+    uint8_t image[NVM_ROW_SIZE];
+    uint32_t newest_seq = 0;
+    for (uint16_t s = 0; s < ee.slots; s++) {
+        uint32_t seq = slot_load(ee, s, image);
+        if (seq != NVM_EEPROM_BLANK_SEQ && (ee.newest_slot < 0 || seq > newest_seq)) {
+            newest_seq = seq;
+            ee.newest_slot = (int16_t)s;
+        }
+    }
+    if (ee.newest_slot >= 0) {
+        ee.next_slot = (uint16_t)((ee.newest_slot + 1) % ee.slots);
+        ee.next_seq = newest_seq + 1;
+    }
+    return true;
+}
+
+bool nvm_eeprom_read(const NvmEeprom& ee, void* data) {
+    if (ee.newest_slot < 0) {
+        return false;
+    }
+    uint8_t image[NVM_ROW_SIZE];
+    if (slot_load(ee, (uint16_t)ee.newest_slot, image) == NVM_EEPROM_BLANK_SEQ) {
+        return false;
+    }
+    memcpy(data, image + sizeof(NvmEepromHeader), ee.record_len);
+    return true;
+}
+
+bool nvm_eeprom_write(NvmEeprom& ee, const void* data) {
+    if (ee.slots == 0) {
+        return false;
+    }
+
+    uint8_t image[NVM_ROW_SIZE];
+    memset(image, 0xFF, ee.slot_bytes);
+    NvmEepromHeader* h = (NvmEepromHeader*)image;
+    h->seq = ee.next_seq;
+    h->len = ee.record_len;
+    memcpy(image + sizeof(NvmEepromHeader), data, ee.record_len);
+    h->checksum = slot_checksum(image, ee.record_len);
+
+    const uint16_t slots_per_row = NVM_ROW_SIZE / ee.slot_bytes;
+    for (uint16_t attempt = 0; attempt < ee.slots; attempt++) {
+        uint16_t slot = ee.next_slot;
+        const uint8_t* addr = slot_addr(ee, slot);
+
+        if (slot % slots_per_row == 0) {
+            // Entering a row: erase it (holds only the oldest copies)
+            nvm_erase_rows(addr, NVM_ROW_SIZE);
+        } else if (!slot_blank(ee, slot)) {
+            // Left over from an interrupted write; move on to the next row
+            ee.next_slot = (uint16_t)(((slot / slots_per_row + 1) * slots_per_row) % ee.slots);
+            continue;
+        }
+
+        ee.next_slot = (uint16_t)((slot + 1) % ee.slots);
+        if (nvm_write_pages(addr, image, ee.slot_bytes)) {
+            ee.newest_slot = (int16_t)slot;
+            ee.next_seq++;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file nvm_flash.cpp
+ * @brief Minimal SAMD21 NVM (internal flash) storage helpers
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "nvm_flash.h"
+
+/**
+ * @brief Wait for the NVM controller to finish the current command
+ */
+static void nvm_wait_ready(void) {
+    while (!NVMCTRL->INTFLAG.bit.READY);
+}
+
+/**
+ * @brief Issue an NVM controller command
+ *
+ * @param cmd NVMCTRL_CTRLA_CMD_* value
+ */
+static void nvm_command(uint32_t cmd) {
+    NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | cmd;
+    nvm_wait_ready();
+}
+
+void nvm_read(const void* flash_addr, void* out, size_t len) {
+    const volatile uint8_t* src = (const volatile uint8_t*)flash_addr;
+    uint8_t* dst = (uint8_t*)out;
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = src[i];
+    }
+}
+
+bool nvm_erase_rows(const void* flash_addr, size_t len) {
+    uintptr_t addr = (uintptr_t)flash_addr;
+    if (addr % NVM_ROW_SIZE) {
+        return false;
+    }
+
+    for (size_t row = 0; row < len; row += NVM_ROW_SIZE) {
+        NVMCTRL->ADDR.reg = (addr + row) / 2;  // ADDR is in 16-bit words
+        nvm_command(NVMCTRL_CTRLA_CMD_ER);
+    }
+    return true;
+}
+
+bool nvm_write_pages(const void* flash_addr, const void* data, size_t len) {
+    uintptr_t addr = (uintptr_t)flash_addr;
+    const uint8_t* src = (const uint8_t*)data;
+
+    if (addr % NVM_PAGE_SIZE) {
+        return false;
+    }
+
+    // Manual write: pages are committed with an explicit WP command
+    NVMCTRL->CTRLB.bit.MANW = 1;
+
+    for (size_t page = 0; page < len; page += NVM_PAGE_SIZE) {
+        nvm_command(NVMCTRL_CTRLA_CMD_PBC);
+
+        // The page buffer only accepts 16/32-bit writes
+        volatile uint32_t* dst = (volatile uint32_t*)(addr + page);
+        for (size_t w = 0; w < NVM_PAGE_SIZE / 4; w++) {
+            uint32_t word = 0xFFFFFFFFUL;
+            for (uint8_t b = 0; b < 4; b++) {
+                size_t off = page + w * 4 + b;
+                if (off < len) {
+                    word &= ~(0xFFUL << (8 * b));
+                    word |= (uint32_t)src[off] << (8 * b);
+                }
+            }
+            dst[w] = word;
+        }
+
+        NVMCTRL->ADDR.reg = (addr + page) / 2;
+        nvm_command(NVMCTRL_CTRLA_CMD_WP);
+    }
+
+    const volatile uint8_t* check = (const volatile uint8_t*)flash_addr;
+    for (size_t i = 0; i < len; i++) {
+        if (check[i] != src[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool nvm_write(const void* flash_addr, const void* data, size_t len) {
+    return nvm_erase_rows(flash_addr, len) && nvm_write_pages(flash_addr, data, len);
+}
+
+uint16_t nvm_checksum(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint16_t sum1 = 0xFF;
+    uint16_t sum2 = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        sum1 = (sum1 + p[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (uint16_t)((sum2 << 8) | sum1);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file protection.cpp
+ * @brief INA3221 alert-driven overcurrent and undervoltage protection
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "fast_gpio.h"
+#include "protection.h"
+#include "relays.h"
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+static Adafruit_INA3221* monitor = nullptr;
+
+/** @brief Faults not yet collected by protection_poll() */
+static volatile uint8_t pending_faults = PROTECT_NONE;
+
+/** @brief Relays held released */
+static volatile bool tripped = false;
+
+/** @brief millis() of the last trip */
+static volatile uint32_t trip_ms = 0;
+
+static uint32_t last_uv_poll_ms = 0;
+
+/** @brief Consecutive readings below PROTECT_UNDERVOLT_MV */
+static uint8_t uv_count = 0;
+
+// ============================================================================
+// TRIP
+// ============================================================================
+
+/**
+ * @brief Release every relay and latch the fault
+ *
+ * Called from the alert interrupt or with interrupts disabled.
+ *
+ * @param fault ProtectFault bit
+ */
+static void protection_trip(uint8_t fault) {
+    relays_release();
+    tripped = true;
+    trip_ms = millis();
+    pending_faults |= fault;
+}
+
+/**
+ * @brief INA3221 critical alert (falling edge)
+ */
+static void critical_alert_isr(void) {
+    protection_trip(PROTECT_OVERCURRENT);
+}
+
+/**
+ * @brief INA3221 warning alert (falling edge)
+ */
+static void warning_alert_isr(void) {
+    pending_faults |= PROTECT_WARNING;
+}
+
+/** @brief INA3221 critical alert input, active low */
+static constexpr FastPin CRITICAL_ALERT(INA3221_CRITICAL_PIN);
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void protection_init(Adafruit_INA3221& ina) {
+    monitor = &ina;
+
+    // Limits on the relay load channel; the other channels keep the
+    // power-on limits (full scale), so they never alert
+    ina.setCriticalAlertThreshold(0, PROTECT_CRITICAL_MA / 1000.0f);
+    ina.setWarningAlertThreshold(0, PROTECT_WARNING_MA / 1000.0f);
+
+    pinMode(INA3221_CRITICAL_PIN, INPUT_PULLUP);
+    pinMode(INA3221_WARNING_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(INA3221_CRITICAL_PIN), critical_alert_isr, FALLING);
+    attachInterrupt(digitalPinToInterrupt(INA3221_WARNING_PIN), warning_alert_isr, FALLING);
+
+    // Already asserted at power-up (no edge to catch)
+    if (!CRITICAL_ALERT.read()) {
+        noInterrupts();
+        protection_trip(PROTECT_OVERCURRENT);
+        interrupts();
+    }
+}
+
+uint8_t protection_poll(void) {
+    uint32_t now = millis();
+
+    if (monitor && now - last_uv_poll_ms >= PROTECT_UV_POLL_MS) {
+        last_uv_poll_ms = now;
+        int bus_mv = (int)round(1000.0f * monitor->getBusVoltage(0));
+        if (bus_mv >= PROTECT_UNDERVOLT_MV) {
+            uv_count = 0;
+        } else if (uv_count < PROTECT_UV_COUNT && ++uv_count == PROTECT_UV_COUNT) {
+            noInterrupts();
+            protection_trip(PROTECT_UNDERVOLTAGE);
+            interrupts();
+        }
+    }
+
+    if (tripped && now - trip_ms >= PROTECT_HOLDOFF_MS &&
+        CRITICAL_ALERT.read() && uv_count < PROTECT_UV_COUNT) {
+        tripped = false;
+        pending_faults |= PROTECT_CLEARED;
+    }
+
+    noInterrupts();
+    uint8_t faults = pending_faults;
+    pending_faults = PROTECT_NONE;
+    interrupts();
+    return faults;
+}
+
+bool protection_tripped(void) {
+    return tripped;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file relay_verify.cpp
+ * @brief Relay actuation verification from the coil-current signature
+ *
+ * Learning: the first switch after the table is cleared records the
+ * baseline as the old pattern's current and the settled reading as the
+ * new one's. After that a switch into an unknown pattern learns it as
+ * known pattern + measured step, and a switch between two known patterns
+ * is verified against their difference.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "nvm_flash.h"
+#include "relay_verify.h"
+#include "relays.h"
+#include "schedule.h"
+
+// ============================================================================
+// STORAGE
+// ============================================================================
+
+/** @brief Store record marker ("RLY1") */
+#define RELAY_SIG_MAGIC 0x31594C52UL
+
+/** @brief Store layout version (3: every current read at full drive) */
+#define RELAY_SIG_VERSION 3
+
+/** @brief Learned current placeholder */
+#define RELAY_SIG_UNKNOWN INT16_MIN
+
+/** @brief Persistent record of the learned pattern currents */
+struct RelaySigStore {
+    uint32_t magic;                     /**< RELAY_SIG_MAGIC */
+    uint16_t version;                   /**< RELAY_SIG_VERSION */
+    uint16_t checksum;                  /**< nvm_checksum() of learned_ma */
+    int16_t learned_ma[RELAY_POSITION_COUNT]; /**< RELAY_SIG_UNKNOWN = not learned */
+};
+
+static_assert(sizeof(RelaySigStore) <= RELAY_VERIFY_FLASH_BYTES,
+              "RELAY_VERIFY_FLASH_BYTES too small");
+
+NVM_FLASH_AREA(relay_sig_flash, RELAY_VERIFY_FLASH_BYTES);
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+static Adafruit_INA3221* monitor = nullptr;
+
+/** @brief Learned load current of each table position's pattern (mA) */
+static int16_t learned_ma[RELAY_POSITION_COUNT];
+
+/** @brief Switch being verified */
+static bool active = false;
+static uint8_t switch_from = 0;
+static uint8_t switch_to = 0;
+static int32_t baseline_ma = 0;
+
+/** @brief Last switch */
+static RelayVerifyResult last_result = RELAY_VERIFY_NONE;
+static int16_t last_step_ma = 0;
+
+/** @brief learned_ma differs from flash since millis() changed_ms */
+static bool unsaved = false;
+static uint32_t changed_ms = 0;
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Read the relay load current
+ *
+ * @return Current in mA
+ */
+static int32_t relay_verify_read_ma(void) {
+    return (int32_t)round(1000.0f * monitor->getCurrentAmps(0));
+}
+
+/**
+ * @brief Average RELAY_VERIFY_SAMPLES fast conversions after settling
+ *
+ * @return Current in mA
+ */
+static int32_t relay_verify_sample_ma(void) {
+    delayMicroseconds(RELAY_VERIFY_SETTLE_US);
+    int32_t sum = 0;
+    for (uint8_t i = 0; i < RELAY_VERIFY_SAMPLES; i++) {
+        if (i) {
+            delayMicroseconds(RELAY_VERIFY_SAMPLE_US);
+        }
+        sum += relay_verify_read_ma();
+    }
+    return sum / RELAY_VERIFY_SAMPLES;
+}
+
+/**
+ * @brief Saturate a current to a storable value
+ *
+ * @param ma Current in mA
+ * @return ma limited to int16_t, never RELAY_SIG_UNKNOWN
+ */
+static int16_t clamp_ma(int32_t ma) {
+    return (int16_t)constrain(ma, (int32_t)INT16_MIN + 1, (int32_t)INT16_MAX);
+}
+
+/**
+ * @brief Back to the normal 16-sample averaging after a switch
+ */
+static void restore_averaging(void) {
+    monitor->setShuntVoltageConvTime(INA3221_CONVTIME_1MS);
+    monitor->setBusVoltageConvTime(INA3221_CONVTIME_1MS);
+    monitor->setAveragingMode(INA3221_AVG_16_SAMPLES);
+}
+
+/**
+ * @brief Leave the learned currents for relay_verify_poll() to save
+ */
+static void relay_verify_changed(void) {
+    unsaved = true;
+    changed_ms = millis();
+}
+
+/**
+ * @brief Write the learned currents to flash
+ */
+static void relay_verify_save(void) {
+    RelaySigStore store;
+    memset(&store, 0, sizeof(store));
+    store.magic = RELAY_SIG_MAGIC;
+    store.version = RELAY_SIG_VERSION;
+    memcpy(store.learned_ma, learned_ma, sizeof(learned_ma));
+    store.checksum = nvm_checksum(store.learned_ma, sizeof(store.learned_ma));
+
+    unsaved = false;
+    if (!nvm_write(relay_sig_flash, &store, sizeof(store))) {
+        Serial.println("ERROR: Failed to save relay coil signatures");
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void relay_verify_init(Adafruit_INA3221& ina) {
+    monitor = &ina;
+
+    RelaySigStore store;
+    nvm_read(relay_sig_flash, &store, sizeof(store));
+    bool store_ok = store.magic == RELAY_SIG_MAGIC && store.version == RELAY_SIG_VERSION &&
+                    store.checksum == nvm_checksum(store.learned_ma, sizeof(store.learned_ma));
+
+    for (uint8_t p = 0; p < RELAY_POSITION_COUNT; p++) {
+        learned_ma[p] = store_ok ? store.learned_ma[p] : RELAY_SIG_UNKNOWN;
+    }
+    active = false;
+    unsaved = false;
+    last_result = RELAY_VERIFY_NONE;
+}
+
+void relay_verify_begin(uint8_t from_position, uint8_t to_position) {
+    active = false;
+    if (!monitor || from_position >= RELAY_POSITION_COUNT || to_position >= RELAY_POSITION_COUNT) {
+        return;
+    }
+    // Nothing moves, or latching relays, which draw the same pulse current
+    // whatever they switch to
+    if (RELAY_DRIVE == RELAY_DRIVE_LATCH || relays_same_pattern(from_position, to_position)) {
+        last_result = RELAY_VERIFY_NONE;
+        last_step_ma = 0;
+        return;
+    }
+
+    // Single fast conversions so the settled coil current shows up within
+    // a cycle. The baseline is read with the old pattern on full voltage,
+    // like the new one during its pull-in, so the step and the learned
+    // currents are all full-drive values whatever RELAY_DRIVE holds at.
+    monitor->setAveragingMode(INA3221_AVG_1_SAMPLE);
+    monitor->setShuntVoltageConvTime(INA3221_CONVTIME_140US);
+    monitor->setBusVoltageConvTime(INA3221_CONVTIME_140US);
+    relays_full_drive();
+    baseline_ma = relay_verify_sample_ma();
+
+    switch_from = from_position;
+    switch_to = to_position;
+    active = true;
+}
+
+RelayVerifyResult relay_verify_end(void) {
+    if (!active) {
+        return last_result;
+    }
+    active = false;
+
+    int32_t after_ma = relay_verify_sample_ma();
+    restore_averaging();
+
+    int32_t step = after_ma - baseline_ma;
+    last_step_ma = clamp_ma(step);
+
+    bool known_from = learned_ma[switch_from] != RELAY_SIG_UNKNOWN;
+    bool known_to = learned_ma[switch_to] != RELAY_SIG_UNKNOWN;
+
+    if (known_from && known_to) {
+        int32_t expected = (int32_t)learned_ma[switch_to] - learned_ma[switch_from];
+        int32_t tolerance = max((int32_t)RELAY_VERIFY_TOL_MA,
+                                abs(expected) * RELAY_VERIFY_TOL_PCT / 100);
+        last_result = (abs(step - expected) <= tolerance) ? RELAY_VERIFY_OK
+                                                          : RELAY_VERIFY_FAILED;
+        DEBUG_PRINTF("Relay step %ld mA, expected %ld +/- %ld\n",
+                     (long)step, (long)expected, (long)tolerance);
+        return last_result;
+    }
+
+    if (!known_from && !known_to) {
+        learned_ma[switch_from] = clamp_ma(baseline_ma);
+        learned_ma[switch_to] = clamp_ma(after_ma);
+    } else if (!known_to) {
+        learned_ma[switch_to] = clamp_ma(learned_ma[switch_from] + step);
+    } else {
+        learned_ma[switch_from] = clamp_ma(learned_ma[switch_to] - step);
+    }
+    relay_verify_changed();
+    last_result = RELAY_VERIFY_LEARNED;
+    return last_result;
+}
+
+void relay_verify_cancel(void) {
+    if (active) {
+        active = false;
+        restore_averaging();
+    }
+}
+
+RelayVerifyResult relay_verify_last(int16_t& step_ma) {
+    step_ma = last_step_ma;
+    return last_result;
+}
+
+void relay_verify_forget(void) {
+    for (uint8_t p = 0; p < RELAY_POSITION_COUNT; p++) {
+        learned_ma[p] = RELAY_SIG_UNKNOWN;
+    }
+    relay_verify_changed();
+    last_result = RELAY_VERIFY_NONE;
+    last_step_ma = 0;
+}
+
+void relay_verify_poll(void) {
+    if (unsaved && millis() - changed_ms >= RELAY_VERIFY_SAVE_QUIET_MS &&
+        !schedule_due_within(SCHEDULE_FLASH_GUARD_MS)) {
+        relay_verify_save();
+    }
+}
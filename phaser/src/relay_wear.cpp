@@ -0,0 +1,133 @@
+/**
+ * @file relay_wear.cpp
+ * @brief Per-relay operation counters kept in wear-levelled flash
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "nvm_eeprom.h"
+#include "relay_wear.h"
+#include "schedule.h"
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+/** @brief Counters as stored */
+struct RelayWearRecord {
+    uint32_t changes;              /**< Direction changes that moved a relay */
+    uint32_t ops[RELAY_COUNT];     /**< Transitions per relay */
+};
+
+static_assert(sizeof(RelayWearRecord) <= NVM_EEPROM_MAX_RECORD,
+              "Too many relays for one emulated EEPROM record");
+
+NVM_FLASH_AREA(relay_wear_flash, RELAY_WEAR_FLASH_BYTES);
+
+static NvmEeprom store;
+
+static RelayWearRecord counts;
+
+/** @brief Pattern the relay contacts are in */
+static uint8_t held[RELAY_PATTERN_BYTES];
+
+/** @brief Operations counted since the last flush */
+static uint16_t unsaved_ops = 0;
+
+/** @brief millis() of the oldest unsaved operation */
+static uint32_t first_unsaved_ms = 0;
+
+/** @brief millis() of the last counted change */
+static uint32_t last_change_ms = 0;
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Write the counters to flash now
+ */
+static void relay_wear_flush(void) {
+    schedule_wait_clear(SCHEDULE_FLASH_GUARD_MS);
+    if (!nvm_eeprom_write(store, &counts)) {
+        Serial.println("ERROR: Failed to save relay operation counters");
+        return;
+    }
+    unsaved_ops = 0;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void relay_wear_init(const uint8_t pattern[RELAY_PATTERN_BYTES]) {
+    memset(&counts, 0, sizeof(counts));
+    if (nvm_eeprom_init(store, relay_wear_flash, sizeof(relay_wear_flash), sizeof(counts))) {
+        nvm_eeprom_read(store, &counts);
+    }
+    memcpy(held, pattern, RELAY_PATTERN_BYTES);
+    unsaved_ops = 0;
+}
+
+void relay_wear_count(const uint8_t pattern[RELAY_PATTERN_BYTES]) {
+    uint16_t ops = 0;
+    for (uint8_t k = 0; k < RELAY_PATTERN_BYTES; k++) {
+        uint8_t toggled = held[k] ^ pattern[k];
+        held[k] = pattern[k];
+        while (toggled) {
+            uint8_t relay = k * 8 + __builtin_ctz(toggled);
+            toggled &= toggled - 1;
+            if (relay < RELAY_COUNT) {
+                counts.ops[relay]++;
+                ops++;
+            }
+        }
+    }
+    if (ops == 0) {
+        return;
+    }
+
+    counts.changes++;
+    last_change_ms = millis();
+    if (unsaved_ops == 0) {
+        first_unsaved_ms = last_change_ms;
+    }
+    unsaved_ops = (uint16_t)min((uint32_t)unsaved_ops + ops, (uint32_t)UINT16_MAX);
+}
+
+void relay_wear_release(void) {
+    static const uint8_t RELEASED[RELAY_PATTERN_BYTES] = {};
+    relay_wear_count(RELEASED);
+}
+
+void relay_wear_poll(void) {
+    if (unsaved_ops == 0) {
+        return;
+    }
+    uint32_t now = millis();
+    bool due = unsaved_ops >= RELAY_WEAR_FLUSH_OPS || now - first_unsaved_ms >= RELAY_WEAR_FLUSH_MS;
+    if (due && now - last_change_ms >= RELAY_WEAR_QUIET_MS &&
+        !schedule_due_within(SCHEDULE_FLASH_GUARD_MS)) {
+        relay_wear_flush();
+    }
+}
+
+uint32_t relay_wear_ops(uint8_t relay) {
+    return (relay < RELAY_COUNT) ? counts.ops[relay] : 0;
+}
+
+uint32_t relay_wear_changes(void) {
+    return counts.changes;
+}
+
+void relay_wear_clear(uint8_t relay) {
+    if (relay >= RELAY_COUNT) {
+        return;
+    }
+    counts.ops[relay] = 0;
+    relay_wear_flush();
+}
@@ -0,0 +1,589 @@
+/**
+ * @file relays.cpp
+ * @brief Relay output backends: GPIO pins or DMA-loaded shift registers
+ *
+ * Shift-register timing: the DMAC moves one byte per SERCOM data-empty
+ * trigger, so the chain is clocked back to back at RELAY_SR_SPI_HZ
+ * (3 bytes = 6 us at 4 MHz). The transfer-complete interrupt arrives
+ * while the last byte is still shifting out, so it waits for the SERCOM
+ * transmit-complete flag (at most one byte time) before the latch pulse.
+ *
+ * Coil drive: every change starts TCC1 as a one-shot timer, and its
+ * overflow interrupt ends the pull-in or latch pulse without any help
+ * from loop(). In PWM mode the hold is TCC0 running free at
+ * RELAY_HOLD_PWM_HZ with the same duty on every compare channel. A
+ * coil is put on hold by muxing its pin to TCC0, and taken off by
+ * muxing it back to the port.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "wiring_private.h"
+
+#include "config.h"
+#include "relays.h"
+#include "protection.h"
+#include "fast_gpio.h"
+
+#if RELAY_BACKEND == RELAY_BACKEND_SPI
+#include "dma.h"
+#endif
+
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+#include "nvm_eeprom.h"
+#include "schedule.h"
+#endif
+
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH && RELAY_BACKEND != RELAY_BACKEND_SPI
+    #error "RELAY_DRIVE_LATCH needs two outputs per relay: use RELAY_BACKEND_SPI"
+#endif
+
+// ============================================================================
+// COIL DRIVE PROTOTYPES
+// ============================================================================
+
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+
+/** @brief TCC1 clock (GCLK0 / 1024, 46.875 kHz) */
+#define COIL_TIMER_HZ (F_CPU / 1024)
+
+/**
+ * @brief Drop the energised coils from pull-in/pulse to their rest state
+ *
+ * Backend specific; called from the TCC1 interrupt.
+ */
+static void coils_hold(void);
+
+static void coil_timer_init(void);
+static void coil_timer_start(uint16_t ms);
+static void coil_timer_stop(void);
+
+#endif
+
+/**
+ * @brief Return a pin from a peripheral to its port output
+ *
+ * pinMode() leaves the peripheral mux enabled, so clear it directly.
+ *
+ * @param pin Arduino pin
+ */
+static inline void pin_to_port(uint8_t pin) {
+    PORT->Group[g_APinDescription[pin].ulPort].PINCFG[g_APinDescription[pin].ulPin].bit.PMUXEN = 0;
+}
+
+// ============================================================================
+// RELAY MAP PROFILES
+// ============================================================================
+
+/** @brief Active profile, read by the schedule timer interrupt */
+static volatile uint8_t active_profile = 0;
+
+bool relays_set_profile(uint8_t profile) {
+    if (profile >= RELAY_PROFILE_COUNT) {
+        return false;
+    }
+    active_profile = profile;
+    return true;
+}
+
+uint8_t relays_profile(void) {
+    return active_profile;
+}
+
+uint8_t relays_position(uint8_t direction) {
+    return active_profile * NUM_DIRECTIONS + direction;
+}
+
+const uint8_t* relays_pattern(uint8_t position) {
+    return RELAY_POSITIONS[position / NUM_DIRECTIONS][position % NUM_DIRECTIONS];
+}
+
+bool relays_same_pattern(uint8_t a, uint8_t b) {
+    return memcmp(relays_pattern(a), relays_pattern(b), RELAY_PATTERN_BYTES) == 0;
+}
+
+#if RELAY_BACKEND == RELAY_BACKEND_GPIO
+
+// ============================================================================
+// GPIO BACKEND
+// ============================================================================
+
+/** @brief Output pin of each relay, in table bit order */
+static const uint8_t RELAY_PINS[] = {
+    RELAY_1, RELAY_2, RELAY_3, RELAY_4, RELAY_56, RELAY_78
+};
+
+/** @brief The same pins as port registers, for the writes */
+static constexpr FastPin RELAY_FAST[] = {
+    FastPin(RELAY_1), FastPin(RELAY_2), FastPin(RELAY_3),
+    FastPin(RELAY_4), FastPin(RELAY_56), FastPin(RELAY_78)
+};
+
+/** @brief Pins with a TCC0 output on peripheral function F (PB08 has none) */
+static const bool RELAY_PIN_HAS_TCC[] = {
+    true, true, true, true, true, false
+};
+
+static_assert(RELAY_COUNT <= sizeof(RELAY_PINS),
+              "GPIO backend drives six relays; use RELAY_BACKEND_SPI for more");
+
+/** @brief TCC0 compare value: output high (coil on) for the hold duty */
+#define RELAY_HOLD_HIGH_PCT RELAY_HOLD_DUTY_PCT
+
+/** @brief Pattern being driven */
+static uint8_t applied[RELAY_PATTERN_BYTES];
+
+void relays_init(void) {
+    memset(applied, 0, sizeof(applied));
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        digitalWrite(RELAY_PINS[i], LOW);
+        pinMode(RELAY_PINS[i], OUTPUT);
+    }
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+    coil_timer_init();
+#endif
+}
+
+bool relays_write(const uint8_t pattern[RELAY_PATTERN_BYTES]) {
+    // Atomic against a protection trip releasing the relays
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (protection_tripped()) {
+        __set_PRIMASK(primask);
+        return false;
+    }
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+    coil_timer_stop();
+#endif
+    memcpy(applied, pattern, sizeof(applied));
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        RELAY_FAST[i].write((pattern[i / 8] >> (i % 8)) & 1);
+        pin_to_port(RELAY_PINS[i]);
+    }
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+    coil_timer_start(RELAY_PULLIN_MS);
+#endif
+    __set_PRIMASK(primask);
+    return true;
+}
+
+void relays_release(void) {
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+    coil_timer_stop();
+#endif
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        RELAY_FAST[i].low();
+        pin_to_port(RELAY_PINS[i]);
+    }
+}
+
+void relays_full_drive(void) {
+#if RELAY_DRIVE == RELAY_DRIVE_PWM
+    // The port outputs still hold the pattern (low after a release)
+    coil_timer_stop();
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        pin_to_port(RELAY_PINS[i]);
+    }
+#endif
+}
+
+#if RELAY_DRIVE == RELAY_DRIVE_PWM
+static void coils_hold(void) {
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        if (RELAY_PIN_HAS_TCC[i] && ((applied[i / 8] >> (i % 8)) & 1)) {
+            pinPeripheral(RELAY_PINS[i], PIO_TIMER_ALT);
+        }
+    }
+}
+#endif
+
+uint8_t relays_startup_position(void) {
+    return DIR_N;
+}
+
+void relays_poll(void) {
+}
+
+#elif RELAY_BACKEND == RELAY_BACKEND_SPI
+
+// ============================================================================
+// SHIFT-REGISTER BACKEND
+// ============================================================================
+
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+/** @brief Outputs used: a set and a reset coil per relay */
+#define RELAY_SR_OUTPUTS (2 * RELAY_COUNT)
+#else
+#define RELAY_SR_OUTPUTS RELAY_COUNT
+#endif
+
+static_assert(RELAY_SR_OUTPUTS <= 8 * RELAY_SR_CHAIN_BYTES,
+              "Relay outputs need more shift registers than RELAY_SR_CHAIN_BYTES");
+
+/** @brief TCC0 compare value: /OE high (coils off) outside the hold duty */
+#define RELAY_HOLD_HIGH_PCT (100 - RELAY_HOLD_DUTY_PCT)
+
+/** @brief SERCOM1 as SPI master: MOSI on pad 2, SCK on pad 3 */
+static SPIClass relay_spi(&sercom1, RELAY_SR_MISO_PIN, RELAY_SR_SCK_PIN, RELAY_SR_MOSI_PIN,
+                          SPI_PAD_2_SCK_3, SERCOM_RX_PAD_0);
+
+/**
+ * @brief Bytes in shift order: the register furthest from the MCU first
+ */
+static uint8_t tx_buffer[RELAY_SR_CHAIN_BYTES];
+
+/** @brief Latch (RCLK) and output enable (/OE, /G) lines */
+static constexpr FastPin SR_LATCH(RELAY_SR_LATCH_PIN);
+static constexpr FastPin SR_OE(RELAY_SR_OE_PIN);
+
+/** @brief Transfer in progress */
+static volatile bool busy = false;
+
+/**
+ * @brief Chain bytes of a write that found a transfer in progress
+ *
+ * Shifted in by the DMA-complete interrupt in place of latching the
+ * transfer it follows. Nothing waits for busy to clear: the DMAC
+ * interrupt cannot run inside the schedule timer interrupt or with
+ * interrupts masked.
+ */
+static uint8_t pending_buffer[RELAY_SR_CHAIN_BYTES];
+static volatile bool pending = false;
+
+/** @brief Outputs held disabled by relays_release() */
+static volatile bool released = true;
+
+/**
+ * @brief Drive /OE from the port (PWM hold off)
+ *
+ * @param level HIGH = outputs off
+ */
+static void oe_write(uint8_t level) {
+    SR_OE.write(level);
+    pin_to_port(RELAY_SR_OE_PIN);
+}
+
+/**
+ * @brief Clock tx_buffer through the chain
+ */
+static void transfer_start(void) {
+    busy = true;
+    SERCOM1->SPI.INTFLAG.reg = SERCOM_SPI_INTFLAG_TXC;
+    dma_channel_enable(DMA_CH_RELAYS);
+}
+
+/**
+ * @brief DMA transfer complete: latch the chain and enable the outputs
+ *
+ * A write that arrived meanwhile is shifted in over this one first, so
+ * only the newest pattern is latched.
+ *
+ * @param channel DMA channel (DMA_CH_RELAYS)
+ * @param flags Interrupt flags
+ */
+static void relays_dma_complete(uint8_t channel, uint8_t flags) {
+    (void)channel;
+    if (pending) {
+        memcpy(tx_buffer, pending_buffer, sizeof(tx_buffer));
+        pending = false;
+        transfer_start();
+        return;
+    }
+    if (!(flags & DMAC_CHINTFLAG_TERR)) {
+        while (!SERCOM1->SPI.INTFLAG.bit.TXC);
+        SR_LATCH.high();
+        SR_LATCH.low();
+        if (!released) {
+            oe_write(LOW);
+#if RELAY_DRIVE == RELAY_DRIVE_PWM
+            coil_timer_start(RELAY_PULLIN_MS);
+#elif RELAY_DRIVE == RELAY_DRIVE_LATCH
+            coil_timer_start(RELAY_LATCH_PULSE_MS);
+#endif
+        }
+    }
+    busy = false;
+}
+
+#if RELAY_DRIVE == RELAY_DRIVE_PWM
+static void coils_hold(void) {
+    pinPeripheral(RELAY_SR_OE_PIN, PIO_TIMER_ALT);  // PA15 = TCC0/WO[5]
+}
+#elif RELAY_DRIVE == RELAY_DRIVE_LATCH
+static void coils_hold(void) {
+    oe_write(HIGH);  // End of pulse; the relays stay latched
+}
+#endif
+
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+
+// ----------------------------------------------------------------------------
+// Latched pattern store
+// ----------------------------------------------------------------------------
+
+static_assert(RELAY_PATTERN_BYTES <= NVM_EEPROM_MAX_RECORD,
+              "Relay pattern too long for one emulated EEPROM record");
+
+NVM_FLASH_AREA(relay_state_flash, RELAY_STATE_FLASH_BYTES);
+
+/** @brief Wear-levelled copies of the latched pattern */
+static NvmEeprom state_store;
+
+/** @brief Pattern pulsed last, saved by relays_poll() */
+static uint8_t latched[RELAY_PATTERN_BYTES];
+static volatile bool latched_unsaved = false;
+
+/** @brief millis() of the last pattern pulsed */
+static volatile uint32_t latched_ms = 0;
+
+/**
+ * @brief Read the latched pattern from flash
+ *
+ * @param pattern Output
+ * @return false if nothing valid is stored
+ */
+static bool relay_state_load(uint8_t pattern[RELAY_PATTERN_BYTES]) {
+    return nvm_eeprom_read(state_store, pattern);
+}
+
+/**
+ * @brief Record the latched pattern in flash if it changed
+ *
+ * @param pattern Pattern just pulsed
+ */
+static void relay_state_save(const uint8_t pattern[RELAY_PATTERN_BYTES]) {
+    uint8_t stored[RELAY_PATTERN_BYTES];
+    if (relay_state_load(stored) && memcmp(stored, pattern, RELAY_PATTERN_BYTES) == 0) {
+        return;
+    }
+    if (!nvm_eeprom_write(state_store, pattern)) {
+        Serial.println("ERROR: Failed to save latched relay state");
+    }
+}
+
+uint8_t relays_startup_position(void) {
+    uint8_t stored[RELAY_PATTERN_BYTES];
+    if (relay_state_load(stored)) {
+        for (uint8_t p = 0; p < RELAY_POSITION_COUNT; p++) {
+            if (memcmp(relays_pattern(p), stored, RELAY_PATTERN_BYTES) == 0) {
+                return p;
+            }
+        }
+    }
+    return DIR_N;
+}
+
+#else
+
+uint8_t relays_startup_position(void) {
+    return DIR_N;
+}
+
+#endif
+
+void relays_init(void) {
+    // Outputs off until a pattern has been latched
+    digitalWrite(RELAY_SR_OE_PIN, HIGH);
+    pinMode(RELAY_SR_OE_PIN, OUTPUT);
+    digitalWrite(RELAY_SR_LATCH_PIN, LOW);
+    pinMode(RELAY_SR_LATCH_PIN, OUTPUT);
+    released = true;
+
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+    nvm_eeprom_init(state_store, relay_state_flash, sizeof(relay_state_flash), RELAY_PATTERN_BYTES);
+#endif
+
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+    coil_timer_init();
+#endif
+
+    relay_spi.begin();
+    relay_spi.beginTransaction(SPISettings(RELAY_SR_SPI_HZ, MSBFIRST, SPI_MODE0));
+
+    // One byte per data-register-empty trigger, buffer to DATA
+    dma_init();
+    dma_channel_setup(DMA_CH_RELAYS, SERCOM1_DMAC_ID_TX, DMAC_CHCTRLB_TRIGACT_BEAT,
+                      relays_dma_complete);
+    DmacDescriptor* d = dma_descriptor(DMA_CH_RELAYS);
+    d->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BLOCKACT_INT |
+                    DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_SRCINC;
+    d->BTCNT.reg = RELAY_SR_CHAIN_BYTES;
+    d->SRCADDR.reg = (uintptr_t)&tx_buffer[RELAY_SR_CHAIN_BYTES];  // End address
+    d->DSTADDR.reg = (uintptr_t)&SERCOM1->SPI.DATA.reg;
+    d->DESCADDR.reg = 0;
+
+    // Clear whatever the registers powered up with
+    memset(tx_buffer, 0, sizeof(tx_buffer));
+    pending = false;
+    transfer_start();
+}
+
+bool relays_write(const uint8_t pattern[RELAY_PATTERN_BYTES]) {
+    // Output n of the chain is bit n % 8 of register n / 8
+    uint8_t outputs[RELAY_SR_CHAIN_BYTES];
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+    // Pulse the set coil of every relay that is on, the reset coil of
+    // every relay that is off
+    memset(outputs, 0, sizeof(outputs));
+    for (uint8_t n = 0; n < RELAY_COUNT; n++) {
+        uint8_t out = ((pattern[n / 8] >> (n % 8)) & 1) ? n : RELAY_COUNT + n;
+        outputs[out / 8] |= 1 << (out % 8);
+    }
+#else
+    for (uint8_t k = 0; k < RELAY_SR_CHAIN_BYTES; k++) {
+        outputs[k] = (k < RELAY_PATTERN_BYTES) ? pattern[k] : 0;
+    }
+#endif
+
+    // Against the schedule timer, the DMA-complete interrupt and a
+    // protection trip; may already be called with interrupts masked
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (protection_tripped()) {
+        __set_PRIMASK(primask);
+        return false;
+    }
+    uint8_t* chain = busy ? pending_buffer : tx_buffer;
+    for (uint8_t k = 0; k < RELAY_SR_CHAIN_BYTES; k++) {
+        chain[RELAY_SR_CHAIN_BYTES - 1 - k] = outputs[k];
+    }
+    released = false;
+    if (busy) {
+        pending = true;
+    } else {
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+        coil_timer_stop();
+#endif
+        transfer_start();
+    }
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+    memcpy(latched, pattern, RELAY_PATTERN_BYTES);
+    latched_unsaved = true;
+    latched_ms = millis();
+#endif
+    __set_PRIMASK(primask);
+    return true;
+}
+
+void relays_poll(void) {
+#if RELAY_DRIVE == RELAY_DRIVE_LATCH
+    // Once the relays have stayed put, so a sweep costs one copy, and not
+    // with a scheduled change about to need the flash-stalled CPU
+    if (!latched_unsaved || millis() - latched_ms < RELAY_STATE_QUIET_MS ||
+        schedule_due_within(SCHEDULE_FLASH_GUARD_MS)) {
+        return;
+    }
+    uint8_t pattern[RELAY_PATTERN_BYTES];
+    noInterrupts();
+    memcpy(pattern, latched, RELAY_PATTERN_BYTES);
+    latched_unsaved = false;
+    interrupts();
+    relay_state_save(pattern);
+#endif
+}
+
+void relays_release(void) {
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+    coil_timer_stop();
+#endif
+    oe_write(HIGH);
+    released = true;
+}
+
+void relays_full_drive(void) {
+#if RELAY_DRIVE == RELAY_DRIVE_PWM
+    // Against a protection trip raising /OE
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!released && !busy) {
+        coil_timer_stop();
+        oe_write(LOW);
+    }
+    __set_PRIMASK(primask);
+#endif
+}
+
+#else
+    #error "Invalid RELAY_BACKEND. Use RELAY_BACKEND_GPIO or RELAY_BACKEND_SPI"
+#endif
+
+#if RELAY_DRIVE != RELAY_DRIVE_FULL
+
+// ============================================================================
+// COIL DRIVE TIMERS
+// ============================================================================
+
+/**
+ * @brief Set up TCC1 as a one-shot timer and, for PWM hold, TCC0
+ */
+static void coil_timer_init(void) {
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_TCC0_TCC1 | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+    while (GCLK->STATUS.bit.SYNCBUSY);
+
+#if RELAY_DRIVE == RELAY_DRIVE_PWM
+    // TCC0: free-running PWM, same duty on every channel
+    const uint32_t period = F_CPU / RELAY_HOLD_PWM_HZ;
+    TCC0->CTRLA.reg = TCC_CTRLA_SWRST;
+    while (TCC0->SYNCBUSY.bit.SWRST);
+    TCC0->WAVE.reg = TCC_WAVE_WAVEGEN_NPWM;
+    while (TCC0->SYNCBUSY.bit.WAVE);
+    TCC0->PER.reg = period - 1;
+    while (TCC0->SYNCBUSY.bit.PER);
+    for (uint8_t c = 0; c < 4; c++) {
+        TCC0->CC[c].reg = period * RELAY_HOLD_HIGH_PCT / 100;
+    }
+    while (TCC0->SYNCBUSY.reg);
+    TCC0->CTRLA.reg = TCC_CTRLA_PRESCALER_DIV1 | TCC_CTRLA_ENABLE;
+    while (TCC0->SYNCBUSY.bit.ENABLE);
+#endif
+
+    // TCC1: one-shot, interrupt at the end of the pull-in or pulse
+    TCC1->CTRLA.reg = TCC_CTRLA_SWRST;
+    while (TCC1->SYNCBUSY.bit.SWRST);
+    TCC1->WAVE.reg = TCC_WAVE_WAVEGEN_NFRQ;
+    while (TCC1->SYNCBUSY.bit.WAVE);
+    TCC1->CTRLBSET.reg = TCC_CTRLBSET_ONESHOT;
+    while (TCC1->SYNCBUSY.bit.CTRLB);
+    TCC1->CTRLA.reg = TCC_CTRLA_PRESCALER_DIV1024 | TCC_CTRLA_ENABLE;
+    while (TCC1->SYNCBUSY.bit.ENABLE);
+    coil_timer_stop();  // A one-shot starts on enable
+    NVIC_EnableIRQ(TCC1_IRQn);
+}
+
+/**
+ * @brief (Re)start the one-shot timer
+ *
+ * @param ms Time until coils_hold()
+ */
+static void coil_timer_start(uint16_t ms) {
+    TCC1->PER.reg = (uint32_t)ms * COIL_TIMER_HZ / 1000;
+    while (TCC1->SYNCBUSY.bit.PER);
+    TCC1->INTFLAG.reg = TCC_INTFLAG_OVF;
+    TCC1->INTENSET.reg = TCC_INTENSET_OVF;
+    TCC1->CTRLBSET.reg = TCC_CTRLBSET_CMD_RETRIGGER;
+    while (TCC1->SYNCBUSY.bit.CTRLB);
+}
+
+/**
+ * @brief Cancel a pull-in or pulse in progress
+ */
+static void coil_timer_stop(void) {
+    TCC1->INTENCLR.reg = TCC_INTENCLR_OVF;
+    TCC1->CTRLBSET.reg = TCC_CTRLBSET_CMD_STOP;
+    while (TCC1->SYNCBUSY.bit.CTRLB);
+    TCC1->INTFLAG.reg = TCC_INTFLAG_OVF;
+}
+
+/**
+ * @brief One-shot expired: pull-in or latch pulse over
+ */
+void TCC1_Handler(void) {
+    TCC1->INTENCLR.reg = TCC_INTENCLR_OVF;
+    TCC1->INTFLAG.reg = TCC_INTFLAG_OVF;
+    coils_hold();
+}
+
+#endif
@@ -0,0 +1,339 @@
+/**
+ * @file rf_power.cpp
+ * @brief Continuous forward/reverse power sampler with peak-hold, envelope and RMS
+ *
+ * The ADC free-runs at 1.5 MHz (GCLK0 / 32) in input-scan mode, so it
+ * alternates reverse and forward power without CPU help, and accumulates
+ * 2^RF_ADC_AVG_LOG2 conversions of each input per result in hardware.
+ * DMA copies each result into one half of a ping-pong buffer; when a half
+ * fills, the block-complete interrupt folds its reverse/forward pairs into
+ * the statistics while the other half is being written. The CPU cost is
+ * one interrupt per RF_DMA_BLOCK_RESULTS results instead of one or two per
+ * conversion.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include "wiring_private.h"
+
+#include "config.h"
+#include "dma.h"
+#include "rf_power.h"
+
+// ============================================================================
+// STATISTICS STATE
+// ============================================================================
+
+/** @brief One time slice of samples */
+struct RfBucket {
+    uint32_t sum;          /**< Sum of samples */
+    uint64_t sum_sq;       /**< Sum of squared samples */
+    uint16_t max;          /**< Largest sample */
+    uint16_t count;        /**< Samples in bucket */
+};
+
+/** @brief Statistics of one channel */
+struct RfChannelState {
+    RfBucket buckets[RF_NUM_BUCKETS];   /**< Ring; buckets[current] is being filled */
+    uint8_t current;                    /**< Bucket being filled */
+    uint32_t envelope_q16;              /**< Envelope, Q16 over the sample scale */
+    uint32_t total_samples;             /**< Samples taken since start */
+};
+
+static RfChannelState channels[RF_NUM_CHANNELS];
+
+/** @brief millis() at which the current buckets were started */
+static uint32_t bucket_start_ms = 0;
+
+// ============================================================================
+// ADC/DMA STATE
+// ============================================================================
+
+/**
+ * @brief Left shift from an ADC result to Q6 10-bit counts
+ *
+ * A sum of up to 16 12-bit conversions fits the 16-bit result; above 16
+ * the ADC shifts the sum down to 16 bits itself.
+ */
+#define RF_ADC_RESULT_SHIFT (RF_ADC_AVG_LOG2 < 4 ? 4 - RF_ADC_AVG_LOG2 : 0)
+
+static_assert(RF_ADC_AVG_LOG2 >= 0 && RF_ADC_AVG_LOG2 <= 10, "RF_ADC_AVG_LOG2 out of range");
+static_assert(RF_DMA_BLOCK_RESULTS % 2 == 0, "RF_DMA_BLOCK_RESULTS must hold whole pairs");
+
+/** @brief Ping-pong result buffer; even entries reverse, odd forward */
+static uint16_t adc_buffer[2][RF_DMA_BLOCK_RESULTS];
+
+/** @brief Descriptor for the second half (the first is the base descriptor) */
+__attribute__((__aligned__(16)))
+static DmacDescriptor second_descriptor;
+
+/** @brief Buffer half the DMA completes next */
+static uint8_t dma_half = 0;
+
+/** @brief ADC input (MUXPOS) of the reverse channel; forward is the next one */
+static uint8_t rev_mux = 0;
+
+// ============================================================================
+// RF SENSE STATE
+// ============================================================================
+
+/** @brief Window monitor armed by rf_power_sense_arm() */
+static bool sense_armed = false;
+
+/** @brief A result has exceeded the sense threshold since arming */
+static volatile bool sense_seen = false;
+
+/** @brief millis() of the last window monitor interrupt */
+static volatile uint32_t sense_ms = 0;
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+/**
+ * @brief Integer square root (floor)
+ *
+ * @param v Input
+ * @return floor(sqrt(v))
+ */
+static uint32_t isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * @brief Start a new bucket in every channel
+ */
+static void rf_power_next_bucket(void) {
+    for (uint8_t c = 0; c < RF_NUM_CHANNELS; c++) {
+        RfChannelState& s = channels[c];
+        s.current = (s.current + 1) % RF_NUM_BUCKETS;
+        RfBucket& next = s.buckets[s.current];
+        next.sum = 0;
+        next.sum_sq = 0;
+        next.max = 0;
+        next.count = 0;
+    }
+}
+
+/**
+ * @brief Fill in a DMA descriptor moving ADC results into one buffer half
+ *
+ * @param d Descriptor
+ * @param half Buffer half
+ * @param next Descriptor to continue with
+ */
+static void rf_power_fill_descriptor(DmacDescriptor* d, uint8_t half, DmacDescriptor* next) {
+    d->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BLOCKACT_INT |
+                    DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_DSTINC;
+    d->BTCNT.reg = RF_DMA_BLOCK_RESULTS;
+    d->SRCADDR.reg = (uintptr_t)&ADC->RESULT.reg;
+    d->DSTADDR.reg = (uintptr_t)&adc_buffer[half][RF_DMA_BLOCK_RESULTS];  // End address
+    d->DESCADDR.reg = (uintptr_t)next;
+}
+
+// ============================================================================
+// SAMPLING
+// ============================================================================
+
+void rf_power_add_sample(RfChannel channel, uint16_t value) {
+    RfChannelState& s = channels[channel];
+    RfBucket& b = s.buckets[s.current];
+    b.sum += value;
+    b.sum_sq += (uint32_t)value * value;
+    if (value > b.max) {
+        b.max = value;
+    }
+    b.count++;
+
+    // Fast attack, exponential release
+    uint32_t v_q16 = (uint32_t)value << 16;
+    if (v_q16 > s.envelope_q16) {
+        s.envelope_q16 = v_q16;
+    } else {
+        s.envelope_q16 -= s.envelope_q16 >> RF_ENV_DECAY_SHIFT;
+    }
+
+    s.total_samples++;
+}
+
+/**
+ * @brief Start scanning from the reverse input into the first buffer half
+ *
+ * Restarting both the ADC scan and the DMA keeps even results on the
+ * reverse channel.
+ */
+static void rf_power_start(void) {
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    dma_channel_disable(DMA_CH_ADC);
+
+    // Writing INPUTCTRL resets the scan offset to the reverse input
+    ADC->INPUTCTRL.reg = ADC_INPUTCTRL_GAIN_DIV2 | ADC_INPUTCTRL_MUXNEG_GND |
+                         ADC_INPUTCTRL_MUXPOS(rev_mux) |
+                         ADC_INPUTCTRL_INPUTSCAN(RF_NUM_CHANNELS - 1) |
+                         ADC_INPUTCTRL_INPUTOFFSET(0);
+    while (ADC->STATUS.bit.SYNCBUSY);
+
+    DmacDescriptor* first = dma_descriptor(DMA_CH_ADC);
+    rf_power_fill_descriptor(first, 0, &second_descriptor);
+    rf_power_fill_descriptor(&second_descriptor, 1, first);
+    dma_half = 0;
+    dma_channel_enable(DMA_CH_ADC);
+
+    ADC->CTRLA.bit.ENABLE = 1;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->SWTRIG.bit.START = 1;  // Free-running from here on
+}
+
+/**
+ * @brief DMA block complete: fold a buffer half into the statistics
+ *
+ * @param channel DMA channel (DMA_CH_ADC)
+ * @param flags Interrupt flags
+ */
+static void rf_power_dma_complete(uint8_t channel, uint8_t flags) {
+    (void)channel;
+    if (flags & DMAC_CHINTFLAG_TERR) {
+        rf_power_start();
+        return;
+    }
+
+    const uint16_t* block = adc_buffer[dma_half];
+    dma_half ^= 1;
+    for (uint8_t i = 0; i < RF_DMA_BLOCK_RESULTS; i += 2) {
+        rf_power_add_sample(RF_CH_REV, block[i] << RF_ADC_RESULT_SHIFT);
+        rf_power_add_sample(RF_CH_FWD, block[i + 1] << RF_ADC_RESULT_SHIFT);
+    }
+
+    uint32_t now = millis();
+    if (now - bucket_start_ms >= RF_BUCKET_MS) {
+        bucket_start_ms = now;
+        rf_power_next_bucket();
+    }
+
+    // Re-arm the window interrupt; a flag raised during this block fires
+    // it straight away
+    if (sense_armed) {
+        ADC->INTENSET.reg = ADC_INTENSET_WINMON;
+    }
+}
+
+/**
+ * @brief ADC window monitor: a result exceeded the sense threshold
+ *
+ * Disables itself until the next DMA block so a carrier does not raise
+ * an interrupt per conversion.
+ */
+void ADC_Handler(void) {
+    ADC->INTENCLR.reg = ADC_INTENCLR_WINMON;
+    ADC->INTFLAG.reg = ADC_INTFLAG_WINMON;
+    sense_ms = millis();
+    sense_seen = true;
+}
+
+bool rf_power_init(void) {
+    memset(channels, 0, sizeof(channels));
+    bucket_start_ms = millis();
+
+    rev_mux = g_APinDescription[REV_POWER_PIN].ulADCChannelNumber;
+    if (g_APinDescription[FWD_POWER_PIN].ulADCChannelNumber != (uint32_t)rev_mux + 1) {
+        return false;  // The scan needs consecutive inputs
+    }
+
+    // ADC: single-ended, full scale = VDDANA (same as analogRead() with
+    // AR_DEFAULT), GCLK0 / 32, free-running, 16-bit accumulated result
+    pinPeripheral(REV_POWER_PIN, PIO_ANALOG);
+    pinPeripheral(FWD_POWER_PIN, PIO_ANALOG);
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->REFCTRL.reg = ADC_REFCTRL_REFSEL_INTVCC1;
+    ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM(RF_ADC_AVG_LOG2) | ADC_AVGCTRL_ADJRES(0);
+    ADC->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(RF_ADC_SAMPLEN);
+    ADC->CTRLB.reg = ADC_CTRLB_PRESCALER_DIV32 | ADC_CTRLB_RESSEL_16BIT | ADC_CTRLB_FREERUN;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->INTENCLR.reg = ADC_INTENCLR_RESRDY | ADC_INTENCLR_OVERRUN | ADC_INTENCLR_WINMON;
+
+    // DMA: one half-word per result, interrupt per buffer half
+    dma_init();
+    dma_channel_setup(DMA_CH_ADC, ADC_DMAC_ID_RESRDY, DMAC_CHCTRLB_TRIGACT_BEAT,
+                      rf_power_dma_complete);
+
+    rf_power_start();
+    return true;
+}
+
+void rf_power_sense_arm(uint16_t threshold_q6) {
+    // The monitor compares raw results, before the shift to Q6
+    ADC->INTENCLR.reg = ADC_INTENCLR_WINMON;
+    ADC->WINLT.reg = threshold_q6 >> RF_ADC_RESULT_SHIFT;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->WINCTRL.reg = ADC_WINCTRL_WINMODE_MODE1;  // RESULT > WINLT
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->INTFLAG.reg = ADC_INTFLAG_WINMON;
+
+    sense_seen = false;
+    sense_armed = true;
+    NVIC_EnableIRQ(ADC_IRQn);
+    ADC->INTENSET.reg = ADC_INTENSET_WINMON;
+}
+
+// ============================================================================
+// READOUT
+// ============================================================================
+
+uint32_t rf_power_sense_quiet_ms(void) {
+    noInterrupts();
+    bool seen = sense_seen;
+    uint32_t last_ms = sense_ms;
+    interrupts();
+    return seen ? millis() - last_ms : UINT32_MAX;
+}
+
+void rf_power_read(RfChannel channel, RfPowerStats& stats) {
+    const RfChannelState& s = channels[channel];
+    uint32_t sum = 0;
+    uint64_t sum_sq = 0;
+    uint32_t count = 0;
+    uint16_t peak = 0;
+
+    noInterrupts();
+    for (uint8_t k = 0; k < RF_NUM_BUCKETS; k++) {
+        const RfBucket& b = s.buckets[(s.current + RF_NUM_BUCKETS - k) % RF_NUM_BUCKETS];
+        if (k < RF_RMS_BUCKETS) {
+            sum += b.sum;
+            sum_sq += b.sum_sq;
+            count += b.count;
+        }
+        if (k < RF_PEAK_HOLD_BUCKETS && b.max > peak) {
+            peak = b.max;
+        }
+    }
+    stats.envelope = (uint16_t)(s.envelope_q16 >> 16);
+    stats.samples = s.total_samples;
+    interrupts();
+
+    stats.peak = peak;
+    if (count) {
+        stats.mean = (uint16_t)(sum / count);
+        stats.rms = (uint16_t)isqrt32((uint32_t)(sum_sq / count));
+    } else {
+        stats.mean = 0;
+        stats.rms = 0;
+    }
+}
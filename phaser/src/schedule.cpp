@@ -0,0 +1,272 @@
+/**
+ * @file schedule.cpp
+ * @brief Direction changes queued ahead and executed by a hardware timer
+ *
+ * TC3 counts GCLK0 / 64 (750 kHz, 1.33 us per tick) as a 16-bit one-shot,
+ * so one shot reaches at most 87 ms. Longer waits are covered by a chain
+ * of SCHEDULE_STAGE_US shots: each interrupt works out the time left from
+ * micros() and re-arms for it, so the error of the earlier stages does
+ * not add up. The last shot ends on the due time.
+ *
+ * On SAMD micros() is millis() * 1000 plus the SysTick fraction, so the
+ * due time in microseconds is simply due_ms * 1000 (modulo 2^32).
+ *
+ * loop() changes the queue with the TC3 interrupt masked in the NVIC, not
+ * with interrupts off: the RF check re-enables interrupts.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include "wiring_private.h"
+
+#include "config.h"
+#include "schedule.h"
+#include "relays.h"
+#include "interlock.h"
+
+// ============================================================================
+// TIMER
+// ============================================================================
+
+/** @brief TC3 clock (GCLK0 / 64) */
+#define SCHEDULE_TIMER_HZ (F_CPU / 64)
+
+/** @brief Longest one-shot of the chain (us), within the 16-bit counter */
+#define SCHEDULE_STAGE_US 80000
+
+/** @brief Confirmations kept until reported (power of two) */
+#define SCHEDULE_RESULT_SLOTS 32
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+/** @brief One queued change */
+struct ScheduleEntry {
+    uint32_t due_ms;
+    uint8_t direction;
+};
+
+/** @brief Queued entries, earliest first */
+static ScheduleEntry queue[SCHEDULE_MAX_ENTRIES];
+static volatile uint8_t queued = 0;
+
+/** @brief Confirmations, indexed by free-running counters */
+static ScheduleReport results[SCHEDULE_RESULT_SLOTS];
+static volatile uint32_t fired_count = 0;      /**< Written by the interrupt */
+static uint32_t seen_count = 0;                /**< Picked up by loop() */
+static volatile uint32_t reported_count = 0;   /**< Acknowledged by the controller */
+
+/** @brief millis() of the last report attempt */
+static uint32_t last_report_ms = 0;
+static bool report_attempted = false;
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Start a one-shot
+ *
+ * @param us Time to the interrupt (us), at most SCHEDULE_STAGE_US
+ */
+static void timer_start(uint32_t us) {
+    uint32_t ticks = us * (SCHEDULE_TIMER_HZ / 1000) / 1000;
+    TC3->COUNT16.CC[0].reg = (uint16_t)max(ticks, (uint32_t)1);
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+    TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+    TC3->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_RETRIGGER;
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+}
+
+/**
+ * @brief Stop the timer (queue empty)
+ */
+static void timer_stop(void) {
+    TC3->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_STOP;
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+    TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+}
+
+/**
+ * @brief Execute the earliest entry and record the confirmation
+ */
+static void schedule_fire(void) {
+    const ScheduleEntry e = queue[0];
+    for (uint8_t i = 1; i < queued; i++) {
+        queue[i - 1] = queue[i];
+    }
+    queued--;
+
+    ScheduleReport& r = results[fired_count % SCHEDULE_RESULT_SLOTS];
+    r.due_ms = e.due_ms;
+    r.direction = e.direction;
+    r.position = relays_position(e.direction);  // Profile at the due time
+
+    int32_t late_us = (int32_t)(micros() - e.due_ms * 1000UL);
+    if (interlock_rf_present()) {
+        r.result = SCHEDULE_HELD;
+    } else {
+        // relays_write() refuses during a protection trip, atomically
+        r.result = relays_write(relays_pattern(r.position)) ? SCHEDULE_APPLIED
+                                                             : SCHEDULE_BLOCKED;
+    }
+    r.late_us = (int16_t)constrain(late_us, INT16_MIN, INT16_MAX);
+
+    fired_count++;
+    if (fired_count - reported_count > SCHEDULE_RESULT_SLOTS) {
+        reported_count = fired_count - SCHEDULE_RESULT_SLOTS;  // Oldest lost
+    }
+}
+
+/**
+ * @brief Execute what is due, then arm the timer for the next entry
+ *
+ * Runs in the TC3 interrupt, or from loop() with it masked.
+ */
+static void schedule_service(void) {
+    while (queued > 0) {
+        int32_t left_ms = (int32_t)(queue[0].due_ms - millis());
+        if (left_ms > SCHEDULE_STAGE_US / 1000) {
+            timer_start(SCHEDULE_STAGE_US);
+            return;
+        }
+        int32_t left_us = (int32_t)(queue[0].due_ms * 1000UL - micros());
+        if (left_us * (int32_t)(SCHEDULE_TIMER_HZ / 1000) / 1000 > 0) {
+            timer_start((uint32_t)left_us);
+            return;
+        }
+        schedule_fire();
+    }
+    timer_stop();
+}
+
+/**
+ * @brief One-shot expired: next stage, or an entry is due
+ */
+void TC3_Handler(void) {
+    TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+    schedule_service();
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void schedule_init(void) {
+    queued = 0;
+    fired_count = seen_count = reported_count = 0;
+
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_TCC2_TC3 | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+    while (GCLK->STATUS.bit.SYNCBUSY);
+
+    TC3->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+    TC3->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ |
+                             TC_CTRLA_PRESCALER_DIV64;
+    TC3->COUNT16.CTRLBSET.reg = TC_CTRLBSET_ONESHOT;
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+    TC3->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+    timer_stop();  // A one-shot starts on enable
+    TC3->COUNT16.INTENSET.reg = TC_INTENSET_OVF;
+    NVIC_EnableIRQ(TC3_IRQn);
+}
+
+ScheduleStatus schedule_add(uint32_t due_ms, uint8_t direction) {
+    int32_t ahead = (int32_t)(due_ms - millis());
+    if (ahead < 0 || (uint32_t)ahead > SCHEDULE_MAX_AHEAD_MS) {
+        return SCHEDULE_BAD_TIME;
+    }
+
+    NVIC_DisableIRQ(TC3_IRQn);
+    if (queued >= SCHEDULE_MAX_ENTRIES) {
+        NVIC_EnableIRQ(TC3_IRQn);
+        return SCHEDULE_FULL;
+    }
+    uint8_t i = queued;
+    while (i > 0 && (int32_t)(queue[i - 1].due_ms - due_ms) > 0) {
+        queue[i] = queue[i - 1];
+        i--;
+    }
+    queue[i].due_ms = due_ms;
+    queue[i].direction = direction;
+    queued++;
+    if (i == 0) {
+        schedule_service();  // New earliest entry
+    }
+    NVIC_EnableIRQ(TC3_IRQn);
+    return SCHEDULE_OK;
+}
+
+void schedule_clear(void) {
+    NVIC_DisableIRQ(TC3_IRQn);
+    queued = 0;
+    timer_stop();
+    NVIC_EnableIRQ(TC3_IRQn);
+}
+
+uint8_t schedule_pending(void) {
+    return queued;
+}
+
+bool schedule_due_within(uint32_t window_ms) {
+    NVIC_DisableIRQ(TC3_IRQn);
+    bool due = queued > 0 && (int32_t)(queue[0].due_ms - millis()) <= (int32_t)window_ms;
+    NVIC_EnableIRQ(TC3_IRQn);
+    return due;
+}
+
+void schedule_wait_clear(uint32_t window_ms) {
+    while (schedule_due_within(window_ms));
+}
+
+bool schedule_next_fired(ScheduleReport& report) {
+    NVIC_DisableIRQ(TC3_IRQn);
+    if (fired_count - seen_count > SCHEDULE_RESULT_SLOTS) {
+        seen_count = fired_count - SCHEDULE_RESULT_SLOTS;
+    }
+    bool found = seen_count != fired_count;
+    if (found) {
+        report = results[seen_count % SCHEDULE_RESULT_SLOTS];
+        seen_count++;
+    }
+    NVIC_EnableIRQ(TC3_IRQn);
+    return found;
+}
+
+bool schedule_report_due(void) {
+    NVIC_DisableIRQ(TC3_IRQn);
+    uint32_t waiting = fired_count - reported_count;
+    uint32_t oldest_ms = results[reported_count % SCHEDULE_RESULT_SLOTS].due_ms;
+    NVIC_EnableIRQ(TC3_IRQn);
+
+    uint32_t now = millis();
+    if (waiting == 0 ||
+        (report_attempted && now - last_report_ms < SCHEDULE_REPORT_MS) ||
+        (waiting < SCHEDULE_REPORT_BATCH && now - oldest_ms < SCHEDULE_REPORT_MS)) {
+        return false;
+    }
+    last_report_ms = now;
+    report_attempted = true;
+    return true;
+}
+
+uint8_t schedule_unreported(ScheduleReport* reports, uint8_t max) {
+    NVIC_DisableIRQ(TC3_IRQn);
+    uint8_t n = 0;
+    for (uint32_t i = reported_count; i != fired_count && n < max; i++) {
+        reports[n++] = results[i % SCHEDULE_RESULT_SLOTS];
+    }
+    NVIC_EnableIRQ(TC3_IRQn);
+    return n;
+}
+
+void schedule_reported(uint8_t count) {
+    NVIC_DisableIRQ(TC3_IRQn);
+    uint32_t waiting = fired_count - reported_count;
+    reported_count += min((uint32_t)count, waiting);
+    NVIC_EnableIRQ(TC3_IRQn);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file sensor_stats.cpp
+ * @brief Streaming min/max/mean/variance of every sensor channel
+ *
+ * Welford update for a new value x after n samples:
+ *     delta  = x - mean
+ *     mean  += delta / (n + 1)
+ *     m2    += delta * (x - mean)
+ * variance = m2 / (n - 1). With the mean in Q8 the rounding error of each
+ * division is below 1/512 of a unit and does not accumulate in m2.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "sensor_stats.h"
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+/** @brief Fractional bits of the running mean */
+#define STATS_MEAN_SHIFT 8
+
+/** @brief Running statistics of one channel */
+struct WelfordAcc {
+    uint32_t count;        /**< Samples */
+    int32_t mean_q8;       /**< Mean, Q8 */
+    int64_t m2_q16;        /**< Sum of squared deviations, Q16 */
+    int16_t min;           /**< Minimum */
+    int16_t max;           /**< Maximum */
+};
+
+/** @brief Accumulators: [0] all samples, [1 + d] direction d */
+static WelfordAcc accs[1 + NUM_DIRECTIONS][HIST_NUM_CHANNELS];
+
+// ============================================================================
+// INTERNAL
+// ============================================================================
+
+/**
+ * @brief Signed division rounded to nearest
+ *
+ * @param num Numerator
+ * @param den Denominator, > 0
+ * @return num / den, rounded half away from zero
+ */
+static int32_t div_round(int32_t num, uint32_t den) {
+    return (num >= 0) ? (int32_t)((num + den / 2) / den)
+                      : -(int32_t)((-num + den / 2) / den);
+}
+
+/**
+ * @brief Welford update of one accumulator
+ *
+ * @param a Accumulator
+ * @param x New value
+ */
+static void welford_add(WelfordAcc& a, int16_t x) {
+    int32_t x_q8 = (int32_t)x << STATS_MEAN_SHIFT;
+
+    if (a.count == 0) {
+        a.min = x;
+        a.max = x;
+    } else {
+        if (x < a.min) a.min = x;
+        if (x > a.max) a.max = x;
+    }
+    a.count++;
+
+    int32_t delta = x_q8 - a.mean_q8;
+    a.mean_q8 += div_round(delta, a.count);
+    a.m2_q16 += (int64_t)delta * (x_q8 - a.mean_q8);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void sensor_stats_reset(void) {
+    memset(accs, 0, sizeof(accs));
+}
+
+void sensor_stats_add(const int16_t values[HIST_NUM_CHANNELS], uint8_t direction) {
+    for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+        welford_add(accs[0][c], values[c]);
+        if (direction < NUM_DIRECTIONS) {
+            welford_add(accs[1 + direction][c], values[c]);
+        }
+    }
+}
+
+uint32_t sensor_stats_read(uint8_t scope, SensorStat out[HIST_NUM_CHANNELS]) {
+    uint8_t row = (scope == STATS_SCOPE_ALL) ? 0 : 1 + scope;
+    if (scope != STATS_SCOPE_ALL && scope >= NUM_DIRECTIONS) {
+        memset(out, 0, sizeof(SensorStat) * HIST_NUM_CHANNELS);
+        return 0;
+    }
+
+    for (uint8_t c = 0; c < HIST_NUM_CHANNELS; c++) {
+        const WelfordAcc& a = accs[row][c];
+        out[c].min = a.min;
+        out[c].max = a.max;
+        out[c].mean = (int16_t)div_round(a.mean_q8, 1U << STATS_MEAN_SHIFT);
+
+        uint64_t var = 0;
+        if (a.count >= 2 && a.m2_q16 > 0) {
+            uint64_t den = (uint64_t)(a.count - 1) << (2 * STATS_MEAN_SHIFT);
+            var = ((uint64_t)a.m2_q16 + den / 2) / den;
+        }
+        out[c].variance = (var > UINT32_MAX) ? UINT32_MAX : (uint32_t)var;
+    }
+    return accs[row][0].count;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file swr.cpp
+ * @brief Fixed-point SWR and return loss from forward and reverse power
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "swr.h"
+
+// ============================================================================
+// LOOKUP TABLES
+// ============================================================================
+
+/**
+ * @brief sqrt(x) for x = 0.25 .. 1.0 in steps of 1/256, Q16
+ *
+ * Inputs are normalised into this range by shifting in pairs of bits,
+ * which keeps relative accuracy constant down to small ratios.
+ * SQRT_LUT[192] (1.0) is saturated to 65535.
+ */
+static const uint16_t SQRT_LUT[193] = {
+    32768, 33023, 33276, 33527, 33776, 34024, 34270, 34514, 34756, 34996, 35235, 35472,
+    35708, 35942, 36175, 36406, 36636, 36864, 37091, 37316, 37540, 37763, 37985, 38205,
+    38424, 38642, 38858, 39073, 39287, 39500, 39712, 39923, 40132, 40341, 40548, 40755,
+    40960, 41164, 41368, 41570, 41771, 41972, 42171, 42369, 42567, 42763, 42959, 43154,
+    43348, 43541, 43733, 43925, 44115, 44305, 44494, 44682, 44869, 45056, 45242, 45427,
+    45611, 45795, 45977, 46160, 46341, 46522, 46702, 46881, 47059, 47237, 47415, 47591,
+    47767, 47942, 48117, 48291, 48465, 48637, 48809, 48981, 49152, 49322, 49492, 49661,
+    49830, 49998, 50166, 50332, 50499, 50665, 50830, 50995, 51159, 51323, 51486, 51649,
+    51811, 51972, 52134, 52294, 52454, 52614, 52773, 52932, 53090, 53248, 53405, 53562,
+    53719, 53874, 54030, 54185, 54340, 54494, 54647, 54801, 54954, 55106, 55258, 55410,
+    55561, 55712, 55862, 56012, 56162, 56311, 56459, 56608, 56756, 56903, 57051, 57198,
+    57344, 57490, 57636, 57781, 57926, 58071, 58215, 58359, 58503, 58646, 58789, 58931,
+    59073, 59215, 59357, 59498, 59639, 59779, 59919, 60059, 60199, 60338, 60477, 60615,
+    60753, 60891, 61029, 61166, 61303, 61440, 61576, 61712, 61848, 61984, 62119, 62254,
+    62388, 62523, 62657, 62790, 62924, 63057, 63190, 63323, 63455, 63587, 63719, 63850,
+    63982, 64113, 64243, 64374, 64504, 64634, 64763, 64893, 65022, 65151, 65279, 65408,
+    65535
+};
+
+/** @brief log2(1 + i/32) for i = 0..32, Q16 */
+static const uint16_t LOG2_LUT[33] = {
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65535
+};
+
+/** @brief |Gamma| (Q16) at which SWR reaches SWR_MAX_X100 (0.9802) */
+#define SWR_RHO_LIMIT 64238UL
+
+/** @brief Return loss in 0.1 dB per unit of log2, Q8 (100 log10(2) x 256) */
+#define RL_X10_PER_LOG2_Q8 7706UL
+
+// ============================================================================
+// WINDOW STATE
+// ============================================================================
+
+/** @brief Ring of SWR readings x 100, 0 = no carrier */
+static uint16_t window[SWR_WINDOW_SAMPLES];
+static uint8_t window_head = 0;
+
+// ============================================================================
+// MATH
+// ============================================================================
+
+uint16_t sqrt_frac_q16(uint32_t x_q32) {
+    if (x_q32 == 0) {
+        return 0;
+    }
+
+    // Normalise into [0.25, 1): each 2-bit shift of x is 1 bit of the root
+    uint8_t shift = 0;
+    while (x_q32 < 0x40000000UL) {
+        x_q32 <<= 2;
+        shift++;
+    }
+
+    uint32_t offset = (x_q32 - 0x40000000UL) >> 16;   // Q16 steps above 0.25
+    uint8_t idx = offset >> 8;
+    uint32_t frac = offset & 0xFF;
+    uint32_t root = SQRT_LUT[idx] + (((uint32_t)(SQRT_LUT[idx + 1] - SQRT_LUT[idx]) * frac) >> 8);
+
+    return (uint16_t)(root >> shift);
+}
+
+uint32_t log2_q12(uint32_t v) {
+    if (v == 0) {
+        return 0;
+    }
+
+    uint8_t n = 31 - __builtin_clz(v);
+    uint32_t mant = (v << (31 - n)) & 0x7FFFFFFFUL;   // Fraction of [1, 2), Q31
+    uint8_t idx = mant >> 26;
+    uint32_t rem = (mant >> 10) & 0xFFFF;
+    uint32_t step = (uint32_t)(LOG2_LUT[idx + 1] - LOG2_LUT[idx]);
+    uint32_t frac_q16 = LOG2_LUT[idx] + ((step * rem) >> 16);
+
+    return ((uint32_t)n << 12) + (frac_q16 >> 4);
+}
+
+bool swr_compute(uint16_t fwd_dw, uint16_t rev_dw, SwrReading& out) {
+    out.valid = false;
+    out.rho_q16 = 0;
+    out.swr_x100 = 0;
+    out.rl_x10 = 0;
+
+    if (fwd_dw < SWR_MIN_FWD_DW) {
+        return false;
+    }
+    out.valid = true;
+
+    if (rev_dw >= fwd_dw) {
+        out.rho_q16 = 65535;
+    } else {
+        // Prev / Pfwd as a Q32 fraction, in two 16-bit long-division steps
+        uint32_t num = (uint32_t)rev_dw << 16;
+        uint32_t ratio_q32 = ((num / fwd_dw) << 16) + ((num % fwd_dw) << 16) / fwd_dw;
+        out.rho_q16 = sqrt_frac_q16(ratio_q32);
+    }
+
+    if (out.rho_q16 >= SWR_RHO_LIMIT) {
+        out.swr_x100 = SWR_MAX_X100;
+    } else {
+        uint32_t den = 65536UL - out.rho_q16;
+        out.swr_x100 = (uint16_t)(((65536UL + out.rho_q16) * 100 + den / 2) / den);
+    }
+
+    if (rev_dw == 0) {
+        out.rl_x10 = SWR_MAX_RL_X10;
+    } else if (rev_dw >= fwd_dw) {
+        out.rl_x10 = 0;
+    } else {
+        uint32_t diff_q12 = log2_q12(fwd_dw) - log2_q12(rev_dw);
+        uint32_t rl = (diff_q12 * RL_X10_PER_LOG2_Q8 + (1UL << 19)) >> 20;
+        out.rl_x10 = (uint16_t)min(rl, (uint32_t)SWR_MAX_RL_X10);
+    }
+    return true;
+}
+
+// ============================================================================
+// WINDOW
+// ============================================================================
+
+void swr_window_add(const SwrReading& reading) {
+    window[window_head] = reading.valid ? reading.swr_x100 : 0;
+    window_head = (window_head + 1) % SWR_WINDOW_SAMPLES;
+}
+
+void swr_window_read(SwrWindowStats& stats) {
+    uint32_t sum = 0;
+    stats.min_x100 = 0;
+    stats.max_x100 = 0;
+    stats.count = 0;
+
+    for (uint8_t i = 0; i < SWR_WINDOW_SAMPLES; i++) {
+        uint16_t v = window[i];
+        if (v == 0) {
+            continue;
+        }
+        if (stats.count == 0 || v < stats.min_x100) stats.min_x100 = v;
+        if (v > stats.max_x100) stats.max_x100 = v;
+        sum += v;
+        stats.count++;
+    }
+    stats.mean_x100 = stats.count ? (uint16_t)(sum / stats.count) : 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file tasks.cpp
+ * @brief Cooperative task scheduler for loop()
+ *
+ * Due times advance by whole periods from the first one, so a task keeps
+ * its rate when single runs start late. A task more than one period
+ * behind (after a long radio exchange) is re-phased to now instead of
+ * running back to back to catch up.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "tasks.h"
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+/** @brief One registered task */
+struct Task {
+    const char* name;
+    TaskFunction fn;
+    uint32_t period_ms;
+    uint32_t deadline_ms;
+    uint32_t due_ms;
+    uint8_t priority;
+    TaskStats stats;
+};
+
+static Task tasks[TASK_MAX];
+static uint8_t task_count = 0;
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+int8_t tasks_add(const char* name, TaskFunction fn, uint32_t period_ms,
+                 uint32_t deadline_ms, uint8_t priority) {
+    if (task_count >= TASK_MAX || !fn) {
+        return -1;
+    }
+    Task& t = tasks[task_count];
+    memset(&t, 0, sizeof(t));
+    t.name = name;
+    t.fn = fn;
+    t.period_ms = period_ms;
+    t.deadline_ms = deadline_ms;
+    t.due_ms = millis();
+    t.priority = priority;
+    return (int8_t)task_count++;
+}
+
+bool tasks_run(void) {
+    uint32_t now = millis();
+
+    // Most urgent due task: lowest priority number, then earliest due
+    int8_t next = -1;
+    for (uint8_t i = 0; i < task_count; i++) {
+        const Task& t = tasks[i];
+        if ((int32_t)(now - t.due_ms) < 0) {
+            continue;
+        }
+        if (next < 0 || t.priority < tasks[next].priority ||
+            (t.priority == tasks[next].priority &&
+             (int32_t)(t.due_ms - tasks[next].due_ms) < 0)) {
+            next = (int8_t)i;
+        }
+    }
+    if (next < 0) {
+        return false;
+    }
+
+    Task& t = tasks[next];
+    uint32_t late_ms = now - t.due_ms;
+    if (late_ms > t.deadline_ms) {
+        t.stats.misses++;
+    }
+    t.stats.max_late_ms = max(t.stats.max_late_ms, late_ms);
+
+    t.due_ms += t.period_ms;
+    if ((int32_t)(now - t.due_ms) >= 0) {
+        t.due_ms = now + t.period_ms;  // More than a period behind
+    }
+
+    uint32_t start_us = micros();
+    t.fn();
+    t.stats.max_run_us = max(t.stats.max_run_us, micros() - start_us);
+    t.stats.runs++;
+    return true;
+}
+
+uint8_t tasks_count(void) {
+    return task_count;
+}
+
+const char* tasks_name(uint8_t id) {
+    return (id < task_count) ? tasks[id].name : "";
+}
+
+void tasks_stats(uint8_t id, TaskStats& stats) {
+    if (id < task_count) {
+        stats = tasks[id].stats;
+    } else {
+        memset(&stats, 0, sizeof(stats));
+    }
+}
+
+void tasks_reset_stats(void) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        memset(&tasks[i].stats, 0, sizeof(tasks[i].stats));
+    }
+}
+
+void tasks_log(void) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        const Task& t = tasks[i];
+        Serial.printf("Task %-6s P%u %5lu ms: %lu runs, %lu missed, "
+                      "late max %lu ms, run max %lu us\n",
+                      t.name, t.priority, (unsigned long)t.period_ms,
+                      (unsigned long)t.stats.runs, (unsigned long)t.stats.misses,
+                      (unsigned long)t.stats.max_late_ms, (unsigned long)t.stats.max_run_us);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * @file bulk_decode.cpp
+ * @brief Linux host decoder for compressed bulk history chunks
+ *
+ * Reads bulk chunks as hex, one per line, and prints the records as CSV.
+ * Lines may carry the "BULK " prefix the controller prints when
+ * BULK_ECHO_RAW is enabled, so a serial capture can be piped straight in:
+ *
+ *   g++ -O2 -I../controller/include -o bulk_decode bulk_decode.cpp
+ *   ./bulk_decode < capture.log > history.csv
+ *
+ * Uses the same bulk_codec.h as the firmware; records are decoded in
+ * place from each line's byte buffer.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "bulk_codec.h"
+
+/** @brief Largest chunk accepted (one LoRa frame) */
+#define MAX_CHUNK_LEN 255
+
+/**
+ * @brief Convert a hex string to bytes
+ *
+ * @param hex Hex characters (stops at the first non-hex character)
+ * @param out Output buffer
+ * @param cap Output capacity
+ * @return Bytes written, 0 on odd length or overflow
+ */
+static size_t hex_to_bytes(const char* hex, uint8_t* out, size_t cap) {
+    size_t n = 0;
+    while (isxdigit((unsigned char)hex[0]) && isxdigit((unsigned char)hex[1])) {
+        if (n >= cap) return 0;
+        unsigned int byte;
+        sscanf(hex, "%2x", &byte);
+        out[n++] = (uint8_t)byte;
+        hex += 2;
+    }
+    return n;
+}
+
+int main(void) {
+    char line[2 * MAX_CHUNK_LEN + 64];
+    uint8_t chunk[MAX_CHUNK_LEN];
+    int bad = 0;
+
+    printf("session,chunk,tier,start_ms,direction,changed,"
+           "bus_mv_min,bus_mv_max,bus_mv_mean,"
+           "bus_ma_min,bus_ma_max,bus_ma_mean,"
+           "mcu_mv_min,mcu_mv_max,mcu_mv_mean,"
+           "rev_dw_min,rev_dw_max,rev_dw_mean\n");
+
+    while (fgets(line, sizeof(line), stdin)) {
+        const char* hex = line;
+        if (strncmp(hex, "BULK ", 5) == 0) {
+            hex += 5;
+        } else if (strstr(line, "BULK ")) {
+            hex = strstr(line, "BULK ") + 5;  // Timestamped monitor output
+        }
+
+        size_t len = hex_to_bytes(hex, chunk, sizeof(chunk));
+        if (len == 0 || chunk[0] != BULK_CHUNK_MARKER) {
+            continue;
+        }
+
+        BulkChunkDecoder decoder(chunk, len);
+        BulkRecord rec;
+        while (decoder.next(rec)) {
+            printf("%u,%u,%u,%lu,%u,%u",
+                   decoder.header().session, decoder.header().index, decoder.header().tier,
+                   (unsigned long)rec.start_ms, rec.direction & 0x07,
+                   (rec.direction & 0x08) ? 1 : 0);
+            for (int c = 0; c < BULK_NUM_CHANNELS; c++) {
+                printf(",%d,%d,%d", rec.min[c], rec.max[c], rec.mean[c]);
+            }
+            printf("\n");
+        }
+        if (!decoder.ok()) {
+            fprintf(stderr, "malformed chunk: %s", line);
+            bad++;
+        }
+    }
+
+    return bad ? 1 : 0;
+}
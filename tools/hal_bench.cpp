@@ -0,0 +1,241 @@
+/**
+ * @file hal_bench.cpp
+ * @brief Linux host checks and timings for the controller hardware layer
+ *
+ * Builds controller/include/hardware.h against the native backend and runs
+ * the common layer the firmware uses:
+ *
+ * - debounce_pin() and ptt_pressed() on a steady, a bouncing and a
+ *   released input (the bounce comes from an on_tick callback)
+ * - button reads and the one-lit-LED rule
+ * - a frame sent to a simulated phaser that checks the authentication
+ *   bytes and answers with a position reply
+ * - the telemetry screen drawn from that reply
+ *
+ * then times the calls (ns per call, simulated sleeps cost nothing), so a
+ * change to the layer can be compared before and after.
+ *
+ *   g++ -O2 -I../controller/include -o hal_bench hal_bench.cpp ../controller/src/config.cpp
+ *   ./hal_bench [iterations]
+ *
+ * Exit status is 0 if every check passes.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "hardware.h"
+
+Board board;
+
+static uint32_t failures = 0;
+
+/**
+ * @brief Record one check
+ *
+ * @param ok Result
+ * @param what Description printed on failure
+ */
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("  FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// ============================================================================
+// SIMULATED PHASER
+// ============================================================================
+
+/** @brief Position reply as the phaser sends it */
+static const char POSITION_REPLY[] = ";135r-071v12123i045b3301";
+
+/** @brief Frames the responder accepted */
+static uint32_t phaser_frames = 0;
+
+/**
+ * @brief Check the authentication bytes and queue a position reply
+ */
+static void phaser_respond(NativeHardware& hw, const uint8_t* data, uint8_t len) {
+    if (len <= AUTH_LEN) {
+        return;
+    }
+    uint8_t body = len - AUTH_LEN;
+    uint16_t auth = compute_auth(data, body);
+    if (data[body] != (auth >> 8) || data[body + 1] != (auth & 0xFF)) {
+        return;
+    }
+    phaser_frames++;
+    hw.sim_deliver((const uint8_t*)POSITION_REPLY, sizeof(POSITION_REPLY) - 1, DEST_ADDRESS);
+}
+
+/** @brief Toggle PTT_PIN every few milliseconds */
+static void bounce_ptt(NativeHardware& hw) {
+    hw.sim_set_pin(PTT_PIN, (hw.now_ms() / 3) & 1);
+}
+
+// ============================================================================
+// CHECKS
+// ============================================================================
+
+static void check_inputs(void) {
+    board.sim_reset();
+    check(!ptt_pressed(), "released PTT reads as pressed");
+
+    board.sim_set_pin(PTT_PIN, LOW);
+    uint32_t start = board.now_ms();
+    check(ptt_pressed(), "steady PTT not seen");
+    check(board.now_ms() - start == DEBOUNCE_DELAY_MS, "debounce did not wait DEBOUNCE_DELAY_MS");
+
+    board.on_tick = bounce_ptt;
+    check(!ptt_pressed(), "bouncing PTT reads as pressed");
+    board.on_tick = NULL;
+
+    board.sim_button(5, true);
+    check(gpio_read_button(5), "pressed button not seen");
+    check(!gpio_read_button(4), "released button reads as pressed");
+    check(!gpio_read_button(NUM_DIRECTIONS), "out of range button reads as pressed");
+    board.sim_button(5, false);
+    check(!gpio_read_button(5), "button stays pressed after release");
+}
+
+static void check_leds(void) {
+    board.sim_reset();
+    gpio_show_led(2);
+    gpio_show_led(6);
+    for (int i = 0; i < NUM_DIRECTIONS; i++) {
+        check(board.sim_led(i) == (i == 6), "gpio_show_led left another LED lit");
+    }
+    gpio_all_leds_off();
+    for (int i = 0; i < NUM_DIRECTIONS; i++) {
+        check(!board.sim_led(i), "gpio_all_leds_off left an LED lit");
+    }
+    gpio_blink_led(1, 10, 3);
+    check(!board.sim_led(1), "blinked LED left on");
+    check(board.now_ms() == 60, "blink took the wrong time");
+}
+
+static void check_radio_and_screen(void) {
+    board.sim_reset();
+    board.responder = phaser_respond;
+    phaser_frames = 0;
+
+    uint8_t frame[8] = {'A', 'I', '1'};
+    uint16_t auth = compute_auth(frame, 3);
+    frame[3] = auth >> 8;
+    frame[4] = auth & 0xFF;
+    check(board.radio_send(frame, 5, DEST_ADDRESS, 7), "send refused");
+    check(board.tx_to == DEST_ADDRESS && board.tx_id == 7, "header not recorded");
+    check(board.radio_acked(DEST_ADDRESS, 7) && !board.radio_acked(DEST_ADDRESS, 6),
+          "ACK not matched to the header id");
+    check(phaser_frames == 1, "phaser rejected the authentication bytes");
+
+    uint8_t reply[PACKET_MTU];
+    uint8_t len = sizeof(reply);
+    uint8_t from = 0;
+    check(board.radio_wait(REC_TIMEOUT), "no reply");
+    check(board.radio_receive(reply, len, from), "reply not received");
+    check(from == DEST_ADDRESS && len == sizeof(POSITION_REPLY) - 1, "reply garbled");
+    check(!board.radio_available(), "reply received twice");
+
+    frame[0] = 'X';
+    board.radio_send(frame, 5, DEST_ADDRESS, 8);
+    check(phaser_frames == 1, "phaser accepted a bad authentication");
+    check(!board.radio_wait(REC_TIMEOUT), "reply to a rejected frame");
+
+    board.display_show_telemetry(reply, len, "-12.5 ", DIRECTION_NAMES[3]);
+    check(strncmp(board.sim_screen_row(0), "R", 1) == 0, "reverse power row missing");
+    check(strstr(board.sim_screen_row(2), "/-071") != NULL, "RSSI row wrong");
+    check(strstr(board.sim_screen_row(3), "12.123") != NULL, "bus voltage row wrong");
+    check(strstr(board.sim_screen_row(5), "045") != NULL, "bus current row wrong");
+    check(strstr(board.sim_screen_row(6), "3.301") != NULL, "MCU voltage row wrong");
+    check(strstr(board.sim_screen_row(7), "Dir: SE") != NULL, "direction row wrong");
+    for (int row = 0; row < SIM_SCREEN_ROWS; row++) {
+        printf("  |%s|\n", board.sim_screen_row(row));
+    }
+}
+
+// ============================================================================
+// TIMINGS
+// ============================================================================
+
+/**
+ * @brief Time a call
+ *
+ * @param name Printed label
+ * @param iterations Calls to make
+ * @param fn Call under test
+ */
+template <class Fn>
+static void time_call(const char* name, uint32_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    printf("  %-28s %8.1f ns/call\n", name, (double)ns / iterations);
+}
+
+static volatile uint32_t sink;
+
+static void run_timings(uint32_t iterations) {
+    board.sim_reset();
+    board.sim_set_pin(PTT_PIN, LOW);
+    time_call("ptt_pressed (25 ms sim)", iterations / 10, [](uint32_t) {
+        sink += ptt_pressed();
+    });
+    time_call("gpio_read_button", iterations, [](uint32_t i) {
+        sink += gpio_read_button(i % NUM_DIRECTIONS);
+    });
+    time_call("gpio_show_led", iterations, [](uint32_t i) {
+        gpio_show_led(i % NUM_DIRECTIONS);
+    });
+
+    uint8_t frame[5] = {'A', 'I', '1', 0, 0};
+    time_call("radio_send + receive", iterations, [&frame](uint32_t i) {
+        uint8_t reply[PACKET_MTU];
+        uint8_t len = sizeof(reply);
+        uint8_t from;
+        board.sim_deliver(frame, sizeof(frame), DEST_ADDRESS);
+        board.radio_send(frame, sizeof(frame), DEST_ADDRESS, (uint8_t)i);
+        sink += board.radio_receive(reply, len, from);
+    });
+
+    const uint8_t* reply = (const uint8_t*)POSITION_REPLY;
+    time_call("display_show_telemetry", iterations / 10, [reply](uint32_t) {
+        board.display_show_telemetry(reply, sizeof(POSITION_REPLY) - 1, "-12.5 ",
+                                     DIRECTION_NAMES[3]);
+    });
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000;
+    if (iterations < 10) {
+        iterations = 10;
+    }
+
+    printf("Backend: NativeHardware (%u bytes), %u band names\n", (unsigned)sizeof(Board),
+           (unsigned)(sizeof(BAND_NAMES) / sizeof(BAND_NAMES[0])));
+
+    printf("Inputs\n");
+    check_inputs();
+    printf("LEDs\n");
+    check_leds();
+    printf("Radio and screen\n");
+    check_radio_and_screen();
+    printf("Timings\n");
+    run_timings(iterations);
+
+    printf("%s (%u failures)\n", failures ? "FAIL" : "PASS", (unsigned)failures);
+    return failures ? 1 : 0;
+}
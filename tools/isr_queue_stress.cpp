@@ -0,0 +1,231 @@
+/**
+ * @file isr_queue_stress.cpp
+ * @brief Linux host stress test and benchmark for isr_queue.h
+ *
+ * Two runs against the same header the firmware uses:
+ *
+ * - threads: a producer thread and a consumer thread on different cores
+ *   push and pop as fast as they can. Measures throughput; checks that
+ *   every item arrives once, in order and intact.
+ *
+ * - interrupt: a POSIX timer signal plays the interrupt handler. It
+ *   preempts the consumer at arbitrary instructions, pushes a burst of
+ *   items and raises an event, exactly as an ISR would on the MCU (it
+ *   never waits; a full queue drops). Checks that items received plus
+ *   items dropped equals items produced, that the received sequence only
+ *   skips dropped items, and that no event raise is lost.
+ *
+ *   g++ -O2 -pthread -I../phaser/include -o isr_queue_stress isr_queue_stress.cpp
+ *   ./isr_queue_stress [items] [interrupt_seconds]
+ *
+ * Exit status is 0 if both runs pass.
+ *
+ * @author Rajiv Dewan, N2RD
+ * @date 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <thread>
+#include <chrono>
+
+#include "isr_queue.h"
+
+/** @brief Queue item: a sequence number and its complement to catch torn copies */
+struct Item {
+    uint32_t seq;
+    uint32_t check;
+};
+
+/** @brief Capacity of the queues under test (as in the firmware) */
+#define QUEUE_LEN 64
+
+/** @brief Period of the simulated interrupt (ns) */
+#define IRQ_PERIOD_NS 20000
+
+/** @brief Most items pushed by one simulated interrupt */
+#define IRQ_BURST_MAX 8
+
+// ============================================================================
+// THREAD RUN
+// ============================================================================
+
+static IsrQueue<Item, QUEUE_LEN> thread_queue;
+
+/**
+ * @brief Let the other thread run now and then while spinning
+ *
+ * Only matters on a single-core host, where spinning would otherwise
+ * burn the whole time slice.
+ *
+ * @param spins Failed attempts so far
+ */
+static void back_off(uint32_t spins) {
+    if (spins % 256 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+}
+
+/**
+ * @brief Producer and consumer threads at full speed
+ *
+ * @param count Items to pass
+ * @return true if every item arrived once, in order and intact
+ */
+static bool run_threads(uint32_t count) {
+    uint32_t errors = 0;
+    uint32_t full_spins = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([count, &full_spins]() {
+        for (uint32_t seq = 0; seq < count; seq++) {
+            Item item = {seq, ~seq};
+            while (!thread_queue.push(item)) {
+                full_spins++;
+                back_off(full_spins);
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t empty_spins = 0;
+    Item item;
+    while (expected < count) {
+        if (!thread_queue.pop(item)) {
+            back_off(++empty_spins);
+            continue;
+        }
+        if (item.seq != expected || item.check != ~item.seq) {
+            if (errors++ < 10) {
+                printf("  threads: got %u/%08X, expected %u\n", item.seq, item.check, expected);
+            }
+            expected = item.seq;
+        }
+        expected++;
+    }
+    producer.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+
+    printf("threads:   %u items in %.3f s, %.1f M items/s, %u pushes found it full, %u errors\n",
+           count, seconds, count / seconds / 1e6, full_spins, errors);
+    return errors == 0 && thread_queue.empty();
+}
+
+// ============================================================================
+// INTERRUPT RUN
+// ============================================================================
+
+static IsrQueue<Item, QUEUE_LEN> irq_queue;
+static IsrEvents<2> irq_events;
+
+/** @brief Producer state, touched only by the handler until it is disarmed */
+static volatile uint32_t irq_next_seq = 0;
+static volatile uint32_t irq_count = 0;
+static volatile uint32_t irq_rng = 12345;
+
+/**
+ * @brief Simulated interrupt handler: push a burst, raise an event
+ */
+static void irq_handler(int) {
+    uint32_t rng = irq_rng * 1103515245u + 12345u;
+    irq_rng = rng;
+    uint32_t burst = 1 + (rng >> 16) % IRQ_BURST_MAX;
+
+    uint32_t seq = irq_next_seq;
+    for (uint32_t i = 0; i < burst; i++, seq++) {
+        Item item = {seq, ~seq};
+        irq_queue.push(item);  // Dropped and counted when full
+    }
+    irq_next_seq = seq;
+    irq_events.raise(0);
+    irq_count = irq_count + 1;
+}
+
+/**
+ * @brief Consumer preempted by the simulated interrupt
+ *
+ * @param seconds Run time
+ * @return true if nothing was lost, duplicated, reordered or torn
+ */
+static bool run_interrupt(uint32_t seconds) {
+    struct sigaction sa = {};
+    sa.sa_handler = irq_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGALRM, &sa, NULL);
+
+    timer_t timer;
+    struct sigevent sev = {};
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = SIGALRM;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timer) != 0) {
+        perror("timer_create");
+        return false;
+    }
+    struct itimerspec its = {};
+    its.it_interval.tv_nsec = IRQ_PERIOD_NS;
+    its.it_value.tv_nsec = IRQ_PERIOD_NS;
+    timer_settime(timer, 0, &its, NULL);
+
+    uint32_t received = 0;
+    uint32_t skipped = 0;
+    uint32_t errors = 0;
+    uint64_t events = 0;
+    uint32_t next = 0;
+    Item item;
+
+    auto stop = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < stop) {
+        events += irq_events.take(0);
+        while (irq_queue.pop(item)) {
+            if (item.check != ~item.seq || item.seq < next) {
+                if (errors++ < 10) {
+                    printf("  interrupt: got %u/%08X after %u\n", item.seq, item.check, next);
+                }
+            } else {
+                skipped += item.seq - next;  // Dropped while the queue was full
+            }
+            next = item.seq + 1;
+            received++;
+        }
+    }
+
+    // Disarm, then drain what the last interrupts left
+    its.it_interval.tv_nsec = 0;
+    its.it_value.tv_nsec = 0;
+    timer_settime(timer, 0, &its, NULL);
+    timer_delete(timer);
+    events += irq_events.take(0);
+    while (irq_queue.pop(item)) {
+        skipped += item.seq - next;
+        next = item.seq + 1;
+        received++;
+    }
+    skipped += irq_next_seq - next;
+
+    uint32_t produced = irq_next_seq;
+    uint32_t dropped = irq_queue.dropped();
+    bool ok = errors == 0 && received + dropped == produced && skipped == dropped &&
+              events == irq_count;
+    printf("interrupt: %u interrupts, %u items produced, %u received, %u dropped (%u skipped), "
+           "%llu events taken, %u errors\n",
+           irq_count, produced, received, dropped, skipped, (unsigned long long)events, errors);
+    return ok;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    uint32_t count = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000000;
+    uint32_t seconds = (argc > 2) ? strtoul(argv[2], NULL, 0) : 3;
+
+    bool threads_ok = run_threads(count);
+    bool interrupt_ok = run_interrupt(seconds);
+
+    printf("%s\n", (threads_ok && interrupt_ok) ? "PASS" : "FAIL");
+    return (threads_ok && interrupt_ok) ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+"""
+@file mem_budget.py
+@brief Per-symbol SRAM/flash report and budget check for a firmware image
+
+Prints the section totals of an ELF image (flash = text + data, SRAM =
+data + bss, the same sums PlatformIO shows), then the largest symbols in
+each, and fails if a total is over its budget.
+
+As a PlatformIO extra script (both platformio.ini files use it) it runs
+after every link, with the budgets taken from custom_ram_budget and
+custom_flash_budget, and adds a target that prints a longer list:
+
+    extra_scripts = post:../tools/mem_budget.py
+    pio run -t memreport
+
+From the command line:
+
+    python3 tools/mem_budget.py .pio/build/adafruit_feather_m0/firmware.elf \\
+        --ram 28672 --flash 245760 [--top 40] [--tool-prefix arm-none-eabi-]
+
+Exit status is 1 if a budget is exceeded.
+
+@author Rajiv Dewan, N2RD
+@date 2026
+"""
+
+import subprocess
+import sys
+
+# nm symbol types: where the symbol's bytes live
+RAM_TYPES = "bBdD"          # .data is copied from flash to SRAM at reset
+FLASH_TYPES = "tTrRdD"
+
+# Symbols listed per memory in the post-link report
+DEFAULT_TOP = 15
+
+
+def section_totals(size_tool, elf):
+    """Return (flash, ram) bytes from the Berkeley size output."""
+    out = subprocess.check_output([size_tool, "-B", elf], universal_newlines=True)
+    text, data, bss = (int(v) for v in out.splitlines()[1].split()[:3])
+    return text + data, data + bss
+
+
+def symbols(nm_tool, elf):
+    """Return (size, type, name) of every sized symbol, largest first."""
+    out = subprocess.check_output([nm_tool, "--print-size", "--size-sort", "-C", elf],
+                                  universal_newlines=True)
+    result = []
+    for line in out.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4:
+            result.append((int(fields[1], 16), fields[2], fields[3]))
+    result.sort(key=lambda s: s[0], reverse=True)
+    return result
+
+
+def report(elf, ram_budget, flash_budget, top, tool_prefix):
+    """Print the report; return False if a budget is exceeded."""
+    flash, ram = section_totals(tool_prefix + "size", elf)
+    syms = symbols(tool_prefix + "nm", elf)
+
+    ok = True
+    print("Memory budget: %s" % elf)
+    for label, used, budget in (("SRAM", ram, ram_budget), ("Flash", flash, flash_budget)):
+        if budget:
+            over = used > budget
+            ok = ok and not over
+            print("  %-5s %7d of %7d bytes (%5.1f%%)%s" %
+                  (label, used, budget, 100.0 * used / budget, "  OVER BUDGET" if over else ""))
+        else:
+            print("  %-5s %7d bytes (no budget)" % (label, used))
+
+    for label, types in (("SRAM", RAM_TYPES), ("Flash", FLASH_TYPES)):
+        print("  Largest %s symbols:" % label)
+        for size, kind, name in [s for s in syms if s[1] in types][:top]:
+            print("    %7d  %s  %s" % (size, kind, name))
+    return ok
+
+
+# ============================================================================
+# PLATFORMIO EXTRA SCRIPT
+# ============================================================================
+
+try:
+    Import("env")  # noqa: F821 - defined by SCons when run by PlatformIO
+except NameError:
+    env = None
+
+if env is not None:
+    def _option(name):
+        value = env.GetProjectOption(name, "")
+        return int(value, 0) if value else 0
+
+    def _run(top):
+        def action(target, source, env):
+            prefix = env.subst("$CC")[:-len("gcc")]
+            if not report(env.subst("$BUILD_DIR/${PROGNAME}.elf"), _option("custom_ram_budget"),
+                          _option("custom_flash_budget"), top, prefix):
+                print("Error: memory budget exceeded (see custom_*_budget in platformio.ini)")
+                return 1
+            return 0
+        return action
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _run(DEFAULT_TOP))
+    env.AddCustomTarget("memreport", "$BUILD_DIR/${PROGNAME}.elf", _run(60),
+                        title="Memory report", description="Per-symbol SRAM/flash use and budgets")
+
+# ============================================================================
+# COMMAND LINE
+# ============================================================================
+
+elif __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Per-symbol SRAM/flash report and budget check")
+    parser.add_argument("elf", help="Linked firmware image")
+    parser.add_argument("--ram", type=lambda v: int(v, 0), default=0, help="SRAM budget, bytes")
+    parser.add_argument("--flash", type=lambda v: int(v, 0), default=0, help="Flash budget, bytes")
+    parser.add_argument("--top", type=int, default=DEFAULT_TOP, help="Symbols listed per memory")
+    parser.add_argument("--tool-prefix", default="arm-none-eabi-",
+                        help="Binutils prefix ('' for the host tools)")
+    args = parser.parse_args()
+    sys.exit(0 if report(args.elf, args.ram, args.flash, args.top, args.tool_prefix) else 1)